@@ -286,7 +286,9 @@ enum EM
   // Vitesse IQ2000
   EM_IQ2000 = 0xfeba,
   // NIOS
-  EM_NIOS32 = 0xfebb
+  EM_NIOS32 = 0xfebb,
+  // Raisin64
+  EM_RAISIN64 = 0xcde8
   // Old AVR objects used 0x1057 (EM_AVR is correct).
   // Old MSP430 objects used 0x1059 (EM_MSP430 is correct).
   // Old FR30 objects used 0x3330 (EM_FR30 is correct).
@@ -358,6 +360,7 @@ enum SHT
   SHT_PREINIT_ARRAY = 16,
   SHT_GROUP = 17,
   SHT_SYMTAB_SHNDX = 18,
+  SHT_RELR = 19,
   SHT_LOOS = 0x60000000,
   SHT_HIOS = 0x6fffffff,
   SHT_LOPROC = 0x70000000,
@@ -370,6 +373,8 @@ enum SHT
   SHT_GNU_INCREMENTAL_SYMTAB = 0x6fff4701,
   SHT_GNU_INCREMENTAL_RELOCS = 0x6fff4702,
   SHT_GNU_INCREMENTAL_GOT_PLT = 0x6fff4703,
+  // Address-significance table, as emitted by LLVM.
+  SHT_LLVM_ADDRSIG = 0x6fff4c03,
   // Object attributes.
   SHT_GNU_ATTRIBUTES = 0x6ffffff5,
   // GNU style dynamic hash table.
@@ -721,6 +726,10 @@ enum DT
 
   DT_PREINIT_ARRAY = 32,
   DT_PREINIT_ARRAYSZ = 33,
+  DT_SYMTAB_SHNDX = 34,
+  DT_RELRSZ = 35,
+  DT_RELR = 36,
+  DT_RELRENT = 37,
   DT_LOOS = 0x6000000d,
   DT_HIOS = 0x6ffff000,
   DT_LOPROC = 0x70000000,
@@ -36,7 +36,9 @@
 #ifndef ELFCPP_SWAP_H
 #define ELFCPP_SWAP_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 // We need an autoconf-generated config.h file for endianness and
 // swapping.  We check two macros: WORDS_BIGENDIAN and
@@ -86,6 +88,13 @@ bswap_64(uint64_t v)
 #define bswap_64 __builtin_bswap64
 #endif
 
+// The array conversions below use the SSSE3 byte shuffle when the
+// compiler is targeting a processor that has it.
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
 namespace elfcpp
 {
 
@@ -263,6 +272,117 @@ struct Swap<8, big_endian>
   { *wv = v; }
 };
 
+// Convert_array_endian is a template based on size and on whether
+// the host and target have the same endianness.  It defines a
+// function convert_host which copies COUNT values of the given size
+// from FROM to TO, swapping each one if the host and target have
+// different endianness.  The buffers need not be aligned.  FROM and
+// TO may be the same buffer, to convert in place, but must not
+// otherwise overlap.
+
+template<int size, bool same_endian>
+struct Convert_array_endian
+{
+  static inline void
+  convert_host(unsigned char* to, const unsigned char* from, size_t count)
+  {
+    if (to != from)
+      memcpy(to, from, count * (size / 8));
+  }
+};
+
+template<>
+struct Convert_array_endian<8, false>
+{
+  static inline void
+  convert_host(unsigned char* to, const unsigned char* from, size_t count)
+  { Convert_array_endian<8, true>::convert_host(to, from, count); }
+};
+
+template<int size>
+struct Convert_array_endian<size, false>
+{
+  typedef typename Valtype_base<size>::Valtype Valtype;
+
+  static void
+  convert_host(unsigned char* to, const unsigned char* from, size_t count)
+  {
+    const size_t bytes = size / 8;
+    size_t i = 0;
+#ifdef __SSSE3__
+    // Reverse the bytes within each value, 16 bytes at a time.
+    const __m128i mask = shuffle_mask();
+    for (; i + 16 / bytes <= count; i += 16 / bytes)
+      {
+	__m128i v =
+	  _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i * bytes));
+	v = _mm_shuffle_epi8(v, mask);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(to + i * bytes), v);
+      }
+#endif
+    // Going through memcpy keeps this safe for unaligned buffers, and
+    // leaves the loop simple enough for the compiler to vectorize.
+    for (; i < count; ++i)
+      {
+	Valtype v;
+	memcpy(&v, from + i * bytes, bytes);
+	v = Convert_endian<size, false>::convert_host(v);
+	memcpy(to + i * bytes, &v, bytes);
+      }
+  }
+
+ private:
+#ifdef __SSSE3__
+  // Return the shuffle control which reverses the bytes of each
+  // value in a 16 byte vector.
+  static inline __m128i
+  shuffle_mask()
+  {
+    const int bytes = size / 8;
+    char m[16];
+    for (int i = 0; i < 16; ++i)
+      m[i] = (i - i % bytes) + (bytes - 1 - i % bytes);
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(m));
+  }
+#endif
+};
+
+// Swap_array is a template based on size and on whether the target is
+// big endian.  It is the array form of Swap: readvals and writevals
+// convert COUNT consecutive values between a buffer in target form
+// and an array in host form, and convert rewrites a buffer of values
+// written in host form into target form in place.  When the host and
+// target have the same endianness these are just copies.  Use these
+// rather than a loop over Swap when a whole array of values of one
+// size is read or written at once.
+
+template<int size, bool big_endian>
+struct Swap_array
+{
+  typedef typename Valtype_base<size>::Valtype Valtype;
+
+  static inline void
+  readvals(const unsigned char* from, Valtype* to, size_t count)
+  {
+    Convert_array_endian<size, big_endian == Endian::host_big_endian>
+      ::convert_host(reinterpret_cast<unsigned char*>(to), from, count);
+  }
+
+  static inline void
+  writevals(unsigned char* to, const Valtype* from, size_t count)
+  {
+    Convert_array_endian<size, big_endian == Endian::host_big_endian>
+      ::convert_host(to, reinterpret_cast<const unsigned char*>(from), count);
+  }
+
+  static inline void
+  convert(unsigned char* p, size_t count)
+  {
+    Convert_array_endian<size, big_endian == Endian::host_big_endian>
+      ::convert_host(p, p, count);
+  }
+};
+
 // Swap_unaligned is a template based on size and on whether the
 // target is big endian.  It defines the type Valtype and the
 // functions readval and writeval.  The functions read and write
@@ -0,0 +1,58 @@
+// raisin64.h -- ELF definitions specific to EM_RAISIN64  -*- C++ -*-
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of elfcpp.
+   
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Library General Public License
+// as published by the Free Software Foundation; either version 2, or
+// (at your option) any later version.
+
+// In addition to the permissions in the GNU Library General Public
+// License, the Free Software Foundation gives you unlimited
+// permission to link the compiled version of this file into
+// combinations with other programs, and to distribute those
+// combinations without any restriction coming from the use of this
+// file.  (The Library Public License restrictions do apply in other
+// respects; for example, they cover modification of the file, and
+/// distribution when not linked into a combined executable.)
+
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Library General Public License for more details.
+
+// You should have received a copy of the GNU Library General Public
+// License along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston, MA
+// 02110-1301, USA.
+
+#ifndef ELFCPP_RAISIN64_H
+#define ELFCPP_RAISIN64_H
+
+namespace elfcpp
+{
+
+// The relocation types.  All relocations are RELA.  Instructions are
+// big endian and are always at even addresses, so the branch and jump
+// targets are stored shifted right by one bit.
+
+// include/elf/raisin64.h gives PCREL32 the number 2 and PCREL12 the
+// number 3, but BFD indexes its howto table by relocation number and
+// the table lists PCREL12 second, so the assembler writes 3 for a
+// 32-bit branch and the BFD linker reads it back the same way.  We
+// use the numbers which appear in object files.
+
+enum
+{
+  R_RAISIN64_NONE = 0,		// No reloc
+  R_RAISIN64_56 = 1,		// Direct 56 bit, shifted right by one
+  R_RAISIN64_PCREL12 = 2,	// PC relative 12 bit, shifted right by one
+  R_RAISIN64_PCREL32 = 3,	// PC relative 32 bit, shifted right by one
+  R_RAISIN64_DATA32 = 4,	// Direct 32 bit
+};
+
+} // End namespace elfcpp.
+
+#endif // !defined(ELFCPP_RAISIN64_H)
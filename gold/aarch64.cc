@@ -409,6 +409,30 @@ public:
       }
     return false;
   }
+
+  // Return the index of the first of the COUNT insns at IP for which
+  // (INSN & MASK) == VALUE, or COUNT if there is none.  This is used to
+  // skip quickly over code which cannot start an erratum sequence.
+  // Insns are tested a block at a time, without an early exit from
+  // the inner loop, so that the compiler can vectorize the test.
+  static size_t
+  find_insn(const Insntype* ip, size_t count, Insntype mask, Insntype value)
+  {
+    const size_t block_size = 16;
+    size_t i = 0;
+    for (; i + block_size <= count; i += block_size)
+      {
+	unsigned int found = 0;
+	for (size_t j = 0; j < block_size; ++j)
+	  found |= (ip[i + j] & mask) == value;
+	if (found != 0)
+	  break;
+      }
+    for (; i < count; ++i)
+      if ((ip[i] & mask) == value)
+	return i;
+    return count;
+  }
 };  // End of "AArch64_insn_utilities".
 
 
@@ -1769,8 +1793,12 @@ class AArch64_relobj : public Sized_relobj_file<size, big_endian>
   AArch64_relobj(const std::string& name, Input_file* input_file, off_t offset,
 		 const typename elfcpp::Ehdr<size, big_endian>& ehdr)
     : Sized_relobj_file<size, big_endian>(name, input_file, offset, ehdr),
-      stub_tables_()
-  { }
+      stub_tables_(), errata_candidates_()
+  {
+    // The stubs and the TLS descriptor relocs use our local symbols
+    // when they are written.
+    this->set_has_late_references();
+  }
 
   ~AArch64_relobj()
   { }
@@ -1791,6 +1819,32 @@ class AArch64_relobj : public Sized_relobj_file<size, big_endian>
     this->stub_tables_[shndx] = stub_table;
   }
 
+  // An instance of erratum 843419 or 835769 in an input section.  This
+  // depends only on the section contents, so the instances are found
+  // once, when the relocations are read, and kept for all relaxation
+  // passes.  Whether an 843419 instance needs a stub also depends on
+  // the output address of its adrp insn, which is checked each pass.
+  struct Erratum_candidate
+  {
+    Erratum_candidate(int type, section_size_type start_offset,
+		      section_size_type insn_offset, uint32_t insn)
+      : type(type), start_offset(start_offset), insn_offset(insn_offset),
+	insn(insn)
+    { }
+
+    // ST_E_843419 or ST_E_835769.
+    int type;
+    // The offset of the first insn of the sequence: the adrp insn for
+    // 843419, the memory op for 835769.
+    section_size_type start_offset;
+    // The offset of the insn to be replaced by a branch to the stub.
+    section_size_type insn_offset;
+    // The insn at INSN_OFFSET.
+    uint32_t insn;
+  };
+
+  typedef std::vector<Erratum_candidate> Erratum_candidate_list;
+
   // Entrance to errata scanning.
   void
   scan_errata(unsigned int shndx,
@@ -1860,12 +1914,19 @@ class AArch64_relobj : public Sized_relobj_file<size, big_endian>
       const unsigned char* pshdrs, Output_file* of,
       typename Sized_relobj_file<size, big_endian>::Views* pviews);
 
-  // Count local symbols and (optionally) record mapping info.
+  // Read the relocations and, if fixing errata, find the erratum
+  // sequences in the executable sections.
   virtual void
-  do_count_local_symbols(Stringpool_template<char>*,
-			 Stringpool_template<char>*);
+  do_read_relocs(Read_relocs_data*);
 
  private:
+  // Read the mapping symbols into MAPPING_SYMBOL_INFO.
+  void
+  read_mapping_symbols(Mapping_symbol_info* mapping_symbol_info);
+
+  // Find the erratum sequences in all the executable sections.
+  void
+  find_errata();
   // Fix all errata in the object, and for each erratum, relocate corresponding
   // erratum stub.
   void
@@ -1888,25 +1949,38 @@ class AArch64_relobj : public Sized_relobj_file<size, big_endian>
   // List of stub tables.
   Stub_table_list stub_tables_;
 
-  // Mapping symbol information sorted by (section index, section_offset).
-  Mapping_symbol_info mapping_symbol_info_;
+  // The erratum sequences in each section, indexed by section index.
+  // This is empty until find_errata is called.
+  std::vector<Erratum_candidate_list> errata_candidates_;
 };  // End of AArch64_relobj
 
 
-// Override to record mapping symbol information.
+// Override to find the erratum sequences.  Read_relocs tasks for
+// different objects run in parallel, so this spreads the decoding of
+// the executable sections across threads, and does it only once
+// however many relaxation passes there are.
+
 template<int size, bool big_endian>
 void
-AArch64_relobj<size, big_endian>::do_count_local_symbols(
-    Stringpool_template<char>* pool, Stringpool_template<char>* dynpool)
+AArch64_relobj<size, big_endian>::do_read_relocs(Read_relocs_data* rd)
 {
-  Sized_relobj_file<size, big_endian>::do_count_local_symbols(pool, dynpool);
+  Sized_relobj_file<size, big_endian>::do_read_relocs(rd);
 
-  // Only erratum-fixing work needs mapping symbols, so skip this time consuming
-  // processing if not fixing erratum.
-  if (!parameters->options().fix_cortex_a53_843419()
-      && !parameters->options().fix_cortex_a53_835769())
-    return;
+  // We do not generate stubs if doing a relocatable link.
+  if (!parameters->options().relocatable()
+      && (parameters->options().fix_cortex_a53_843419()
+	  || parameters->options().fix_cortex_a53_835769()))
+    this->find_errata();
+}
 
+
+// Read the mapping symbols.  Only erratum-fixing work needs them.
+
+template<int size, bool big_endian>
+void
+AArch64_relobj<size, big_endian>::read_mapping_symbols(
+    Mapping_symbol_info* mapping_symbol_info)
+{
   const unsigned int loccount = this->local_symbol_count();
   if (loccount == 0)
     return;
@@ -1948,13 +2022,10 @@ AArch64_relobj<size, big_endian>::do_count_local_symbols(
 
   // Skip the first dummy symbol.
   psyms += sym_size;
-  typename Sized_relobj_file<size, big_endian>::Local_values*
-    plocal_values = this->local_values();
   for (unsigned int i = 1; i < loccount; ++i, psyms += sym_size)
     {
       elfcpp::Sym<size, big_endian> sym(psyms);
-      Symbol_value<size>& lv((*plocal_values)[i]);
-      AArch64_address input_value = lv.input_value();
+      AArch64_address input_value = sym.get_st_value();
 
       // Check to see if this is a mapping symbol. AArch64 mapping symbols are
       // defined in "ELF for the ARM 64-bit Architecture", Table 4-4, Mapping
@@ -1976,12 +2047,89 @@ AArch64_relobj<size, big_endian>::do_count_local_symbols(
 	  Mapping_symbol_position msp(input_shndx, input_value);
 	  // Insert mapping_symbol_info into map whose ordering is defined by
 	  // (shndx, offset_within_section).
-	  this->mapping_symbol_info_[msp] = sym_name[1];
+	  (*mapping_symbol_info)[msp] = sym_name[1];
 	}
    }
 }
 
 
+// Find the erratum sequences in the executable sections of this object
+// and record them in errata_candidates_.
+
+template<int size, bool big_endian>
+void
+AArch64_relobj<size, big_endian>::find_errata()
+{
+  unsigned int shnum = this->shnum();
+  this->errata_candidates_.resize(shnum);
+
+  Mapping_symbol_info mapping_symbol_info;
+  this->read_mapping_symbols(&mapping_symbol_info);
+  if (mapping_symbol_info.empty())
+    return;
+
+  The_target_aarch64* target = The_target_aarch64::current_target();
+  const Relobj::Output_sections& out_sections(this->output_sections());
+  const unsigned int shdr_size = elfcpp::Elf_sizes<size>::shdr_size;
+  const unsigned char* pshdrs = this->get_view(this->elf_file()->shoff(),
+					       shnum * shdr_size,
+					       true, true);
+  const unsigned char* ps = pshdrs + shdr_size;
+  for (unsigned int shndx = 1; shndx < shnum; ++shndx, ps += shdr_size)
+    {
+      const elfcpp::Shdr<size, big_endian> shdr(ps);
+      if (shdr.get_sh_size() == 0
+	  || (shdr.get_sh_flags() &
+	      (elfcpp::SHF_ALLOC | elfcpp::SHF_EXECINSTR)) == 0
+	  || shdr.get_sh_type() != elfcpp::SHT_PROGBITS)
+	continue;
+
+      // With --gc-sections the output sections are not known yet, so
+      // we have to look at every section.
+      if (out_sections[shndx] == NULL
+	  && !parameters->options().gc_sections())
+	continue;
+
+      section_size_type input_view_size = 0;
+      const unsigned char* input_view =
+	this->section_contents(shndx, &input_view_size, false);
+      Erratum_candidate_list* candidates = &this->errata_candidates_[shndx];
+
+      Mapping_symbol_position section_start(shndx, 0);
+      // Find the first mapping symbol record within section shndx.
+      typename Mapping_symbol_info::const_iterator p =
+	mapping_symbol_info.lower_bound(section_start);
+      while (p != mapping_symbol_info.end() && p->first.shndx_ == shndx)
+	{
+	  typename Mapping_symbol_info::const_iterator prev = p;
+	  ++p;
+	  if (prev->second != 'x')
+	    continue;
+
+	  section_size_type span_start =
+	    convert_to_section_size_type(prev->first.offset_);
+	  section_size_type span_end;
+	  if (p != mapping_symbol_info.end() && p->first.shndx_ == shndx)
+	    span_end = convert_to_section_size_type(p->first.offset_);
+	  else
+	    span_end = convert_to_section_size_type(shdr.get_sh_size());
+	  if (span_end > input_view_size)
+	    span_end = input_view_size;
+	  if (span_start >= span_end)
+	    continue;
+
+	  if (parameters->options().fix_cortex_a53_843419())
+	    target->scan_erratum_843419_span(span_start, span_end, input_view,
+					     candidates);
+
+	  if (parameters->options().fix_cortex_a53_835769())
+	    target->scan_erratum_835769_span(span_start, span_end, input_view,
+					     candidates);
+	}
+    }
+}
+
+
 // Fix all errata in the object and for each erratum, we relocate the
 // corresponding erratum stub (by calling Stub_table::relocate_erratum_stub).
 
@@ -2329,45 +2477,13 @@ AArch64_relobj<size, big_endian>::scan_errata(
           (*p)->update_erratum_address(output_address);
     }
 
-  section_size_type input_view_size = 0;
-  const unsigned char* input_view =
-    this->section_contents(shndx, &input_view_size, false);
+  // The erratum sequences are normally found when the relocations are
+  // read, but make sure that we have them.
+  if (this->errata_candidates_.empty())
+    this->find_errata();
 
-  Mapping_symbol_position section_start(shndx, 0);
-  // Find the first mapping symbol record within section shndx.
-  typename Mapping_symbol_info::const_iterator p =
-    this->mapping_symbol_info_.lower_bound(section_start);
-  while (p != this->mapping_symbol_info_.end() &&
-	 p->first.shndx_ == shndx)
-    {
-      typename Mapping_symbol_info::const_iterator prev = p;
-      ++p;
-      if (prev->second == 'x')
-	{
-	  section_size_type span_start =
-	    convert_to_section_size_type(prev->first.offset_);
-	  section_size_type span_end;
-	  if (p != this->mapping_symbol_info_.end()
-	      && p->first.shndx_ == shndx)
-	    span_end = convert_to_section_size_type(p->first.offset_);
-	  else
-	    span_end = convert_to_section_size_type(shdr.get_sh_size());
-
-	  // Here we do not share the scanning code of both errata. For 843419,
-	  // only the last few insns of each page are examined, which is fast,
-	  // whereas, for 835769, every insn pair needs to be checked.
-
-	  if (parameters->options().fix_cortex_a53_843419())
-	    target->scan_erratum_843419_span(
-	      this, shndx, span_start, span_end,
-	      const_cast<unsigned char*>(input_view), output_address);
-
-	  if (parameters->options().fix_cortex_a53_835769())
-	    target->scan_erratum_835769_span(
-	      this, shndx, span_start, span_end,
-	      const_cast<unsigned char*>(input_view), output_address);
-	}
-    }
+  target->create_erratum_stubs(this, shndx, this->errata_candidates_[shndx],
+			       output_address);
 }
 
 
@@ -3120,24 +3236,32 @@ class Target_aarch64 : public Sized_target<size, big_endian>
   }
 
 
+  typedef typename AArch64_relobj<size, big_endian>::Erratum_candidate_list
+    Erratum_candidate_list;
+
   // Scan erratum 843419 for a part of a section.
   void
   scan_erratum_843419_span(
-    AArch64_relobj<size, big_endian>*,
-    unsigned int,
     const section_size_type,
     const section_size_type,
-    unsigned char*,
-    Address);
+    const unsigned char*,
+    Erratum_candidate_list*);
 
   // Scan erratum 835769 for a part of a section.
   void
   scan_erratum_835769_span(
-    AArch64_relobj<size, big_endian>*,
-    unsigned int,
     const section_size_type,
     const section_size_type,
-    unsigned char*,
+    const unsigned char*,
+    Erratum_candidate_list*);
+
+  // Create the erratum stubs for the erratum sequences found in a
+  // section at a given output address.
+  void
+  create_erratum_stubs(
+    AArch64_relobj<size, big_endian>*,
+    unsigned int,
+    const Erratum_candidate_list&,
     Address);
 
  protected:
@@ -3764,6 +3888,10 @@ Target_aarch64<size, big_endian>::rela_dyn_section(Layout* layout)
       layout->add_output_section_data(".rela.dyn", elfcpp::SHT_RELA,
 				      elfcpp::SHF_ALLOC, this->rela_dyn_,
 				      ORDER_DYNAMIC_RELOCS, false);
+      if (size == 64
+	  && strcmp(parameters->options().pack_dyn_relocs(), "relr") == 0)
+	this->rela_dyn_->set_relr(new Output_data_relr<size, big_endian>(layout),
+				  elfcpp::R_AARCH64_RELATIVE);
     }
   return this->rela_dyn_;
 }
@@ -6946,6 +7074,11 @@ Target_aarch64<size, big_endian>::do_finalize_sections(
   if (this->copy_relocs_.any_saved_relocs())
     this->copy_relocs_.emit(this->rela_dyn_section(layout));
 
+  // All dynamic relocs are known now, so we can tell whether any
+  // were packed.
+  if (this->rela_dyn_ != NULL)
+    layout->add_relr_dynamic_tags(this->rela_dyn_->relr());
+
   // Fill in some more dynamic tags.
   Output_data_dynamic* const odyn = layout->dynamic_data();
   if (odyn != NULL)
@@ -8403,152 +8536,162 @@ Target_aarch64<size, big_endian>::create_erratum_stub(
 }
 
 
-// Scan erratum for section SHNDX range [output_address + span_start,
-// output_address + span_end). Note here we do not share the code with
-// scan_erratum_843419_span function, because for 843419 we optimize by only
-// scanning the last few insns of a page, whereas for 835769, we need to scan
-// every insn.
+// Scan erratum 835769 for section range [span_start, span_end) and add
+// the sequences found to CANDIDATES.  Unlike 843419, every insn pair
+// has to be checked, so we use find_insn to skip quickly to the next
+// multiply-accumulate insn, which must end any sequence.
 
 template<int size, bool big_endian>
 void
 Target_aarch64<size, big_endian>::scan_erratum_835769_span(
-    AArch64_relobj<size, big_endian>*  relobj,
-    unsigned int shndx,
     const section_size_type span_start,
     const section_size_type span_end,
-    unsigned char* input_view,
-    Address output_address)
+    const unsigned char* input_view,
+    Erratum_candidate_list* candidates)
 {
   typedef typename Insn_utilities::Insntype Insntype;
+  typedef typename AArch64_relobj<size, big_endian>::Erratum_candidate
+    Erratum_candidate;
 
   const int BPI = AArch64_insn_utilities<big_endian>::BYTES_PER_INSN;
 
-  // Adjust output_address and view to the start of span.
-  output_address += span_start;
-  input_view += span_start;
-
-  section_size_type span_length = span_end - span_start;
-  section_size_type offset = 0;
-  for (offset = 0; offset + BPI < span_length; offset += BPI)
+  const Insntype* ip =
+    reinterpret_cast<const Insntype*>(input_view + span_start);
+  size_t insn_count = (span_end - span_start) / BPI;
+  size_t i = 0;
+  while (i + 1 < insn_count)
     {
-      Insntype* ip = reinterpret_cast<Insntype*>(input_view + offset);
-      Insntype insn1 = ip[0];
-      Insntype insn2 = ip[1];
-      if (is_erratum_835769_sequence(insn1, insn2))
+      // The mask and value are those tested by aarch64_mac.
+      i += Insn_utilities::find_insn(ip + i + 1, insn_count - i - 1,
+				     0xff000000, 0x9b000000);
+      if (i + 1 >= insn_count)
+	break;
+      if (is_erratum_835769_sequence(ip[i], ip[i + 1]))
 	{
-	  Insntype erratum_insn = insn2;
-	  // "span_start + offset" is the offset for insn1. So for insn2, it is
-	  // "span_start + offset + BPI".
-	  section_size_type erratum_insn_offset = span_start + offset + BPI;
-	  Address erratum_address = output_address + offset + BPI;
-	  gold_info(_("Erratum 835769 found and fixed at \"%s\", "
-			 "section %d, offset 0x%08x."),
-		       relobj->name().c_str(), shndx,
-		       (unsigned int)(span_start + offset));
-
-	  this->create_erratum_stub(relobj, shndx,
-				    erratum_insn_offset, erratum_address,
-				    erratum_insn, ST_E_835769);
-	  offset += BPI;  // Skip mac insn.
+	  // "span_start + i * BPI" is the offset for insn1. So for insn2, it
+	  // is "span_start + i * BPI + BPI".
+	  section_size_type offset = span_start + i * BPI;
+	  candidates->push_back(Erratum_candidate(ST_E_835769, offset,
+						  offset + BPI, ip[i + 1]));
+	  i += 2;  // Skip mac insn.
 	}
+      else
+	++i;
     }
 }  // End of "Target_aarch64::scan_erratum_835769_span".
 
 
-// Scan erratum for section SHNDX range
-// [output_address + span_start, output_address + span_end).
+// Scan erratum 843419 for section range [span_start, span_end) and add
+// the sequences found to CANDIDATES.  A sequence only needs a stub if
+// its adrp insn ends up at a page offset of 0xff8 or 0xffc, but that
+// depends on the output address, so here we record every sequence and
+// leave the check to create_erratum_stubs.
 
 template<int size, bool big_endian>
 void
 Target_aarch64<size, big_endian>::scan_erratum_843419_span(
-    AArch64_relobj<size, big_endian>*  relobj,
-    unsigned int shndx,
     const section_size_type span_start,
     const section_size_type span_end,
-    unsigned char* input_view,
-    Address output_address)
+    const unsigned char* input_view,
+    Erratum_candidate_list* candidates)
 {
   typedef typename Insn_utilities::Insntype Insntype;
+  typedef typename AArch64_relobj<size, big_endian>::Erratum_candidate
+    Erratum_candidate;
 
-  // Adjust output_address and view to the start of span.
-  output_address += span_start;
-  input_view += span_start;
+  const int BPI = Insn_utilities::BYTES_PER_INSN;
 
-  if ((output_address & 0x03) != 0)
+  const Insntype* ip =
+    reinterpret_cast<const Insntype*>(input_view + span_start);
+  size_t insn_count = (span_end - span_start) / BPI;
+  if (insn_count < 3)
     return;
-
-  section_size_type offset = 0;
-  section_size_type span_length = span_end - span_start;
-  // The first instruction must be ending at 0xFF8 or 0xFFC.
-  unsigned int page_offset = output_address & 0xFFF;
-  // Make sure starting position, that is "output_address+offset",
-  // starts at page position 0xff8 or 0xffc.
-  if (page_offset < 0xff8)
-    offset = 0xff8 - page_offset;
-  while (offset + 3 * Insn_utilities::BYTES_PER_INSN <= span_length)
+  // A sequence is at least 3 insns long.
+  size_t start_count = insn_count - 2;
+  size_t i = 0;
+  while (i < start_count)
     {
-      Insntype* ip = reinterpret_cast<Insntype*>(input_view + offset);
-      Insntype insn1 = ip[0];
-      if (Insn_utilities::is_adrp(insn1))
-	{
-	  Insntype insn2 = ip[1];
-	  Insntype insn3 = ip[2];
-	  Insntype erratum_insn;
-	  unsigned insn_offset;
-	  bool do_report = false;
-	  if (is_erratum_843419_sequence(insn1, insn2, insn3))
-	    {
-	      do_report = true;
-	      erratum_insn = insn3;
-	      insn_offset = 2 * Insn_utilities::BYTES_PER_INSN;
-	    }
-	  else if (offset + 4 * Insn_utilities::BYTES_PER_INSN <= span_length)
-	    {
-	      // Optionally we can have an insn between ins2 and ins3
-	      Insntype insn_opt = ip[2];
-	      // And insn_opt must not be a branch.
-	      if (!Insn_utilities::aarch64_b(insn_opt)
-		  && !Insn_utilities::aarch64_bl(insn_opt)
-		  && !Insn_utilities::aarch64_blr(insn_opt)
-		  && !Insn_utilities::aarch64_br(insn_opt))
-		{
-		  // And insn_opt must not write to dest reg in insn1. However
-		  // we do a conservative scan, which means we may fix/report
-		  // more than necessary, but it doesn't hurt.
+      // The mask and value are those tested by is_adrp.
+      i += Insn_utilities::find_insn(ip + i, start_count - i,
+				     0x9f000000, 0x90000000);
+      if (i >= start_count)
+	break;
 
-		  Insntype insn4 = ip[3];
-		  if (is_erratum_843419_sequence(insn1, insn2, insn4))
-		    {
-		      do_report = true;
-		      erratum_insn = insn4;
-		      insn_offset = 3 * Insn_utilities::BYTES_PER_INSN;
-		    }
-		}
-	    }
-	  if (do_report)
+      Insntype insn1 = ip[i];
+      Insntype insn2 = ip[i + 1];
+      Insntype insn3 = ip[i + 2];
+      section_size_type offset = span_start + i * BPI;
+      if (is_erratum_843419_sequence(insn1, insn2, insn3))
+	candidates->push_back(Erratum_candidate(ST_E_843419, offset,
+						offset + 2 * BPI, insn3));
+      else if (i + 4 <= insn_count)
+	{
+	  // Optionally we can have an insn between ins2 and ins3
+	  Insntype insn_opt = ip[i + 2];
+	  // And insn_opt must not be a branch.
+	  if (!Insn_utilities::aarch64_b(insn_opt)
+	      && !Insn_utilities::aarch64_bl(insn_opt)
+	      && !Insn_utilities::aarch64_blr(insn_opt)
+	      && !Insn_utilities::aarch64_br(insn_opt))
 	    {
-	      unsigned int erratum_insn_offset =
-		span_start + offset + insn_offset;
-	      Address erratum_address =
-		output_address + offset + insn_offset;
-	      create_erratum_stub(relobj, shndx,
-				  erratum_insn_offset, erratum_address,
-				  erratum_insn, ST_E_843419,
-				  span_start + offset);
+	      // And insn_opt must not write to dest reg in insn1. However
+	      // we do a conservative scan, which means we may fix/report
+	      // more than necessary, but it doesn't hurt.
+
+	      Insntype insn4 = ip[i + 3];
+	      if (is_erratum_843419_sequence(insn1, insn2, insn4))
+		candidates->push_back(Erratum_candidate(ST_E_843419, offset,
+							offset + 3 * BPI,
+							insn4));
 	    }
 	}
-
-      // Advance to next candidate instruction. We only consider instruction
-      // sequences starting at a page offset of 0xff8 or 0xffc.
-      page_offset = (output_address + offset) & 0xfff;
-      if (page_offset == 0xff8)
-	offset += 4;
-      else  // (page_offset == 0xffc), we move to next page's 0xff8.
-	offset += 0xffc;
+      ++i;
     }
 }  // End of "Target_aarch64::scan_erratum_843419_span".
 
 
+// Create the erratum stubs for the sequences CANDIDATES in section SHNDX
+// of RELOBJ, whose output address is OUTPUT_ADDRESS.
+
+template<int size, bool big_endian>
+void
+Target_aarch64<size, big_endian>::create_erratum_stubs(
+    AArch64_relobj<size, big_endian>* relobj,
+    unsigned int shndx,
+    const Erratum_candidate_list& candidates,
+    Address output_address)
+{
+  for (typename Erratum_candidate_list::const_iterator p = candidates.begin();
+       p != candidates.end();
+       ++p)
+    {
+      Address erratum_address = output_address + p->insn_offset;
+      if (p->type == ST_E_843419)
+	{
+	  // The first instruction must be at page offset 0xff8 or 0xffc.
+	  Address adrp_address = output_address + p->start_offset;
+	  if ((adrp_address & 0x03) != 0)
+	    continue;
+	  unsigned int page_offset = adrp_address & 0xfff;
+	  if (page_offset != 0xff8 && page_offset != 0xffc)
+	    continue;
+	  this->create_erratum_stub(relobj, shndx, p->insn_offset,
+				    erratum_address, p->insn, ST_E_843419,
+				    p->start_offset);
+	}
+      else
+	{
+	  gold_info(_("Erratum 835769 found and fixed at \"%s\", "
+		      "section %d, offset 0x%08x."),
+		    relobj->name().c_str(), shndx,
+		    (unsigned int)(p->start_offset));
+	  this->create_erratum_stub(relobj, shndx, p->insn_offset,
+				    erratum_address, p->insn, ST_E_835769);
+	}
+    }
+}
+
+
 // The selector for aarch64 object files.
 
 template<int size, bool big_endian>
@@ -1496,10 +1496,14 @@ class Arm_relobj : public Sized_relobj_file<32, big_endian>
     : Sized_relobj_file<32, big_endian>(name, input_file, offset, ehdr),
       stub_tables_(), local_symbol_is_thumb_function_(),
       attributes_section_data_(NULL), mapping_symbols_info_(),
-      section_has_cortex_a8_workaround_(NULL), exidx_section_map_(),
-      output_local_symbol_count_needs_update_(false),
+      section_has_cortex_a8_workaround_(NULL), cortex_a8_branches_(),
+      exidx_section_map_(), output_local_symbol_count_needs_update_(false),
       merge_flags_and_attributes_(true)
-  { }
+  {
+    // Stubs and the exception index fixups look at our local symbols
+    // and sections after we have been relocated.
+    this->set_has_late_references();
+  }
 
   ~Arm_relobj()
   { delete this->attributes_section_data_; }
@@ -1582,6 +1586,24 @@ class Arm_relobj : public Sized_relobj_file<32, big_endian>
   typedef std::map<Mapping_symbol_position, char,
 		   Mapping_symbol_position_less> Mapping_symbols_info;
 
+  // A 32-bit THUMB branch which follows a 32-bit non-branch instruction,
+  // and so needs the Cortex-A8 workaround if it straddles two 4K pages.
+  // This depends only on the section contents, so the branches are
+  // found once and kept for all relaxation passes.
+  struct Cortex_a8_branch
+  {
+    Cortex_a8_branch(section_size_type offset, uint32_t insn)
+      : offset(offset), insn(insn)
+    { }
+
+    // The offset of the branch in its section.
+    section_size_type offset;
+    // The branch instruction, in manual-friendly order.
+    uint32_t insn;
+  };
+
+  typedef std::vector<Cortex_a8_branch> Cortex_a8_branch_list;
+
   // Whether a section contains any Cortex-A8 workaround.
   bool
   section_has_cortex_a8_workaround(unsigned int shndx) const
@@ -1715,6 +1737,13 @@ class Arm_relobj : public Sized_relobj_file<32, big_endian>
 				     unsigned int, Output_section*,
 				     Target_arm<big_endian>*);
 
+  // Find the branches in a section which may need the Cortex-A8
+  // workaround.
+  void
+  find_cortex_a8_branches(const elfcpp::Shdr<32, big_endian>&,
+			  unsigned int, Target_arm<big_endian>*,
+			  Cortex_a8_branch_list*);
+
   // Find the linked text section of an EXIDX section by looking at the
   // first relocation of the EXIDX section.  PSHDR points to the section
   // headers of a relocation section and PSYMS points to the local symbols.
@@ -1742,6 +1771,8 @@ class Arm_relobj : public Sized_relobj_file<32, big_endian>
   typedef std::vector<Stub_table<big_endian>*> Stub_table_list;
   typedef Unordered_map<unsigned int, const Arm_exidx_input_section*>
     Exidx_section_map;
+  typedef Unordered_map<unsigned int, Cortex_a8_branch_list>
+    Cortex_a8_branch_map;
 
   // List of stub tables.
   Stub_table_list stub_tables_;
@@ -1756,6 +1787,9 @@ class Arm_relobj : public Sized_relobj_file<32, big_endian>
   Mapping_symbols_info mapping_symbols_info_;
   // Bitmap to indicate sections with Cortex-A8 workaround or NULL.
   std::vector<bool>* section_has_cortex_a8_workaround_;
+  // Map a scanned text section to the branches in it which may need the
+  // Cortex-A8 workaround.
+  Cortex_a8_branch_map cortex_a8_branches_;
   // Map a text section to its associated .ARM.exidx section, if there is one.
   Exidx_section_map exidx_section_map_;
   // Whether output local symbol count needs updating.
@@ -2470,11 +2504,37 @@ class Target_arm : public Sized_target<32, big_endian>
   fix_v4bx() const
   { return parameters->options().fix_v4bx(); }
 
-  // Scan a span of THUMB code section for Cortex-A8 erratum.
+  // Scan a span of THUMB code section for branches which may need the
+  // Cortex-A8 workaround.
+  void
+  scan_span_for_cortex_a8_erratum(
+      section_size_type, section_size_type, const unsigned char*,
+      typename Arm_relobj<big_endian>::Cortex_a8_branch_list*);
+
+  // Make a Cortex-A8 stub for a branch at an address in the last
+  // halfword of a 4K page if the workaround is needed.
   void
-  scan_span_for_cortex_a8_erratum(Arm_relobj<big_endian>*, unsigned int,
-				  section_size_type, section_size_type,
-				  const unsigned char*, Arm_address);
+  scan_cortex_a8_branch(Arm_relobj<big_endian>*, unsigned int, uint32_t,
+			Arm_address);
+
+  // Return whether the 32-bit THUMB instruction INSN, in manual-friendly
+  // order, is a branch affected by the Cortex-A8 erratum, and set the
+  // flags to say which kind.
+  static bool
+  is_cortex_a8_branch(uint32_t insn, bool* is_b, bool* is_bl, bool* is_blx,
+		      bool* is_bcc)
+  {
+    // Encoding T4: B<c>.W.
+    *is_b = (insn & 0xf800d000U) == 0xf0009000U;
+    // Encoding T1: BL<c>.W.
+    *is_bl = (insn & 0xf800d000U) == 0xf000d000U;
+    // Encoding T2: BLX<c>.W.
+    *is_blx = (insn & 0xf800d000U) == 0xf000c000U;
+    // Encoding T3: B<c>.W (not permitted in IT block).
+    *is_bcc = ((insn & 0xf800d000U) == 0xf0008000U
+	       && (insn & 0x07f00000U) != 0x03800000U);
+    return *is_b || *is_bl || *is_blx || *is_bcc;
+  }
 
   // Apply Cortex-A8 workaround to a branch.
   void
@@ -6332,6 +6392,45 @@ Arm_relobj<big_endian>::scan_section_for_cortex_a8_erratum(
     unsigned int shndx,
     Output_section* os,
     Target_arm<big_endian>* arm_target)
+{
+  // Decoding the THUMB code is the expensive part, and the branches
+  // found do not depend on the output address, so only do it the first
+  // time that we scan this section.
+  typename Cortex_a8_branch_map::iterator pb =
+    this->cortex_a8_branches_.find(shndx);
+  if (pb == this->cortex_a8_branches_.end())
+    {
+      pb = this->cortex_a8_branches_.insert(
+	  std::make_pair(shndx, Cortex_a8_branch_list())).first;
+      this->find_cortex_a8_branches(shdr, shndx, arm_target, &pb->second);
+    }
+
+  if (pb->second.empty())
+    return;
+
+  Arm_address output_address =
+    this->simple_input_section_output_address(shndx, os);
+
+  // Only a branch starting in the last halfword of a 4K page needs the
+  // workaround.
+  for (typename Cortex_a8_branch_list::const_iterator p = pb->second.begin();
+       p != pb->second.end();
+       ++p)
+    if (((output_address + p->offset) & 0xfffU) == 0xffeU)
+      arm_target->scan_cortex_a8_branch(this, shndx, p->insn,
+					output_address + p->offset);
+}
+
+// Find the branches in a section which may need the Cortex-A8 workaround
+// and add them to BRANCHES.
+
+template<bool big_endian>
+void
+Arm_relobj<big_endian>::find_cortex_a8_branches(
+    const elfcpp::Shdr<32, big_endian>& shdr,
+    unsigned int shndx,
+    Target_arm<big_endian>* arm_target,
+    Cortex_a8_branch_list* branches)
 {
   // Look for the first mapping symbol in this section.  It should be
   // at (shndx, 0).
@@ -6344,18 +6443,13 @@ Arm_relobj<big_endian>::scan_section_for_cortex_a8_erratum(
   if (p == this->mapping_symbols_info_.end() || p->first.first != shndx)
     return;
 
-  Arm_address output_address =
-    this->simple_input_section_output_address(shndx, os);
-
   // Get the section contents.
   section_size_type input_view_size = 0;
   const unsigned char* input_view =
     this->section_contents(shndx, &input_view_size, false);
 
   // We need to go through the mapping symbols to determine what to
-  // scan.  There are two reasons.  First, we should look at THUMB code and
-  // THUMB code only.  Second, we only want to look at the 4K-page boundary
-  // to speed up the scanning.
+  // scan, since we should look at THUMB code and THUMB code only.
 
   while (p != this->mapping_symbols_info_.end()
 	&& p->first.first == shndx)
@@ -6376,14 +6470,8 @@ Arm_relobj<big_endian>::scan_section_for_cortex_a8_erratum(
 	  else
 	    span_end = convert_to_section_size_type(shdr.get_sh_size());
 
-	  if (((span_start + output_address) & ~0xfffUL)
-	      != ((span_end + output_address - 1) & ~0xfffUL))
-	    {
-	      arm_target->scan_span_for_cortex_a8_erratum(this, shndx,
-							  span_start, span_end,
-							  input_view,
-							  output_address);
-	    }
+	  arm_target->scan_span_for_cortex_a8_erratum(span_start, span_end,
+						      input_view, branches);
 	}
 
       p = next;
@@ -12645,18 +12733,21 @@ Target_arm<big_endian>::do_attributes_order(int num) const
   return num;
 }
 
-// Scan a span of THUMB code for Cortex-A8 erratum.
+// Scan a span of THUMB code for Cortex-A8 erratum.  Record the 32-bit
+// branches which follow a 32-bit non-branch instruction in BRANCHES.
+// Whether they straddle two 4K pages depends on the output address, and
+// is checked by the caller.
 
 template<bool big_endian>
 void
 Target_arm<big_endian>::scan_span_for_cortex_a8_erratum(
-    Arm_relobj<big_endian>* arm_relobj,
-    unsigned int shndx,
     section_size_type span_start,
     section_size_type span_end,
     const unsigned char* view,
-    Arm_address address)
+    typename Arm_relobj<big_endian>::Cortex_a8_branch_list* branches)
 {
+  typedef typename Arm_relobj<big_endian>::Cortex_a8_branch Cortex_a8_branch;
+
   // Scan for 32-bit Thumb-2 branches which span two 4K regions, where:
   //
   // The opcode is BLX.W, BL.W, B.W, Bcc.W
@@ -12672,146 +12763,149 @@ Target_arm<big_endian>::scan_span_for_cortex_a8_erratum(
       typedef typename elfcpp::Swap<16, big_endian>::Valtype Valtype;
       const Valtype* wv = reinterpret_cast<const Valtype*>(view + i);
       uint32_t insn = elfcpp::Swap<16, big_endian>::readval(wv);
-      bool is_blx = false, is_b = false;
-      bool is_bl = false, is_bcc = false;
+      bool is_32bit_branch = false;
 
       bool insn_32bit = (insn & 0xe000) == 0xe000 && (insn & 0x1800) != 0x0000;
       if (insn_32bit)
 	{
 	  // Load the rest of the insn (in manual-friendly order).
 	  insn = (insn << 16) | elfcpp::Swap<16, big_endian>::readval(wv + 1);
-
-	  // Encoding T4: B<c>.W.
-	  is_b = (insn & 0xf800d000U) == 0xf0009000U;
-	  // Encoding T1: BL<c>.W.
-	  is_bl = (insn & 0xf800d000U) == 0xf000d000U;
-	  // Encoding T2: BLX<c>.W.
-	  is_blx = (insn & 0xf800d000U) == 0xf000c000U;
-	  // Encoding T3: B<c>.W (not permitted in IT block).
-	  is_bcc = ((insn & 0xf800d000U) == 0xf0008000U
-		    && (insn & 0x07f00000U) != 0x03800000U);
+	  bool is_b, is_bl, is_blx, is_bcc;
+	  is_32bit_branch = is_cortex_a8_branch(insn, &is_b, &is_bl, &is_blx,
+						&is_bcc);
 	}
 
-      bool is_32bit_branch = is_b || is_bl || is_blx || is_bcc;
+      // If this instruction is a 32-bit THUMB branch and it follows
+      // 32-bit non-branch instruction, we may need to work around if it
+      // crosses a 4K page boundary.
+      if (is_32bit_branch && last_was_32bit && !last_was_branch)
+	branches->push_back(Cortex_a8_branch(i, insn));
 
-      // If this instruction is a 32-bit THUMB branch that crosses a 4K
-      // page boundary and it follows 32-bit non-branch instruction,
-      // we need to work around.
-      if (is_32bit_branch
-	  && ((address + i) & 0xfffU) == 0xffeU
-	  && last_was_32bit
-	  && !last_was_branch)
-	{
-	  // Check to see if there is a relocation stub for this branch.
-	  bool force_target_arm = false;
-	  bool force_target_thumb = false;
-	  const Cortex_a8_reloc* cortex_a8_reloc = NULL;
-	  Cortex_a8_relocs_info::const_iterator p =
-	    this->cortex_a8_relocs_info_.find(address + i);
-
-	  if (p != this->cortex_a8_relocs_info_.end())
-	    {
-	      cortex_a8_reloc = p->second;
-	      bool target_is_thumb = (cortex_a8_reloc->destination() & 1) != 0;
-
-	      if (cortex_a8_reloc->r_type() == elfcpp::R_ARM_THM_CALL
-		  && !target_is_thumb)
-		force_target_arm = true;
-	      else if (cortex_a8_reloc->r_type() == elfcpp::R_ARM_THM_CALL
-		       && target_is_thumb)
-		force_target_thumb = true;
-	    }
+      i += insn_32bit ? 4 : 2;
+      last_was_32bit = insn_32bit;
+      last_was_branch = is_32bit_branch;
+    }
+}
 
-	  off_t offset;
-	  Stub_type stub_type = arm_stub_none;
-
-	  // Check if we have an offending branch instruction.
-	  uint16_t upper_insn = (insn >> 16) & 0xffffU;
-	  uint16_t lower_insn = insn & 0xffffU;
-	  typedef class Arm_relocate_functions<big_endian> RelocFuncs;
-
-	  if (cortex_a8_reloc != NULL
-	      && cortex_a8_reloc->reloc_stub() != NULL)
-	    // We've already made a stub for this instruction, e.g.
-	    // it's a long branch or a Thumb->ARM stub.  Assume that
-	    // stub will suffice to work around the A8 erratum (see
-	    // setting of always_after_branch above).
-	    ;
-	  else if (is_bcc)
-	    {
-	      offset = RelocFuncs::thumb32_cond_branch_offset(upper_insn,
-							      lower_insn);
-	      stub_type = arm_stub_a8_veneer_b_cond;
-	    }
-	  else if (is_b || is_bl || is_blx)
-	    {
-	      offset = RelocFuncs::thumb32_branch_offset(upper_insn,
-							 lower_insn);
-	      if (is_blx)
-		offset &= ~3;
-
-	      stub_type = (is_blx
-			   ? arm_stub_a8_veneer_blx
-			   : (is_bl
-			      ? arm_stub_a8_veneer_bl
-			      : arm_stub_a8_veneer_b));
-	    }
+// Check a 32-bit THUMB branch INSN at ADDRESS, which follows a 32-bit
+// non-branch instruction and starts in the last halfword of a 4K page,
+// and make a Cortex-A8 stub for it if its target is in the same page.
 
-	  if (stub_type != arm_stub_none)
-	    {
-	      Arm_address pc_for_insn = address + i + 4;
-
-	      // The original instruction is a BL, but the target is
-	      // an ARM instruction.  If we were not making a stub,
-	      // the BL would have been converted to a BLX.  Use the
-	      // BLX stub instead in that case.
-	      if (this->may_use_v5t_interworking() && force_target_arm
-		  && stub_type == arm_stub_a8_veneer_bl)
-		{
-		  stub_type = arm_stub_a8_veneer_blx;
-		  is_blx = true;
-		  is_bl = false;
-		}
-	      // Conversely, if the original instruction was
-	      // BLX but the target is Thumb mode, use the BL stub.
-	      else if (force_target_thumb
-		       && stub_type == arm_stub_a8_veneer_blx)
-		{
-		  stub_type = arm_stub_a8_veneer_bl;
-		  is_blx = false;
-		  is_bl = true;
-		}
+template<bool big_endian>
+void
+Target_arm<big_endian>::scan_cortex_a8_branch(
+    Arm_relobj<big_endian>* arm_relobj,
+    unsigned int shndx,
+    uint32_t insn,
+    Arm_address address)
+{
+  bool is_blx, is_b, is_bl, is_bcc;
+  is_cortex_a8_branch(insn, &is_b, &is_bl, &is_blx, &is_bcc);
 
-	      if (is_blx)
-		pc_for_insn &= ~3;
+  // Check to see if there is a relocation stub for this branch.
+  bool force_target_arm = false;
+  bool force_target_thumb = false;
+  const Cortex_a8_reloc* cortex_a8_reloc = NULL;
+  Cortex_a8_relocs_info::const_iterator p =
+    this->cortex_a8_relocs_info_.find(address);
 
-	      // If we found a relocation, use the proper destination,
-	      // not the offset in the (unrelocated) instruction.
-	      // Note this is always done if we switched the stub type above.
-	      if (cortex_a8_reloc != NULL)
-		offset = (off_t) (cortex_a8_reloc->destination() - pc_for_insn);
+  if (p != this->cortex_a8_relocs_info_.end())
+    {
+      cortex_a8_reloc = p->second;
+      bool target_is_thumb = (cortex_a8_reloc->destination() & 1) != 0;
 
-	      Arm_address target = (pc_for_insn + offset) | (is_blx ? 0 : 1);
+      if (cortex_a8_reloc->r_type() == elfcpp::R_ARM_THM_CALL
+	  && !target_is_thumb)
+	force_target_arm = true;
+      else if (cortex_a8_reloc->r_type() == elfcpp::R_ARM_THM_CALL
+	       && target_is_thumb)
+	force_target_thumb = true;
+    }
 
-	      // Add a new stub if destination address is in the same page.
-	      if (((address + i) & ~0xfffU) == (target & ~0xfffU))
-		{
-		  Cortex_a8_stub* stub =
-		    this->stub_factory_.make_cortex_a8_stub(stub_type,
-							    arm_relobj, shndx,
-							    address + i,
-							    target, insn);
-		  Stub_table<big_endian>* stub_table =
-		    arm_relobj->stub_table(shndx);
-		  gold_assert(stub_table != NULL);
-		  stub_table->add_cortex_a8_stub(address + i, stub);
-		}
-	    }
+  off_t offset;
+  Stub_type stub_type = arm_stub_none;
+
+  // Check if we have an offending branch instruction.
+  uint16_t upper_insn = (insn >> 16) & 0xffffU;
+  uint16_t lower_insn = insn & 0xffffU;
+  typedef class Arm_relocate_functions<big_endian> RelocFuncs;
+
+  if (cortex_a8_reloc != NULL
+      && cortex_a8_reloc->reloc_stub() != NULL)
+    // We've already made a stub for this instruction, e.g.
+    // it's a long branch or a Thumb->ARM stub.  Assume that
+    // stub will suffice to work around the A8 erratum (see
+    // setting of always_after_branch above).
+    ;
+  else if (is_bcc)
+    {
+      offset = RelocFuncs::thumb32_cond_branch_offset(upper_insn,
+						      lower_insn);
+      stub_type = arm_stub_a8_veneer_b_cond;
+    }
+  else if (is_b || is_bl || is_blx)
+    {
+      offset = RelocFuncs::thumb32_branch_offset(upper_insn,
+						 lower_insn);
+      if (is_blx)
+	offset &= ~3;
+
+      stub_type = (is_blx
+		   ? arm_stub_a8_veneer_blx
+		   : (is_bl
+		      ? arm_stub_a8_veneer_bl
+		      : arm_stub_a8_veneer_b));
+    }
+
+  if (stub_type != arm_stub_none)
+    {
+      Arm_address pc_for_insn = address + 4;
+
+      // The original instruction is a BL, but the target is
+      // an ARM instruction.  If we were not making a stub,
+      // the BL would have been converted to a BLX.  Use the
+      // BLX stub instead in that case.
+      if (this->may_use_v5t_interworking() && force_target_arm
+	  && stub_type == arm_stub_a8_veneer_bl)
+	{
+	  stub_type = arm_stub_a8_veneer_blx;
+	  is_blx = true;
+	  is_bl = false;
+	}
+      // Conversely, if the original instruction was
+      // BLX but the target is Thumb mode, use the BL stub.
+      else if (force_target_thumb
+	       && stub_type == arm_stub_a8_veneer_blx)
+	{
+	  stub_type = arm_stub_a8_veneer_bl;
+	  is_blx = false;
+	  is_bl = true;
 	}
 
-      i += insn_32bit ? 4 : 2;
-      last_was_32bit = insn_32bit;
-      last_was_branch = is_32bit_branch;
+      if (is_blx)
+	pc_for_insn &= ~3;
+
+      // If we found a relocation, use the proper destination,
+      // not the offset in the (unrelocated) instruction.
+      // Note this is always done if we switched the stub type above.
+      if (cortex_a8_reloc != NULL)
+	offset = (off_t) (cortex_a8_reloc->destination() - pc_for_insn);
+
+      Arm_address target = (pc_for_insn + offset) | (is_blx ? 0 : 1);
+
+      // Add a new stub if destination address is in the same page.
+      if ((address & ~0xfffU) == (target & ~0xfffU))
+	{
+	  Cortex_a8_stub* stub =
+	    this->stub_factory_.make_cortex_a8_stub(stub_type,
+						    arm_relobj, shndx,
+						    address,
+						    target, insn);
+	  Stub_table<big_endian>* stub_table =
+	    arm_relobj->stub_table(shndx);
+	  gold_assert(stub_table != NULL);
+	  stub_table->add_cortex_a8_stub(address, stub);
+	}
     }
 }
 
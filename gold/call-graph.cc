@@ -0,0 +1,487 @@
+// call-graph.cc -- order text sections using the call graph
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#include "parameters.h"
+#include "options.h"
+#include "object.h"
+#include "symtab.h"
+#include "layout.h"
+#include "output.h"
+#include "script.h"
+#include "call-graph.h"
+
+namespace gold
+{
+
+// Return true if cluster I1 is denser than cluster I2.
+
+bool
+Call_graph::Cluster_density_compare::operator()(unsigned int i1,
+						 unsigned int i2) const
+{
+  const Cluster& c1((*this->clusters_)[i1]);
+  const Cluster& c2((*this->clusters_)[i2]);
+  return (static_cast<double>(c1.weight) / c1.size
+	  > static_cast<double>(c2.weight) / c2.size);
+}
+
+// Find the cluster which holds node I, compressing the path as we go.
+
+static unsigned int
+find_leader(std::vector<unsigned int>* leaders, unsigned int i)
+{
+  unsigned int leader = i;
+  while ((*leaders)[leader] != leader)
+    leader = (*leaders)[leader];
+  while ((*leaders)[i] != leader)
+    {
+      unsigned int next = (*leaders)[i];
+      (*leaders)[i] = leader;
+      i = next;
+    }
+  return leader;
+}
+
+// Return whether to order the sections using the call graph.
+
+bool
+Call_graph::is_enabled()
+{
+  return (parameters->options().call_graph_ordering()
+	  && parameters->options().section_ordering_file() == NULL
+	  && !parameters->options().relocatable());
+}
+
+// Return whether the calls come from the relocs.
+
+bool
+Call_graph::wants_static_calls()
+{
+  return (Call_graph::is_enabled()
+	  && parameters->options().call_graph_profile() == NULL);
+}
+
+// Record a call from CALLER to CALLEE.
+
+void
+Call_graph::add_call(const Section_id& caller, const Section_id& callee,
+		     uint64_t weight)
+{
+  if (caller == callee || weight == 0)
+    return;
+
+  Node_map::const_iterator pfrom = this->node_map_.find(caller);
+  if (pfrom == this->node_map_.end())
+    return;
+  Node_map::const_iterator pto = this->node_map_.find(callee);
+  if (pto == this->node_map_.end())
+    return;
+
+  // We can only move sections around within an output section.
+  if (this->nodes_[pfrom->second].os != this->nodes_[pto->second].os)
+    return;
+
+  this->edges_.push_back(Edge(pfrom->second, pto->second, weight));
+}
+
+// Add a node for each input section in an executable output section.
+
+void
+Call_graph::add_nodes(Layout* layout)
+{
+  for (Layout::Section_list::const_iterator p = layout->section_list().begin();
+       p != layout->section_list().end();
+       ++p)
+    {
+      Output_section* os = *p;
+      if ((os->flags() & elfcpp::SHF_EXECINSTR) == 0
+	  || (os->flags() & elfcpp::SHF_ALLOC) == 0)
+	continue;
+
+      const Output_section::Input_section_list& isl(os->input_sections());
+      for (Output_section::Input_section_list::const_iterator q = isl.begin();
+	   q != isl.end();
+	   ++q)
+	{
+	  if (!q->is_input_section() && !q->is_relaxed_input_section())
+	    continue;
+	  Relobj* obj = (q->is_input_section()
+			 ? q->relobj()
+			 : q->relaxed_input_section()->relobj());
+	  Section_id secn(obj, q->shndx());
+	  std::pair<Node_map::iterator, bool> ins =
+	    this->node_map_.insert(std::make_pair(secn, this->nodes_.size()));
+	  if (ins.second)
+	    this->nodes_.push_back(Node(secn, os, q->data_size()));
+	}
+    }
+}
+
+// Return the input section which defines NAME.
+
+bool
+Call_graph::symbol_section(Symbol_table* symtab, const char* name,
+			   Section_id* secn) const
+{
+  Symbol* sym = symtab->lookup(name);
+  if (sym == NULL)
+    return false;
+  return this->symbol_section(symtab, sym, secn);
+}
+
+// Return the input section which defines SYM.
+
+bool
+Call_graph::symbol_section(Symbol_table* symtab, Symbol* sym,
+			   Section_id* secn) const
+{
+  if (sym->is_forwarder())
+    sym = symtab->resolve_forwards(sym);
+  if (sym->source() != Symbol::FROM_OBJECT)
+    return false;
+
+  Object* obj = sym->object();
+  if (obj->is_dynamic() || obj->pluginobj() != NULL)
+    return false;
+
+  bool is_ordinary;
+  unsigned int shndx = sym->shndx(&is_ordinary);
+  if (!is_ordinary)
+    return false;
+
+  *secn = Section_id(static_cast<Relobj*>(obj), shndx);
+  return true;
+}
+
+// Read the --call-graph-profile file.  Each line has the name of the
+// calling function, the name of the called function, and the number
+// of calls, separated by whitespace.  Functions which are not defined
+// in an input section of this link are ignored, since profiles are
+// usually collected from an older build.
+
+void
+Call_graph::read_profile(Symbol_table* symtab)
+{
+  const char* filename = parameters->options().call_graph_profile();
+  FILE* f = ::fopen(filename, "r");
+  if (f == NULL)
+    gold_fatal(_("unable to open --call-graph-profile file %s: %s"),
+	       filename, strerror(errno));
+
+  char* buf = NULL;
+  size_t bufsize = 0;
+  ssize_t len;
+  int lineno = 0;
+  while ((len = ::getline(&buf, &bufsize, f)) >= 0)
+    {
+      ++lineno;
+      while (len > 0 && (buf[len - 1] == '\n' || buf[len - 1] == '\r'))
+	--len;
+      buf[len] = '\0';
+
+      // Split the line into fields separated by blanks.
+      std::vector<const char*> fields;
+      char* p = buf;
+      while (*p != '\0')
+	{
+	  if (*p == ' ' || *p == '\t')
+	    {
+	      *p++ = '\0';
+	      continue;
+	    }
+	  fields.push_back(p);
+	  while (*p != '\0' && *p != ' ' && *p != '\t')
+	    ++p;
+	}
+      if (fields.empty() || fields[0][0] == '#')
+	continue;
+
+      char* end = NULL;
+      uint64_t count = 0;
+      if (fields.size() == 3 && fields[2][0] != '-')
+	count = strtoull(fields[2], &end, 10);
+      if (end == NULL || end == fields[2] || *end != '\0')
+	{
+	  gold_error(_("%s:%d: expected CALLER CALLEE COUNT"),
+		     filename, lineno);
+	  continue;
+	}
+
+      Section_id from;
+      Section_id to;
+      if (this->symbol_section(symtab, fields[0], &from)
+	  && this->symbol_section(symtab, fields[1], &to))
+	this->add_call(from, to, count);
+    }
+  if (::ferror(f))
+    gold_fatal(_("unable to read --call-graph-profile file %s: %s"),
+	       filename, strerror(errno));
+  free(buf);
+  ::fclose(f);
+}
+
+// Add the calls which the Read_relocs task found in the relocs of
+// OBJECT.  The calls to global symbols are resolved here, when no
+// other task is changing the symbol table.
+
+void
+Call_graph::add_object_calls(Symbol_table* symtab, Relobj* object)
+{
+  Call_graph_calls* calls = object->call_graph_calls();
+  for (Call_graph_calls::const_iterator p = calls->begin();
+       p != calls->end();
+       ++p)
+    {
+      Section_id callee;
+      if (p->callee_symbol == NULL)
+	callee = Section_id(object, p->callee_shndx);
+      else if (!this->symbol_section(symtab, p->callee_symbol, &callee))
+	continue;
+      this->add_call(Section_id(object, p->caller_shndx), callee, p->count);
+    }
+  Call_graph_calls().swap(*calls);
+}
+
+// Group the nodes into clusters and return them in the order in which
+// they should appear.  This follows the C3 heuristic: visit the nodes
+// from the densest down, and append each one's cluster to the cluster
+// of its most frequent caller, as long as the result does not get too
+// big or too sparse.  The clusters are then sorted by density.
+
+void
+Call_graph::compute_order(std::vector<unsigned int>* order)
+{
+  // Combine duplicate calls, and find the most frequent caller of
+  // each node.  Sorting by caller index within each callee makes the
+  // choice between equally frequent callers independent of the order
+  // in which the calls were found.
+  std::sort(this->edges_.begin(), this->edges_.end(), Edge_compare());
+  size_t i = 0;
+  while (i < this->edges_.size())
+    {
+      unsigned int caller = this->edges_[i].caller;
+      unsigned int callee = this->edges_[i].callee;
+      uint64_t weight = 0;
+      for (;
+	   (i < this->edges_.size()
+	    && this->edges_[i].caller == caller
+	    && this->edges_[i].callee == callee);
+	   ++i)
+	weight += this->edges_[i].weight;
+
+      Node& to(this->nodes_[callee]);
+      to.weight += weight;
+      to.has_calls = true;
+      if (to.pred == -1U || weight > to.pred_weight)
+	{
+	  to.pred = caller;
+	  to.pred_weight = weight;
+	}
+      this->nodes_[caller].has_calls = true;
+    }
+  std::vector<Edge>().swap(this->edges_);
+
+  // Start with each node in a cluster by itself.
+  unsigned int count = this->nodes_.size();
+  std::vector<Cluster> clusters(count);
+  std::vector<unsigned int> leaders(count);
+  std::vector<unsigned int> next(count, -1U);
+  std::vector<unsigned int> sorted;
+  for (unsigned int n = 0; n < count; ++n)
+    {
+      Cluster& c(clusters[n]);
+      c.head = n;
+      c.tail = n;
+      c.size = std::max(this->nodes_[n].size, static_cast<uint64_t>(1));
+      c.weight = this->nodes_[n].weight;
+      leaders[n] = n;
+      if (this->nodes_[n].has_calls)
+	sorted.push_back(n);
+    }
+
+  Cluster_density_compare density_compare(&clusters);
+  std::stable_sort(sorted.begin(), sorted.end(), density_compare);
+
+  // A node is only merged when it is visited, so each node we visit
+  // still leads its own cluster.
+  for (std::vector<unsigned int>::const_iterator p = sorted.begin();
+       p != sorted.end();
+       ++p)
+    {
+      const Node& node(this->nodes_[*p]);
+
+      // Ignore the caller if it accounts for only a small part of the
+      // calls to this node.
+      if (node.pred == -1U || node.pred_weight * 10 <= node.weight)
+	continue;
+
+      unsigned int pred_leader = find_leader(&leaders, node.pred);
+      if (pred_leader == *p)
+	continue;
+
+      Cluster& c(clusters[*p]);
+      Cluster& pc(clusters[pred_leader]);
+      if (c.size + pc.size > max_cluster_size)
+	continue;
+
+      double old_density = static_cast<double>(pc.weight) / pc.size;
+      double new_density = (static_cast<double>(pc.weight + c.weight)
+			    / (pc.size + c.size));
+      if (new_density * max_density_degradation < old_density)
+	continue;
+
+      leaders[*p] = pred_leader;
+      next[pc.tail] = c.head;
+      pc.tail = c.tail;
+      pc.size += c.size;
+      pc.weight += c.weight;
+      c.size = 0;
+      c.weight = 0;
+    }
+
+  // Collect the remaining clusters and sort them by density.
+  std::vector<unsigned int> leaders_left;
+  for (std::vector<unsigned int>::const_iterator p = sorted.begin();
+       p != sorted.end();
+       ++p)
+    if (leaders[*p] == *p)
+      leaders_left.push_back(*p);
+  std::stable_sort(leaders_left.begin(), leaders_left.end(), density_compare);
+
+  for (std::vector<unsigned int>::const_iterator p = leaders_left.begin();
+       p != leaders_left.end();
+       ++p)
+    for (unsigned int n = clusters[*p].head; n != -1U; n = next[n])
+      order->push_back(n);
+}
+
+// Compute the order of the input sections in the executable output
+// sections.  The sections which make or receive calls are placed in
+// cluster order.  If --text-reorder is in effect, the cluster order
+// takes the place of the .text.hot sections, so that the
+// .text.unlikely, .text.exit and .text.startup sections still come
+// first as in
+// Output_section::Input_section_sort_section_prefix_special_ordering_compare.
+// All other sections keep their input order.
+
+void
+Call_graph::order_sections(const Task* task, Symbol_table* symtab,
+			   Layout* layout,
+			   const Input_objects* input_objects)
+{
+  this->add_nodes(layout);
+  if (this->nodes_.empty())
+    return;
+
+  const bool text_reorder =
+    (parameters->options().text_reorder()
+     && !layout->script_options()->saw_sections_clause());
+  const bool static_calls = parameters->options().call_graph_profile() == NULL;
+
+  // To apply the special .text ordering we need the section names,
+  // which means reading the section headers.  Group the nodes by
+  // object so that we only lock each object once.
+  typedef Unordered_map<Relobj*, std::vector<unsigned int> > Object_nodes;
+  Object_nodes object_nodes;
+  std::vector<int> special(this->nodes_.size(), -1);
+  if (text_reorder)
+    {
+      for (unsigned int n = 0; n < this->nodes_.size(); ++n)
+	if (strcmp(this->nodes_[n].os->name(), ".text") == 0)
+	  object_nodes[this->nodes_[n].secn.first].push_back(n);
+    }
+
+  if (!static_calls)
+    this->read_profile(symtab);
+
+  // Take the calls which the Read_relocs tasks found in input order,
+  // so that the graph does not depend on the order in which those
+  // tasks ran.
+  for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
+       p != input_objects->relobj_end();
+       ++p)
+    {
+      if (static_calls)
+	this->add_object_calls(symtab, *p);
+
+      Object_nodes::const_iterator pn = object_nodes.find(*p);
+      if (pn == object_nodes.end())
+	continue;
+
+      Task_lock_obj<Object> tlo(task, *p);
+      for (std::vector<unsigned int>::const_iterator q = pn->second.begin();
+	   q != pn->second.end();
+	   ++q)
+	{
+	  std::string name((*p)->section_name(this->nodes_[*q].secn.second));
+	  special[*q] = Layout::special_ordering_of_input_section(name.c_str());
+	}
+    }
+
+  std::vector<unsigned int> order;
+  this->compute_order(&order);
+
+  // The prefixes handled by special_ordering_of_input_section, in
+  // order, are .text.unlikely, .text.exit, .text.startup and
+  // .text.hot.
+  // Those which come before .text.hot keep their place even if they
+  // make or receive calls.
+  const int hot = 3;
+  std::vector<unsigned int> index(this->nodes_.size(), 0);
+  for (unsigned int n = 0; n < this->nodes_.size(); ++n)
+    if (special[n] >= 0 && special[n] < hot)
+      index[n] = special[n] + 1;
+  unsigned int rest = hot + 1;
+  for (unsigned int i = 0; i < order.size(); ++i)
+    if (index[order[i]] == 0)
+      index[order[i]] = rest++;
+  for (unsigned int n = 0; n < this->nodes_.size(); ++n)
+    {
+      if (index[n] != 0)
+	continue;
+      if (special[n] == hot)
+	index[n] = rest;
+      else
+	index[n] = rest + 1;
+    }
+
+  Output_section::Section_layout_order* order_map =
+    layout->get_section_order_map();
+  for (unsigned int n = 0; n < this->nodes_.size(); ++n)
+    (*order_map)[this->nodes_[n].secn] = index[n];
+
+  for (Layout::Section_list::const_iterator p = layout->section_list().begin();
+       p != layout->section_list().end();
+       ++p)
+    if (((*p)->flags() & elfcpp::SHF_EXECINSTR) != 0
+	&& ((*p)->flags() & elfcpp::SHF_ALLOC) != 0)
+      (*p)->update_section_layout(order_map);
+}
+
+} // End namespace gold.
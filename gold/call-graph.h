@@ -0,0 +1,209 @@
+// call-graph.h -- order text sections using the call graph  -*- C++ -*-
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#ifndef GOLD_CALL_GRAPH_H
+#define GOLD_CALL_GRAPH_H
+
+#include <vector>
+
+#include "object.h"
+
+namespace gold
+{
+
+class Task;
+class Symbol_table;
+class Layout;
+class Input_objects;
+
+// This class implements --call-graph-ordering.  It builds a weighted
+// call graph whose nodes are the input sections in executable output
+// sections, either from a profile given with --call-graph-profile or
+// from the relocations in the input objects.  It then groups callers
+// and callees into clusters, in the manner of the C3 heuristic
+// described by Ottoni and Maher in "Optimizing Function Placement for
+// Large-Scale Data-Center Applications", and orders the sections so
+// that the hottest clusters come first.  The result is recorded in
+// the section order map of the Layout, just as if it had been given
+// by a plugin.
+
+class Call_graph
+{
+ public:
+  Call_graph()
+    : nodes_(), node_map_(), edges_()
+  { }
+
+  // Whether to order the sections using the call graph.  An order
+  // given by --section-ordering-file takes precedence.
+  static bool
+  is_enabled();
+
+  // Whether the calls come from the relocs rather than from a
+  // profile.  If so, the Read_relocs tasks record the calls of each
+  // object with Relobj::find_call_graph_edges.
+  static bool
+  wants_static_calls();
+
+  // Compute an order for the input sections in the executable output
+  // sections of LAYOUT, and apply it to those output sections.  This
+  // must run after all the Read_relocs tasks.
+  void
+  order_sections(const Task*, Symbol_table*, Layout*, const Input_objects*);
+
+  // Record a call of weight WEIGHT from the input section CALLER to
+  // the input section CALLEE.  Calls to or from sections which are
+  // not in an executable output section are ignored.
+  void
+  add_call(const Section_id& caller, const Section_id& callee,
+	   uint64_t weight);
+
+ private:
+  // Clusters larger than this are not merged further.  This is large
+  // enough to hold the working set of most services, and small
+  // enough that one cluster does not span too many pages.
+  static const uint64_t max_cluster_size = 1024 * 1024;
+
+  // Don't merge a cluster into its caller's cluster if that would
+  // reduce the density of the caller's cluster by more than this
+  // factor.
+  static const uint64_t max_density_degradation = 8;
+
+  // A node in the call graph.  Each node is an input section.
+  struct Node
+  {
+    Node(const Section_id& secn, const Output_section* os, uint64_t size)
+      : secn(secn), os(os), size(size), weight(0), pred(-1U),
+	pred_weight(0), has_calls(false)
+    { }
+
+    // The input section.
+    Section_id secn;
+    // The output section to which it is assigned.
+    const Output_section* os;
+    // The size of the input section.
+    uint64_t size;
+    // The sum of the weights of the calls to this section.
+    uint64_t weight;
+    // The index of the caller which calls this section most often, or
+    // -1U if there are no callers.
+    unsigned int pred;
+    // The weight of the calls from PRED.
+    uint64_t pred_weight;
+    // Whether this section makes or receives any calls.
+    bool has_calls;
+  };
+
+  // A call between two nodes.
+  struct Edge
+  {
+    Edge(unsigned int caller, unsigned int callee, uint64_t weight)
+      : caller(caller), callee(callee), weight(weight)
+    { }
+
+    unsigned int caller;
+    unsigned int callee;
+    uint64_t weight;
+  };
+
+  // Sort edges by callee and then by caller, so that duplicate edges
+  // are adjacent.
+  struct Edge_compare
+  {
+    bool
+    operator()(const Edge& e1, const Edge& e2) const
+    {
+      if (e1.callee != e2.callee)
+	return e1.callee < e2.callee;
+      return e1.caller < e2.caller;
+    }
+  };
+
+  // A cluster of nodes which should be placed together.
+  struct Cluster
+  {
+    // The first and last nodes in the cluster.  compute_order keeps
+    // the nodes of each cluster on a linked list.
+    unsigned int head;
+    unsigned int tail;
+    // The total size of the nodes in the cluster.
+    uint64_t size;
+    // The total weight of the nodes in the cluster.
+    uint64_t weight;
+  };
+
+  // Sort clusters by density, hottest first.
+  class Cluster_density_compare
+  {
+   public:
+    Cluster_density_compare(const std::vector<Cluster>* clusters)
+      : clusters_(clusters)
+    { }
+
+    bool
+    operator()(unsigned int i1, unsigned int i2) const;
+
+   private:
+    const std::vector<Cluster>* clusters_;
+  };
+
+  typedef Unordered_map<Section_id, unsigned int, Section_id_hash> Node_map;
+
+  // Add a node for each input section in an executable output
+  // section.
+  void
+  add_nodes(Layout*);
+
+  // Read the edges from the --call-graph-profile file.
+  void
+  read_profile(Symbol_table*);
+
+  // Add the calls which the Read_relocs task recorded for an object,
+  // and free them.
+  void
+  add_object_calls(Symbol_table*, Relobj*);
+
+  // Return the input section which defines the symbol NAME.  Return
+  // false if there is no such section.
+  bool
+  symbol_section(Symbol_table*, const char* name, Section_id*) const;
+
+  // Likewise, for the symbol SYM.
+  bool
+  symbol_section(Symbol_table*, Symbol* sym, Section_id*) const;
+
+  // Compute the clusters and return the node indexes in the order in
+  // which they should appear.  Nodes which are not part of any call
+  // are not returned.
+  void
+  compute_order(std::vector<unsigned int>*);
+
+  // The nodes.
+  std::vector<Node> nodes_;
+  // Map from input section to node index.
+  Node_map node_map_;
+  // The calls between nodes, as recorded by add_call.
+  std::vector<Edge> edges_;
+};
+
+} // End namespace gold.
+
+#endif // !defined(GOLD_CALL_GRAPH_H)
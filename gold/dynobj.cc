@@ -22,6 +22,7 @@
 
 #include "gold.h"
 
+#include <algorithm>
 #include <vector>
 #include <cstring>
 
@@ -914,23 +915,78 @@ Dynobj::elf_hash(const char* name)
   return h;
 }
 
+// Compute the hash codes of the names of the dynamic symbols DYNSYMS.
+// If GNU_HASHVALS is not NULL, set it to the GNU hash codes.  If
+// ELF_HASHVALS is not NULL, set it to the standard ELF hash codes.
+// Both vectors are parallel to DYNSYMS.  When both kinds of hash
+// table are wanted, this walks each name only once; with many
+// symbols the names are scattered through memory, and reading them
+// costs more than computing the hashes.
+
+void
+Dynobj::compute_hash_values(const std::vector<Symbol*>& dynsyms,
+			    std::vector<uint32_t>* gnu_hashvals,
+			    std::vector<uint32_t>* elf_hashvals)
+{
+  const unsigned int dynsym_count = dynsyms.size();
+
+  if (gnu_hashvals == NULL)
+    {
+      gold_assert(elf_hashvals != NULL);
+      elf_hashvals->resize(dynsym_count);
+      for (unsigned int i = 0; i < dynsym_count; ++i)
+	(*elf_hashvals)[i] = Dynobj::elf_hash(dynsyms[i]->name());
+      return;
+    }
+
+  gnu_hashvals->resize(dynsym_count);
+  if (elf_hashvals == NULL)
+    {
+      for (unsigned int i = 0; i < dynsym_count; ++i)
+	(*gnu_hashvals)[i] = Dynobj::gnu_hash(dynsyms[i]->name());
+      return;
+    }
+
+  elf_hashvals->resize(dynsym_count);
+  for (unsigned int i = 0; i < dynsym_count; ++i)
+    {
+      // This is gnu_hash and elf_hash combined.
+      const unsigned char* nameu =
+	reinterpret_cast<const unsigned char*>(dynsyms[i]->name());
+      uint32_t gh = 5381;
+      uint32_t eh = 0;
+      unsigned char c;
+      while ((c = *nameu++) != '\0')
+	{
+	  gh = (gh << 5) + gh + c;
+	  eh = (eh << 4) + c;
+	  uint32_t g = eh & 0xf0000000;
+	  if (g != 0)
+	    {
+	      eh ^= g >> 24;
+	      eh ^= g;
+	    }
+	}
+      (*gnu_hashvals)[i] = gh;
+      (*elf_hashvals)[i] = eh;
+    }
+}
+
 // Create a standard ELF hash table, setting *PPHASH and *PHASHLEN.
 // DYNSYMS is a vector with all the global dynamic symbols.
-// LOCAL_DYNSYM_COUNT is the number of local symbols in the dynamic
-// symbol table.
+// DYNSYM_HASHVALS is parallel to DYNSYMS, and holds the ELF hash codes
+// computed by compute_hash_values.  LOCAL_DYNSYM_COUNT is the number
+// of local symbols in the dynamic symbol table.
 
 void
 Dynobj::create_elf_hash_table(const std::vector<Symbol*>& dynsyms,
+			      const std::vector<uint32_t>& dynsym_hashvals,
 			      unsigned int local_dynsym_count,
 			      unsigned char** pphash,
 			      unsigned int* phashlen)
 {
   unsigned int dynsym_count = dynsyms.size();
-
-  // Get the hash values for all the symbols.
-  std::vector<uint32_t> dynsym_hashvals(dynsym_count);
-  for (unsigned int i = 0; i < dynsym_count; ++i)
-    dynsym_hashvals[i] = Dynobj::elf_hash(dynsyms[i]->name());
+  gold_assert(dynsym_hashvals.size() == dynsym_count);
 
   const unsigned int bucketcount =
     Dynobj::compute_bucket_count(dynsym_hashvals, false);
@@ -1057,16 +1113,19 @@ Dynobj::gnu_hash(const char* name)
 // dynamic linker.  They are referenced using dynamic tag DT_GNU_HASH.
 // TARGET is the target.  DYNSYMS is a vector with all the global
 // symbols which will be going into the dynamic symbol table.
-// LOCAL_DYNSYM_COUNT is the number of local symbols in the dynamic
-// symbol table.
+// GNU_HASHVALS is parallel to DYNSYMS, and holds the GNU hash codes
+// computed by compute_hash_values.  LOCAL_DYNSYM_COUNT is the number
+// of local symbols in the dynamic symbol table.
 
 void
 Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
+			      const std::vector<uint32_t>& gnu_hashvals,
 			      unsigned int local_dynsym_count,
 			      unsigned char** pphash,
 			      unsigned int* phashlen)
 {
   const unsigned int count = dynsyms.size();
+  gold_assert(gnu_hashvals.size() == count);
 
   // Sort the dynamic symbols into two vectors.  Symbols which we do
   // not want to put into the hash table we store into
@@ -1095,7 +1154,7 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
       else
 	{
 	  hashed_dynsyms.push_back(sym);
-	  dynsym_hashvals.push_back(Dynobj::gnu_hash(sym->name()));
+	  dynsym_hashvals.push_back(gnu_hashvals[i]);
 	}
     }
 
@@ -1212,31 +1271,30 @@ Dynobj::sized_create_gnu_hash_table(
 
   const unsigned int nsyms = hashed_dynsyms.size();
 
-  uint32_t maskbitslog2 = 1;
-  uint32_t x = nsyms >> 1;
-  while (x != 0)
-    {
-      ++maskbitslog2;
-      x >>= 1;
-    }
-  if (maskbitslog2 < 3)
-    maskbitslog2 = 5;
-  else if (((1U << (maskbitslog2 - 2)) & nsyms) != 0)
-    maskbitslog2 += 3;
-  else
-    maskbitslog2 += 2;
-
+  // The dynamic linker checks the Bloom filter before it looks in a
+  // hash bucket, and each symbol sets two bits in it.  Give each
+  // symbol at least 12 bits, rounded up to a power of two, which
+  // keeps the false positive rate for a name which is not in the
+  // table under about 2.5%.  The old GNU linker used 8 to 16 bits
+  // per symbol, for a false positive rate of up to 5%.
   uint32_t shift1;
   if (size == 32)
     shift1 = 5;
   else
-    {
-      if (maskbitslog2 == 5)
-	maskbitslog2 = 6;
-      shift1 = 6;
-    }
+    shift1 = 6;
+  uint64_t wantbits = static_cast<uint64_t>(nsyms) * 12;
+  uint32_t maskbitslog2 = shift1;
+  while ((static_cast<uint64_t>(1) << maskbitslog2) < wantbits
+	 && maskbitslog2 < 31)
+    ++maskbitslog2;
+
+  // The word index uses bits SHIFT1 to MASKBITSLOG2 - 1 of the hash
+  // code, and the first bit uses the low SHIFT1 bits.  Take the
+  // second bit from just above the word index, so that it is
+  // independent of the first, but keep all SHIFT1 bits of it within
+  // the 32-bit hash code.
   uint32_t mask = (1U << shift1) - 1U;
-  uint32_t shift2 = maskbitslog2;
+  uint32_t shift2 = std::min(maskbitslog2, 32 - shift1);
   uint32_t maskbits = 1U << maskbitslog2;
   uint32_t maskwords = 1U << (maskbitslog2 - shift1);
 
@@ -1246,17 +1304,29 @@ Dynobj::sized_create_gnu_hash_table(
   std::vector<uint32_t> indx(bucketcount);
   uint32_t symindx = unhashed_dynsym_count;
 
-  // Count the number of times each hash bucket is used.
+  // Find the bucket of each symbol, and count the number of times
+  // each hash bucket is used.
+  std::vector<uint32_t> buckets(nsyms);
   for (unsigned int i = 0; i < nsyms; ++i)
-    ++counts[dynsym_hashvals[i] % bucketcount];
+    {
+      buckets[i] = dynsym_hashvals[i] % bucketcount;
+      ++counts[buckets[i]];
+    }
 
-  unsigned int cnt = symindx;
+  unsigned int cnt = 0;
   for (unsigned int i = 0; i < bucketcount; ++i)
     {
       indx[i] = cnt;
       cnt += counts[i];
     }
 
+  // Sort the symbols by bucket, keeping the input order within each
+  // bucket.  ORDER[J] is the index in HASHED_DYNSYMS of the symbol
+  // which gets dynamic symbol index SYMINDX + J.
+  std::vector<unsigned int> order(nsyms);
+  for (unsigned int i = 0; i < nsyms; ++i)
+    order[indx[buckets[i]]++] = i;
+
   unsigned int hashlen = (4 + bucketcount + nsyms) * 4;
   hashlen += maskbits / 8;
   unsigned char* phash = new unsigned char[hashlen];
@@ -1267,45 +1337,42 @@ Dynobj::sized_create_gnu_hash_table(
   elfcpp::Swap<32, big_endian>::writeval(phash + 12, shift2);
 
   unsigned char* p = phash + 16 + maskbits / 8;
+  cnt = symindx;
   for (unsigned int i = 0; i < bucketcount; ++i)
     {
       if (counts[i] == 0)
 	elfcpp::Swap<32, big_endian>::writeval(p, 0);
       else
-	elfcpp::Swap<32, big_endian>::writeval(p, indx[i]);
+	elfcpp::Swap<32, big_endian>::writeval(p, cnt);
+      cnt += counts[i];
       p += 4;
     }
 
-  for (unsigned int i = 0; i < nsyms; ++i)
+  // Write the hash values in dynamic symbol order, so that the
+  // chains and the symbols are visited in sequence.
+  for (unsigned int j = 0; j < nsyms; ++j)
     {
-      Symbol* sym = hashed_dynsyms[i];
+      unsigned int i = order[j];
       uint32_t hashval = dynsym_hashvals[i];
 
-      unsigned int bucket = hashval % bucketcount;
       unsigned int val = ((hashval >> shift1)
 			  & ((maskbits >> shift1) - 1));
       bitmask[val] |= (static_cast<Word>(1U)) << (hashval & mask);
       bitmask[val] |= (static_cast<Word>(1U)) << ((hashval >> shift2) & mask);
       val = hashval & ~ 1U;
-      if (counts[bucket] == 1)
+      if (j + 1 == nsyms || buckets[order[j + 1]] != buckets[i])
 	{
 	  // Last element terminates the chain.
 	  val |= 1;
 	}
-      elfcpp::Swap<32, big_endian>::writeval(p + (indx[bucket] - symindx) * 4,
-					     val);
-      --counts[bucket];
+      elfcpp::Swap<32, big_endian>::writeval(p, val);
+      p += 4;
 
-      sym->set_dynsym_index(indx[bucket]);
-      ++indx[bucket];
+      hashed_dynsyms[i]->set_dynsym_index(symindx + j);
     }
 
-  p = phash + 16;
-  for (unsigned int i = 0; i < maskwords; ++i)
-    {
-      elfcpp::Swap<size, big_endian>::writeval(p, bitmask[i]);
-      p += size / 8;
-    }
+  elfcpp::Swap_array<size, big_endian>::writevals(phash + 16, &bitmask[0],
+						  maskwords);
 
   *phashlen = hashlen;
   *pphash = phash;
@@ -1376,6 +1443,20 @@ Verneed::add_name(const char* name)
   return vv;
 }
 
+// Return whether any of the version names starts with PREFIX.
+
+bool
+Verneed::has_version_prefix(const char* prefix) const
+{
+  size_t len = strlen(prefix);
+  for (Need_versions::const_iterator p = this->need_versions_.begin();
+       p != this->need_versions_.end();
+       ++p)
+    if (strncmp((*p)->version(), prefix, len) == 0)
+      return true;
+  return false;
+}
+
 // Set the version indexes starting at INDEX.
 
 unsigned int
@@ -1439,7 +1520,7 @@ Versions::Versions(const Version_script_info& version_script,
                    Stringpool* dynpool)
   : defs_(), needs_(), version_table_(),
     is_finalized_(false), version_script_(version_script),
-    needs_base_version_(true)
+    needs_base_version_(true), needs_relr_version_(false)
 {
   if (!this->version_script_.empty())
     {
@@ -1636,6 +1717,32 @@ Versions::add_need(Stringpool* dynpool, const char* filename, const char* name,
   ins.first->second = vn->add_name(name);
 }
 
+// Add a reference to GLIBC_ABI_DT_RELR if we need one.
+
+void
+Versions::add_relr_version(Stringpool* dynpool)
+{
+  if (!this->needs_relr_version_)
+    return;
+
+  std::vector<const char*> filenames;
+  for (Needs::const_iterator p = this->needs_.begin();
+       p != this->needs_.end();
+       ++p)
+    if ((*p)->has_version_prefix("GLIBC_2."))
+      filenames.push_back((*p)->filename());
+
+  for (std::vector<const char*>::const_iterator p = filenames.begin();
+       p != filenames.end();
+       ++p)
+    {
+      Stringpool::Key version_key;
+      const char* version = dynpool->add("GLIBC_ABI_DT_RELR", true,
+					 &version_key);
+      this->add_need(dynpool, *p, version, version_key);
+    }
+}
+
 // Set the version indexes.  Create a new dynamic version symbol for
 // each new version definition.
 
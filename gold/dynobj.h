@@ -86,22 +86,33 @@ class Dynobj : public Object
   static uint32_t
   elf_hash(const char*);
 
+  // Compute the GNU and ELF hash codes of the names of DYNSYMS.
+  // Either vector may be NULL if that kind of hash table is not
+  // wanted.
+  static void
+  compute_hash_values(const std::vector<Symbol*>& dynsyms,
+		      std::vector<uint32_t>* gnu_hashvals,
+		      std::vector<uint32_t>* elf_hashvals);
+
   // Create a standard ELF hash table, setting *PPHASH and *PHASHLEN.
-  // DYNSYMS is the global dynamic symbols.  LOCAL_DYNSYM_COUNT is the
-  // number of local dynamic symbols, which is the index of the first
-  // dynamic gobal symbol.
+  // DYNSYMS is the global dynamic symbols, and DYNSYM_HASHVALS their
+  // ELF hash codes.  LOCAL_DYNSYM_COUNT is the number of local
+  // dynamic symbols, which is the index of the first dynamic gobal
+  // symbol.
   static void
   create_elf_hash_table(const std::vector<Symbol*>& dynsyms,
+			const std::vector<uint32_t>& dynsym_hashvals,
 			unsigned int local_dynsym_count,
 			unsigned char** pphash,
 			unsigned int* phashlen);
 
   // Create a GNU hash table, setting *PPHASH and *PHASHLEN.  DYNSYMS
-  // is the global dynamic symbols.  LOCAL_DYNSYM_COUNT is the number
-  // of local dynamic symbols, which is the index of the first dynamic
-  // gobal symbol.
+  // is the global dynamic symbols, and GNU_HASHVALS their GNU hash
+  // codes.  LOCAL_DYNSYM_COUNT is the number of local dynamic
+  // symbols, which is the index of the first dynamic gobal symbol.
   static void
   create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
+			const std::vector<uint32_t>& gnu_hashvals,
 			unsigned int local_dynsym_count,
 			unsigned char** pphash, unsigned int* phashlen);
 
@@ -529,6 +540,10 @@ class Verneed
   Verneed_version*
   add_name(const char* name);
 
+  // Return whether any of the version names starts with PREFIX.
+  bool
+  has_version_prefix(const char* prefix) const;
+
   // Set the version indexes, starting at INDEX.  Return the updated
   // INDEX.
   unsigned int
@@ -576,6 +591,18 @@ class Versions
   finalize(Symbol_table* symtab, unsigned int dynsym_index,
 	   std::vector<Symbol*>* syms);
 
+  // Note that the output has a SHT_RELR section.
+  void
+  set_needs_relr_version()
+  { this->needs_relr_version_ = true; }
+
+  // If the output has a SHT_RELR section, add a reference to
+  // GLIBC_ABI_DT_RELR to each file from which we need a GLIBC_2.*
+  // version.  glibc refuses to load objects with DT_RELR without
+  // it.  This must be called before finalize.
+  void
+  add_relr_version(Stringpool*);
+
   // Return whether there are any version definitions.
   bool
   any_defs() const
@@ -681,6 +708,8 @@ class Versions
   // Whether we need to insert a base version.  This is only used for
   // shared libraries and is cleared when the base version is defined.
   bool needs_base_version_;
+  // Whether the output has a SHT_RELR section.
+  bool needs_relr_version_;
 };
 
 } // End namespace gold.
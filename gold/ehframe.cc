@@ -29,6 +29,7 @@
 #include "dwarf.h"
 #include "symtab.h"
 #include "reloc.h"
+#include "workqueue.h"
 #include "ehframe.h"
 
 namespace gold
@@ -84,6 +85,8 @@ Eh_frame_hdr::Eh_frame_hdr(Output_section* eh_frame_section,
     eh_frame_section_(eh_frame_section),
     eh_frame_data_(eh_frame_data),
     fde_offsets_(),
+    fde_addresses_(),
+    sorted_chunks_(),
     any_unrecognized_eh_frame_sections_(false)
 {
 }
@@ -182,21 +185,23 @@ Eh_frame_hdr::do_sized_write(Output_file* of)
       // relocations which are, of course, target specific.  This code
       // is run after all those relocations have been applied to the
       // output file.  Here we read the output file again to find the
-      // PC values.  Then we sort the list and write it out.
+      // PC values.  Then we sort the list and write it out.  If
+      // queue_sort_tasks was used, the PC values have already been
+      // found, and each chunk has already been sorted.
 
-      Fde_addresses<size> fde_addresses(this->fde_offsets_.size());
-      this->get_fde_addresses<size, big_endian>(of, &this->fde_offsets_,
-						&fde_addresses);
-
-      std::sort(fde_addresses.begin(), fde_addresses.end(),
-		Fde_address_compare<size>());
+      if (this->sorted_chunks_.empty())
+	{
+	  this->fde_addresses_.resize(this->fde_offsets_.size());
+	  this->get_fde_addresses<size, big_endian>(of, 0,
+						    this->fde_offsets_.size());
+	}
+      this->sort_fde_addresses();
 
-      typename elfcpp::Elf_types<size>::Elf_Addr output_address;
-      output_address = this->address();
+      uint64_t output_address = this->address();
 
       unsigned char* pfde = oview + 12;
-      for (typename Fde_addresses<size>::iterator p = fde_addresses.begin();
-	   p != fde_addresses.end();
+      for (Fde_addresses::const_iterator p = this->fde_addresses_.begin();
+	   p != this->fde_addresses_.end();
 	   ++p)
 	{
 	  elfcpp::Swap<32, big_endian>::writeval(pfde,
@@ -206,6 +211,9 @@ Eh_frame_hdr::do_sized_write(Output_file* of)
 	  pfde += 8;
 	}
 
+      Fde_addresses().swap(this->fde_addresses_);
+      this->sorted_chunks_.clear();
+
       gold_assert(pfde - oview == oview_size);
     }
 
@@ -290,17 +298,15 @@ Eh_frame_hdr::get_fde_pc(
   return pc;
 }
 
-// Given an array of FDE offsets in the .eh_frame section, return an
-// array of offsets from the exception frame header to the FDE's
-// output PC and to the output address of the FDE itself.  We get the
-// FDE's PC by actually looking in the .eh_frame section we just wrote
-// to the output file.
+// Set the elements of fde_addresses_ from START up to END to the
+// output address of the PC of the corresponding FDE in fde_offsets_
+// and to the output address of the FDE itself.  We get the FDE's PC
+// by actually looking in the .eh_frame section we just wrote to the
+// output file.
 
 template<int size, bool big_endian>
 void
-Eh_frame_hdr::get_fde_addresses(Output_file* of,
-				const Fde_offsets* fde_offsets,
-				Fde_addresses<size>* fde_addresses)
+Eh_frame_hdr::get_fde_addresses(Output_file* of, size_t start, size_t end)
 {
   typename elfcpp::Elf_types<size>::Elf_Addr eh_frame_address;
   eh_frame_address = this->eh_frame_section_->address();
@@ -309,20 +315,159 @@ Eh_frame_hdr::get_fde_addresses(Output_file* of,
   const unsigned char* eh_frame_contents = of->get_input_view(eh_frame_offset,
 							      eh_frame_size);
 
-  for (Fde_offsets::const_iterator p = fde_offsets->begin();
-       p != fde_offsets->end();
-       ++p)
+  gold_assert(end <= this->fde_offsets_.size()
+	      && end <= this->fde_addresses_.size());
+  for (size_t i = start; i < end; ++i)
     {
+      const Fde_offset& fo(this->fde_offsets_[i]);
       typename elfcpp::Elf_types<size>::Elf_Addr fde_pc;
       fde_pc = this->get_fde_pc<size, big_endian>(eh_frame_address,
 						  eh_frame_contents,
-						  p->first, p->second);
-      fde_addresses->push_back(fde_pc, eh_frame_address + p->first);
+						  fo.first, fo.second);
+      this->fde_addresses_[i] = std::make_pair(fde_pc,
+					       eh_frame_address + fo.first);
     }
 
   of->free_input_view(eh_frame_offset, eh_frame_size, eh_frame_contents);
 }
 
+// Look up the PCs of the FDEs from START up to END, and sort that part
+// of the list.
+
+void
+Eh_frame_hdr::sort_fde_chunk(Output_file* of, size_t start, size_t end)
+{
+  switch (parameters->size_and_endianness())
+    {
+#ifdef HAVE_TARGET_32_LITTLE
+    case Parameters::TARGET_32_LITTLE:
+      this->get_fde_addresses<32, false>(of, start, end);
+      break;
+#endif
+#ifdef HAVE_TARGET_32_BIG
+    case Parameters::TARGET_32_BIG:
+      this->get_fde_addresses<32, true>(of, start, end);
+      break;
+#endif
+#ifdef HAVE_TARGET_64_LITTLE
+    case Parameters::TARGET_64_LITTLE:
+      this->get_fde_addresses<64, false>(of, start, end);
+      break;
+#endif
+#ifdef HAVE_TARGET_64_BIG
+    case Parameters::TARGET_64_BIG:
+      this->get_fde_addresses<64, true>(of, start, end);
+      break;
+#endif
+    default:
+      gold_unreachable();
+    }
+
+  std::sort(this->fde_addresses_.begin() + start,
+	    this->fde_addresses_.begin() + end,
+	    Fde_address_compare());
+}
+
+// An Eh_frame_hdr_sort_task finds the PCs for a chunk of the FDEs and
+// sorts them.
+
+class Eh_frame_hdr_sort_task : public Task
+{
+ public:
+  Eh_frame_hdr_sort_task(Eh_frame_hdr* eh_frame_hdr, Output_file* of,
+			 size_t start, size_t end, Task_token* sorted_blocker)
+    : eh_frame_hdr_(eh_frame_hdr), of_(of), start_(start), end_(end),
+      sorted_blocker_(sorted_blocker)
+  { }
+
+  void
+  run(Workqueue*)
+  { this->eh_frame_hdr_->sort_fde_chunk(this->of_, this->start_, this->end_); }
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  // Unblock SORTED_BLOCKER_ when done.
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->sorted_blocker_); }
+
+  std::string
+  get_name() const
+  { return "Eh_frame_hdr_sort_task"; }
+
+ private:
+  Eh_frame_hdr* eh_frame_hdr_;
+  Output_file* of_;
+  const size_t start_;
+  const size_t end_;
+  Task_token* const sorted_blocker_;
+};
+
+// Queue the tasks to find the FDE PCs and sort them in chunks.  If
+// there are too few FDEs to be worth splitting up, we don't queue
+// anything, and do_write does all the work.
+
+void
+Eh_frame_hdr::queue_sort_tasks(Workqueue* workqueue, Output_file* of,
+			       Task_token* sorted_blocker)
+{
+  const size_t fde_count = this->fde_offsets_.size();
+  if (this->any_unrecognized_eh_frame_sections_
+      || fde_count <= fde_sort_chunk_size)
+    return;
+
+  gold_assert(this->sorted_chunks_.empty());
+  this->fde_addresses_.resize(fde_count);
+  for (size_t start = 0; start < fde_count; start += fde_sort_chunk_size)
+    this->sorted_chunks_.push_back(start);
+
+  // Add all the blockers before queuing any task, since a task may
+  // run and unblock the token as soon as it is queued.
+  sorted_blocker->add_blockers(this->sorted_chunks_.size());
+  for (size_t i = 0; i < this->sorted_chunks_.size(); ++i)
+    {
+      size_t start = this->sorted_chunks_[i];
+      size_t end = std::min(start + fde_sort_chunk_size, fde_count);
+      workqueue->queue(new Eh_frame_hdr_sort_task(this, of, start, end,
+						   sorted_blocker));
+    }
+}
+
+// Sort fde_addresses_.  If the list was sorted in chunks, merge
+// adjacent pairs of chunks until there is only one left.
+
+void
+Eh_frame_hdr::sort_fde_addresses()
+{
+  Fde_addresses::iterator begin = this->fde_addresses_.begin();
+  const size_t fde_count = this->fde_addresses_.size();
+
+  if (this->sorted_chunks_.empty())
+    {
+      std::sort(begin, this->fde_addresses_.end(), Fde_address_compare());
+      return;
+    }
+
+  std::vector<size_t> chunks(this->sorted_chunks_);
+  while (chunks.size() > 1)
+    {
+      std::vector<size_t> merged;
+      for (size_t i = 0; i < chunks.size(); i += 2)
+	{
+	  merged.push_back(chunks[i]);
+	  if (i + 1 < chunks.size())
+	    {
+	      size_t end = i + 2 < chunks.size() ? chunks[i + 2] : fde_count;
+	      std::inplace_merge(begin + chunks[i], begin + chunks[i + 1],
+				 begin + end, Fde_address_compare());
+	    }
+	}
+      chunks.swap(merged);
+    }
+}
+
 // Class Fde.
 
 bool
@@ -549,6 +694,53 @@ operator<(const Cie& cie1, const Cie& cie2)
   return cie1.contents_ < cie2.contents_;
 }
 
+// Class Parsed_eh_frame_section.
+
+// Add a CIE.  Return its index.
+
+unsigned int
+Parsed_eh_frame_section::add_cie(section_offset_type offset,
+				 section_size_type length,
+				 unsigned char fde_encoding, bool mergeable,
+				 const char* personality_name)
+{
+  unsigned int cie_index = this->cies_.size();
+  Cie_info ci;
+  ci.fde_encoding = fde_encoding;
+  ci.mergeable = mergeable;
+  ci.personality_name = personality_name;
+  this->cies_.push_back(ci);
+
+  Entry e;
+  e.offset = offset;
+  e.length = length;
+  e.cie_index = cie_index;
+  e.is_cie = true;
+  e.is_discarded = false;
+  e.fde_shndx = 0;
+  this->entries_.push_back(e);
+
+  return cie_index;
+}
+
+// Add an FDE.
+
+void
+Parsed_eh_frame_section::add_fde(section_offset_type offset,
+				 section_size_type length,
+				 unsigned int cie_index, bool is_discarded,
+				 unsigned int fde_shndx)
+{
+  Entry e;
+  e.offset = offset;
+  e.length = length;
+  e.cie_index = cie_index;
+  e.is_cie = false;
+  e.is_discarded = is_discarded;
+  e.fde_shndx = fde_shndx;
+  this->entries_.push_back(e);
+}
+
 // Class Eh_frame.
 
 Eh_frame::Eh_frame()
@@ -579,20 +771,19 @@ Eh_frame::skip_leb128(const unsigned char** pp, const unsigned char* pend)
   return false;
 }
 
-// Add input section SHNDX in OBJECT to an exception frame section.
-// SYMBOLS is the contents of the symbol table section (size
-// SYMBOLS_SIZE), SYMBOL_NAMES is the symbol names section (size
-// SYMBOL_NAMES_SIZE).  RELOC_SHNDX is the index of a relocation
-// section applying to SHNDX, or 0 if none, or -1U if more than one.
-// RELOC_TYPE is the type of the reloc section if there is one, either
-// SHT_REL or SHT_RELA.  We try to parse the input exception frame
-// data into our data structures.  If we can't do it, we return false
-// to mean that the section should be handled as a normal input
-// section.
+// Parse input section SHNDX in OBJECT.  SYMBOLS is the contents of
+// the symbol table section (size SYMBOLS_SIZE), SYMBOL_NAMES is the
+// symbol names section (size SYMBOL_NAMES_SIZE).  RELOC_SHNDX is the
+// index of a relocation section applying to SHNDX, or 0 if none, or
+// -1U if more than one.  RELOC_TYPE is the type of the reloc section
+// if there is one, either SHT_REL or SHT_RELA.  We try to parse the
+// input exception frame data into PARSED.  If we can't do it, we
+// return EH_UNRECOGNIZED_SECTION to mean that the section should be
+// handled as a normal input section.
 
 template<int size, bool big_endian>
 Eh_frame::Eh_frame_section_disposition
-Eh_frame::add_ehframe_input_section(
+Eh_frame::parse_ehframe_input_section(
     Sized_relobj_file<size, big_endian>* object,
     const unsigned char* symbols,
     section_size_type symbols_size,
@@ -600,44 +791,189 @@ Eh_frame::add_ehframe_input_section(
     section_size_type symbol_names_size,
     unsigned int shndx,
     unsigned int reloc_shndx,
-    unsigned int reloc_type)
+    unsigned int reloc_type,
+    Parsed_eh_frame_section* parsed)
 {
+  Eh_frame_section_disposition disp;
+
   // Get the section contents.
   section_size_type contents_len;
   const unsigned char* pcontents = object->section_contents(shndx,
 							    &contents_len,
 							    false);
   if (contents_len == 0)
-    return EH_EMPTY_SECTION;
+    disp = EH_EMPTY_SECTION;
 
   // If this is the marker section for the end of the data, then
   // return false to force it to be handled as an ordinary input
   // section.  If we don't do this, we won't correctly handle the case
   // of unrecognized .eh_frame sections.
-  if (contents_len == 4
-      && elfcpp::Swap<32, big_endian>::readval(pcontents) == 0)
-    return EH_END_MARKER_SECTION;
+  else if (contents_len == 4
+	   && elfcpp::Swap<32, big_endian>::readval(pcontents) == 0)
+    disp = EH_END_MARKER_SECTION;
+
+  else if (!Eh_frame::do_parse_ehframe_input_section(object, symbols,
+						     symbols_size,
+						     symbol_names,
+						     symbol_names_size,
+						     reloc_shndx, reloc_type,
+						     pcontents, contents_len,
+						     parsed))
+    {
+      parsed->clear();
+      disp = EH_UNRECOGNIZED_SECTION;
+    }
 
-  New_cies new_cies;
-  if (!this->do_add_ehframe_input_section(object, symbols, symbols_size,
-					  symbol_names, symbol_names_size,
-					  shndx, reloc_shndx,
-					  reloc_type, pcontents,
-					  contents_len, &new_cies))
+  else
+    disp = EH_OPTIMIZABLE_SECTION;
+
+  parsed->set_disposition(disp);
+  return disp;
+}
+
+// Add input section SHNDX in OBJECT to an exception frame section.
+// The arguments are as for parse_ehframe_input_section.  PARSED is
+// the section as parsed while reading symbols, or NULL if it was not
+// parsed then.
+
+template<int size, bool big_endian>
+Eh_frame::Eh_frame_section_disposition
+Eh_frame::add_ehframe_input_section(
+    Sized_relobj_file<size, big_endian>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    const Parsed_eh_frame_section* parsed)
+{
+  Parsed_eh_frame_section local_parsed;
+  if (parsed == NULL)
+    {
+      Eh_frame::parse_ehframe_input_section(object, symbols, symbols_size,
+					    symbol_names, symbol_names_size,
+					    shndx, reloc_shndx, reloc_type,
+					    &local_parsed);
+      parsed = &local_parsed;
+    }
+
+  Eh_frame_section_disposition disp =
+    static_cast<Eh_frame_section_disposition>(parsed->disposition());
+  if (disp == EH_UNRECOGNIZED_SECTION)
     {
       if (this->eh_frame_hdr_ != NULL)
 	this->eh_frame_hdr_->found_unrecognized_eh_frame_section();
+    }
+  else if (disp == EH_OPTIMIZABLE_SECTION)
+    {
+      section_size_type contents_len;
+      const unsigned char* pcontents = object->section_contents(shndx,
+								&contents_len,
+								false);
+      this->add_parsed_ehframe_input_section(object, shndx, pcontents,
+					     parsed);
+    }
 
-      for (New_cies::iterator p = new_cies.begin();
-	   p != new_cies.end();
-	   ++p)
-	delete p->first;
+  return disp;
+}
+
+// Merge the CIEs and FDEs from PARSED, which describes input section
+// SHNDX in OBJECT with contents PCONTENTS, into our data structures.
+// This is where we discard duplicate CIEs, and FDEs for discarded
+// code.
+
+template<int size, bool big_endian>
+void
+Eh_frame::add_parsed_ehframe_input_section(
+    Sized_relobj_file<size, big_endian>* object,
+    unsigned int shndx,
+    const unsigned char* pcontents,
+    const Parsed_eh_frame_section* parsed)
+{
+  const Parsed_eh_frame_section::Cie_infos& cie_infos(parsed->cies());
+  const Parsed_eh_frame_section::Entries& entries(parsed->entries());
+
+  // The CIE used for each CIE in the input section.
+  std::vector<Cie*> cie_pointers(cie_infos.size(), NULL);
+
+  // The CIEs we have not seen before.
+  New_cies new_cies;
+
+  for (Parsed_eh_frame_section::Entries::const_iterator pe = entries.begin();
+       pe != entries.end();
+       ++pe)
+    {
+      const unsigned char* pdata = pcontents + pe->offset;
+
+      if (pe->is_cie)
+	{
+	  const Parsed_eh_frame_section::Cie_info& ci(cie_infos[pe->cie_index]);
+	  Cie cie(object, shndx, pe->offset - 8, ci.fde_encoding,
+		  ci.personality_name.c_str(), pdata, pe->length);
+	  Cie* cie_pointer = NULL;
+	  if (ci.mergeable)
+	    {
+	      Cie_offsets::iterator find_cie = this->cie_offsets_.find(&cie);
+	      if (find_cie != this->cie_offsets_.end())
+		cie_pointer = *find_cie;
+	      else
+		{
+		  // See if we already saw this CIE in this object file.
+		  for (New_cies::const_iterator pc = new_cies.begin();
+		       pc != new_cies.end();
+		       ++pc)
+		    {
+		      if (*(pc->first) == cie)
+			{
+			  cie_pointer = pc->first;
+			  break;
+			}
+		    }
+		}
+	    }
 
-      return EH_UNRECOGNIZED_SECTION;
+	  if (cie_pointer == NULL)
+	    {
+	      cie_pointer = new Cie(cie);
+	      new_cies.push_back(std::make_pair(cie_pointer, ci.mergeable));
+	    }
+	  else
+	    {
+	      // We are deleting this CIE.  Record that in our mapping
+	      // from input sections to the output section.  At this
+	      // point we don't know for sure that we are doing a
+	      // special mapping for this input section, but that's
+	      // OK--if we don't do a special mapping, nobody will ever
+	      // ask for the mapping we add here.
+	      object->add_merge_mapping(this, shndx, pe->offset - 8,
+					pe->length + 8, -1);
+	    }
+
+	  cie_pointers[pe->cie_index] = cie_pointer;
+	}
+      else
+	{
+	  // If we have discarded the section holding the code for this
+	  // FDE, we can also discard the FDE.
+	  bool is_discarded = (pe->is_discarded
+			       || (pe->fde_shndx != 0
+				   && !object->is_section_included(pe->fde_shndx)));
+	  if (is_discarded)
+	    object->add_merge_mapping(this, shndx, pe->offset - 8,
+				      pe->length + 8, -1);
+	  else
+	    {
+	      Cie* cie = cie_pointers[pe->cie_index];
+	      gold_assert(cie != NULL);
+	      cie->add_fde(new Fde(object, shndx, pe->offset - 8, pdata,
+				   pe->length));
+	    }
+	}
     }
 
-  // Now that we know we are using this section, record any new CIEs
-  // that we found.
+  // Record any new CIEs that we found.
   for (New_cies::const_iterator p = new_cies.begin();
        p != new_cies.end();
        ++p)
@@ -647,26 +983,23 @@ Eh_frame::add_ehframe_input_section(
       else
 	this->unmergeable_cie_offsets_.push_back(p->first);
     }
-
-  return EH_OPTIMIZABLE_SECTION;
 }
 
-// The bulk of the implementation of add_ehframe_input_section.
+// The bulk of the implementation of parse_ehframe_input_section.
 
 template<int size, bool big_endian>
 bool
-Eh_frame::do_add_ehframe_input_section(
+Eh_frame::do_parse_ehframe_input_section(
     Sized_relobj_file<size, big_endian>* object,
     const unsigned char* symbols,
     section_size_type symbols_size,
     const unsigned char* symbol_names,
     section_size_type symbol_names_size,
-    unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type,
     const unsigned char* pcontents,
     section_size_type contents_len,
-    New_cies* new_cies)
+    Parsed_eh_frame_section* parsed)
 {
   Track_relocs<size, big_endian> relocs;
 
@@ -718,17 +1051,18 @@ Eh_frame::do_add_ehframe_input_section(
       if (id == 0)
 	{
 	  // CIE.
-	  if (!this->read_cie(object, shndx, symbols, symbols_size,
-			      symbol_names, symbol_names_size,
-			      pcontents, p, pentend, &relocs, &cies,
-			      new_cies))
+	  if (!Eh_frame::read_cie(object, symbols, symbols_size,
+				  symbol_names, symbol_names_size,
+				  pcontents, p, pentend, &relocs, &cies,
+				  parsed))
 	    return false;
 	}
       else
 	{
 	  // FDE.
-	  if (!this->read_fde(object, shndx, symbols, symbols_size,
-			      pcontents, id, p, pentend, &relocs, &cies))
+	  if (!Eh_frame::read_fde(object, symbols, symbols_size,
+				  pcontents, id, p, pentend, &relocs, &cies,
+				  parsed))
 	    return false;
 	}
 
@@ -743,7 +1077,6 @@ Eh_frame::do_add_ehframe_input_section(
 template<int size, bool big_endian>
 bool
 Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
-		   unsigned int shndx,
 		   const unsigned char* symbols,
 		   section_size_type symbols_size,
 		   const unsigned char* symbol_names,
@@ -753,7 +1086,7 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
 		   const unsigned char* pcieend,
 		   Track_relocs<size, big_endian>* relocs,
 		   Offsets_to_cie* cies,
-		   New_cies* new_cies)
+		   Parsed_eh_frame_section* parsed)
 {
   bool mergeable = true;
 
@@ -946,48 +1279,13 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
   if (relocs->advance(pcieend - pcontents) > 0)
     return false;
 
-  Cie cie(object, shndx, (pcie - 8) - pcontents, fde_encoding, 
-	  personality_name, pcie, pcieend - pcie);
-  Cie* cie_pointer = NULL;
-  if (mergeable)
-    {
-      Cie_offsets::iterator find_cie = this->cie_offsets_.find(&cie);
-      if (find_cie != this->cie_offsets_.end())
-	cie_pointer = *find_cie;
-      else
-	{
-	  // See if we already saw this CIE in this object file.
-	  for (New_cies::const_iterator pc = new_cies->begin();
-	       pc != new_cies->end();
-	       ++pc)
-	    {
-	      if (*(pc->first) == cie)
-		{
-		  cie_pointer = pc->first;
-		  break;
-		}
-	    }
-	}
-    }
-
-  if (cie_pointer == NULL)
-    {
-      cie_pointer = new Cie(cie);
-      new_cies->push_back(std::make_pair(cie_pointer, mergeable));
-    }
-  else
-    {
-      // We are deleting this CIE.  Record that in our mapping from
-      // input sections to the output section.  At this point we don't
-      // know for sure that we are doing a special mapping for this
-      // input section, but that's OK--if we don't do a special
-      // mapping, nobody will ever ask for the mapping we add here.
-      object->add_merge_mapping(this, shndx, (pcie - 8) - pcontents,
-                                pcieend - (pcie - 8), -1);
-    }
-
-  // Record this CIE plus the offset in the input section.
-  cies->insert(std::make_pair(pcie - pcontents, cie_pointer));
+  // Record this CIE plus the offset in the input section.  Whether
+  // it duplicates a CIE we have already seen is decided when the
+  // section is added to the output.
+  unsigned int cie_index = parsed->add_cie(pcie - pcontents, pcieend - pcie,
+					   fde_encoding, mergeable,
+					   personality_name);
+  cies->insert(std::make_pair(pcie - pcontents, cie_index));
 
   return true;
 }
@@ -997,7 +1295,6 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
 template<int size, bool big_endian>
 bool
 Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
-		   unsigned int shndx,
 		   const unsigned char* symbols,
 		   section_size_type symbols_size,
 		   const unsigned char* pcontents,
@@ -1005,7 +1302,8 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
 		   const unsigned char* pfde,
 		   const unsigned char* pfdeend,
 		   Track_relocs<size, big_endian>* relocs,
-		   Offsets_to_cie* cies)
+		   Offsets_to_cie* cies,
+		   Parsed_eh_frame_section* parsed)
 {
   // OFFSET is the distance between the 4 bytes before PFDE to the
   // start of the CIE.  The offset we recorded for the CIE is 8 bytes
@@ -1014,10 +1312,10 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   Offsets_to_cie::const_iterator pcie = cies->find(cie_offset);
   if (pcie == cies->end())
     return false;
-  Cie* cie = pcie->second;
+  unsigned int cie_index = pcie->second;
 
   int pc_size = 0;
-  switch (cie->fde_encoding() & 7)
+  switch (parsed->cies()[cie_index].fde_encoding & 7)
     {
     case elfcpp::DW_EH_PE_udata2:
       pc_size = 2;
@@ -1070,8 +1368,7 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
 	{
 	  // This FDE applies to a discarded function.  We
 	  // can discard this FDE.
-	  object->add_merge_mapping(this, shndx, (pfde - 8) - pcontents,
-				    pfdeend - (pfde - 8), -1);
+	  parsed->add_fde(pfde - pcontents, pfdeend - pfde, cie_index, true, 0);
 	  return true;
 	}
 
@@ -1089,8 +1386,9 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   // pointer to a PC relative offset when generating a shared library.
   relocs->advance(pfdeend - pcontents);
 
-  // Find the section index for code that this FDE describes.
-  // If we have discarded the section, we can also discard the FDE.
+  // Find the section index for code that this FDE describes.  If
+  // that section is discarded, we can also discard the FDE.  We don't
+  // know yet whether it will be discarded, so just record the index.
   unsigned int fde_shndx;
   const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
   if (symndx >= symbols_size / sym_size)
@@ -1099,10 +1397,10 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   bool is_ordinary;
   fde_shndx = object->adjust_sym_shndx(symndx, sym.get_st_shndx(),
 				       &is_ordinary);
-  bool is_discarded = (is_ordinary
-		       && fde_shndx != elfcpp::SHN_UNDEF
-		       && fde_shndx < object->shnum()
-		       && !object->is_section_included(fde_shndx));
+  if (!is_ordinary
+      || fde_shndx == elfcpp::SHN_UNDEF
+      || fde_shndx >= object->shnum())
+    fde_shndx = 0;
 
   // Fetch the address range field from the FDE. The offset and size
   // of the field depends on the PC encoding given in the CIE, but
@@ -1125,17 +1423,8 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
       gold_unreachable();
     }
 
-  if (is_discarded || address_range == 0)
-    {
-      // This FDE applies to a discarded function.  We
-      // can discard this FDE.
-      object->add_merge_mapping(this, shndx, (pfde - 8) - pcontents,
-                                pfdeend - (pfde - 8), -1);
-      return true;
-    }
-
-  cie->add_fde(new Fde(object, shndx, (pfde - 8) - pcontents,
-		       pfde, pfdeend - pfde));
+  parsed->add_fde(pfde - pcontents, pfdeend - pfde, cie_index,
+		  address_range == 0, fde_shndx);
 
   return true;
 }
@@ -1330,6 +1619,19 @@ Eh_frame::do_sized_write(unsigned char* oview)
 }
 
 #ifdef HAVE_TARGET_32_LITTLE
+template
+Eh_frame::Eh_frame_section_disposition
+Eh_frame::parse_ehframe_input_section<32, false>(
+    Sized_relobj_file<32, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame_section* parsed);
+
 template
 Eh_frame::Eh_frame_section_disposition
 Eh_frame::add_ehframe_input_section<32, false>(
@@ -1340,10 +1642,24 @@ Eh_frame::add_ehframe_input_section<32, false>(
     section_size_type symbol_names_size,
     unsigned int shndx,
     unsigned int reloc_shndx,
-    unsigned int reloc_type);
+    unsigned int reloc_type,
+    const Parsed_eh_frame_section* parsed);
 #endif
 
 #ifdef HAVE_TARGET_32_BIG
+template
+Eh_frame::Eh_frame_section_disposition
+Eh_frame::parse_ehframe_input_section<32, true>(
+    Sized_relobj_file<32, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame_section* parsed);
+
 template
 Eh_frame::Eh_frame_section_disposition
 Eh_frame::add_ehframe_input_section<32, true>(
@@ -1354,10 +1670,24 @@ Eh_frame::add_ehframe_input_section<32, true>(
     section_size_type symbol_names_size,
     unsigned int shndx,
     unsigned int reloc_shndx,
-    unsigned int reloc_type);
+    unsigned int reloc_type,
+    const Parsed_eh_frame_section* parsed);
 #endif
 
 #ifdef HAVE_TARGET_64_LITTLE
+template
+Eh_frame::Eh_frame_section_disposition
+Eh_frame::parse_ehframe_input_section<64, false>(
+    Sized_relobj_file<64, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame_section* parsed);
+
 template
 Eh_frame::Eh_frame_section_disposition
 Eh_frame::add_ehframe_input_section<64, false>(
@@ -1368,10 +1698,24 @@ Eh_frame::add_ehframe_input_section<64, false>(
     section_size_type symbol_names_size,
     unsigned int shndx,
     unsigned int reloc_shndx,
-    unsigned int reloc_type);
+    unsigned int reloc_type,
+    const Parsed_eh_frame_section* parsed);
 #endif
 
 #ifdef HAVE_TARGET_64_BIG
+template
+Eh_frame::Eh_frame_section_disposition
+Eh_frame::parse_ehframe_input_section<64, true>(
+    Sized_relobj_file<64, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Parsed_eh_frame_section* parsed);
+
 template
 Eh_frame::Eh_frame_section_disposition
 Eh_frame::add_ehframe_input_section<64, true>(
@@ -1382,7 +1726,8 @@ Eh_frame::add_ehframe_input_section<64, true>(
     section_size_type symbol_names_size,
     unsigned int shndx,
     unsigned int reloc_shndx,
-    unsigned int reloc_type);
+    unsigned int reloc_type,
+    const Parsed_eh_frame_section* parsed);
 #endif
 
 } // End namespace gold.
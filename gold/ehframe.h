@@ -37,6 +37,8 @@ template<int size, bool big_endian>
 class Track_relocs;
 
 class Eh_frame;
+class Workqueue;
+class Task_token;
 
 // This class manages the .eh_frame_hdr section, which holds the data
 // for the PT_GNU_EH_FRAME segment.  gcc's unwind support code uses
@@ -63,6 +65,20 @@ class Eh_frame_hdr : public Output_section_data
       this->fde_offsets_.push_back(std::make_pair(fde_offset, fde_encoding));
   }
 
+  // Queue tasks which look up the PC of each FDE and sort the FDEs
+  // in chunks, so that the lookup table may be built in parallel.
+  // This must be called after the .eh_frame section has been written
+  // and relocated.  Each task unblocks SORTED_BLOCKER when done.
+  // When do_write is called after those tasks have finished, it only
+  // has to merge the sorted chunks.
+  void
+  queue_sort_tasks(Workqueue*, Output_file*, Task_token* sorted_blocker);
+
+  // Look up the PCs of the FDEs from START up to END, and sort them.
+  // This is called by the tasks queued by queue_sort_tasks.
+  void
+  sort_fde_chunk(Output_file*, size_t start, size_t end);
+
  protected:
   // Set the final data size.
   void
@@ -91,49 +107,25 @@ class Eh_frame_hdr : public Output_section_data
   typedef std::vector<Fde_offset> Fde_offsets;
 
   // When writing out the header, we convert the FDE offsets into FDE
-  // addresses.  This is a list of pairs of the offset from the header
-  // to the FDE PC and to the FDE itself.
-  template<int size>
-  class Fde_addresses
-  {
-   public:
-    typedef typename elfcpp::Elf_types<size>::Elf_Addr Address;
-    typedef typename std::pair<Address, Address> Fde_address;
-    typedef typename std::vector<Fde_address> Fde_address_list;
-    typedef typename Fde_address_list::iterator iterator;
-
-    Fde_addresses(unsigned int reserve)
-      : fde_addresses_()
-    { this->fde_addresses_.reserve(reserve); }
-
-    void
-    push_back(Address pc_address, Address fde_address)
-    {
-      this->fde_addresses_.push_back(std::make_pair(pc_address, fde_address));
-    }
-
-    iterator
-    begin()
-    { return this->fde_addresses_.begin(); }
-
-    iterator
-    end()
-    { return this->fde_addresses_.end(); }
-
-   private:
-    Fde_address_list fde_addresses_;
-  };
+  // addresses.  This is a list of pairs of the address of the FDE PC
+  // and of the FDE itself.  We use 64-bit addresses for all targets
+  // so that the list can be built by tasks which do not know the
+  // target size.
+  typedef std::pair<uint64_t, uint64_t> Fde_address;
+  typedef std::vector<Fde_address> Fde_addresses;
 
   // Compare Fde_address objects.
-  template<int size>
   struct Fde_address_compare
   {
     bool
-    operator()(const typename Fde_addresses<size>::Fde_address& f1,
-	       const typename Fde_addresses<size>::Fde_address& f2) const
+    operator()(const Fde_address& f1, const Fde_address& f2) const
     { return f1.first < f2.first; }
   };
 
+  // The number of FDEs handled by each task queued by
+  // queue_sort_tasks.
+  static const size_t fde_sort_chunk_size = 64 * 1024;
+
   // Return the PC to which an FDE refers.
   template<int size, bool big_endian>
   typename elfcpp::Elf_types<size>::Elf_Addr
@@ -141,12 +133,15 @@ class Eh_frame_hdr : public Output_section_data
 	     const unsigned char* eh_frame_contents,
 	     section_offset_type fde_offset, unsigned char fde_encoding);
 
-  // Convert Fde_offsets to Fde_addresses.
+  // Convert the Fde_offsets from START up to END to Fde_addresses.
   template<int size, bool big_endian>
   void
-  get_fde_addresses(Output_file* of,
-		    const Fde_offsets* fde_offsets,
-		    Fde_addresses<size>* fde_addresses);
+  get_fde_addresses(Output_file* of, size_t start, size_t end);
+
+  // Sort fde_addresses_, merging the chunks sorted by sort_fde_chunk
+  // if there are any.
+  void
+  sort_fde_addresses();
 
   // The .eh_frame section.
   Output_section* eh_frame_section_;
@@ -154,6 +149,12 @@ class Eh_frame_hdr : public Output_section_data
   const Eh_frame* eh_frame_data_;
   // Data from the FDEs in the .eh_frame sections.
   Fde_offsets fde_offsets_;
+  // The FDE addresses, parallel to fde_offsets_.  This is only set
+  // while writing the header.
+  Fde_addresses fde_addresses_;
+  // If queue_sort_tasks split the FDEs into chunks, the start of each
+  // chunk.  Each chunk of fde_addresses_ has been sorted separately.
+  std::vector<size_t> sorted_chunks_;
   // Whether we found any .eh_frame sections which we could not
   // process.
   bool any_unrecognized_eh_frame_sections_;
@@ -364,6 +365,101 @@ class Cie
 extern bool operator<(const Cie&, const Cie&);
 extern bool operator==(const Cie&, const Cie&);
 
+// The result of parsing an input .eh_frame section.  Parsing only
+// looks at the input object, not at any data shared between objects,
+// so it may be done while reading symbols, which runs in parallel for
+// different objects.  The result is later merged into the output by
+// Eh_frame::add_ehframe_input_section.
+
+class Parsed_eh_frame_section
+{
+ public:
+  // Information about a CIE.
+  struct Cie_info
+  {
+    // The encoding of the FDE.
+    unsigned char fde_encoding;
+    // Whether this CIE may be merged with identical CIEs.
+    bool mergeable;
+    // The name of the personality routine, or the empty string.
+    std::string personality_name;
+  };
+
+  // A CIE or FDE in the input section.  These are recorded in the
+  // order in which they appear in the section.
+  struct Entry
+  {
+    // The offset within the input section of the contents of the
+    // entry: the data following the length and the CIE tag or the CIE
+    // offset.
+    section_offset_type offset;
+    // The length of the contents.
+    section_size_type length;
+    // For a CIE, the index of this CIE in the list of CIEs.  For an
+    // FDE, the index of the CIE which it uses.
+    unsigned int cie_index;
+    // Whether this is a CIE.
+    bool is_cie;
+    // For an FDE, whether we already know that the FDE describes
+    // discarded code.
+    bool is_discarded;
+    // For an FDE, the index of the section holding the code which it
+    // describes, if that section may be discarded; otherwise 0.
+    unsigned int fde_shndx;
+  };
+
+  typedef std::vector<Cie_info> Cie_infos;
+  typedef std::vector<Entry> Entries;
+
+  Parsed_eh_frame_section()
+    : disposition_(0), cies_(), entries_()
+  { }
+
+  // The disposition of the section; this is an
+  // Eh_frame::Eh_frame_section_disposition.
+  int
+  disposition() const
+  { return this->disposition_; }
+
+  void
+  set_disposition(int disposition)
+  { this->disposition_ = disposition; }
+
+  // The CIEs in the section.
+  const Cie_infos&
+  cies() const
+  { return this->cies_; }
+
+  // The CIEs and FDEs in the section.
+  const Entries&
+  entries() const
+  { return this->entries_; }
+
+  // Add a CIE.  Return its index.
+  unsigned int
+  add_cie(section_offset_type offset, section_size_type length,
+	  unsigned char fde_encoding, bool mergeable,
+	  const char* personality_name);
+
+  // Add an FDE.
+  void
+  add_fde(section_offset_type offset, section_size_type length,
+	  unsigned int cie_index, bool is_discarded, unsigned int fde_shndx);
+
+  // Discard the entries.
+  void
+  clear()
+  {
+    this->cies_.clear();
+    this->entries_.clear();
+  }
+
+ private:
+  int disposition_;
+  Cie_infos cies_;
+  Entries entries_;
+};
+
 // This class manages .eh_frame sections.  It discards duplicate
 // exception information.
 
@@ -385,13 +481,36 @@ class Eh_frame : public Output_section_data
   set_eh_frame_hdr(Eh_frame_hdr* hdr)
   { this->eh_frame_hdr_ = hdr; }
 
-  // Add the input section SHNDX in OBJECT.  SYMBOLS is the contents
-  // of the symbol table section (size SYMBOLS_SIZE), SYMBOL_NAMES is
-  // the symbol names section (size SYMBOL_NAMES_SIZE).  RELOC_SHNDX
-  // is the relocation section if any (0 for none, -1U for multiple).
-  // RELOC_TYPE is the type of the relocation section if any.  This
-  // returns whether the section was incorporated into the .eh_frame
-  // data.
+  // Return the associated Eh_frame_hdr, or NULL.
+  Eh_frame_hdr*
+  eh_frame_hdr() const
+  { return this->eh_frame_hdr_; }
+
+  // Parse the input section SHNDX in OBJECT into PARSED.  SYMBOLS is
+  // the contents of the symbol table section (size SYMBOLS_SIZE),
+  // SYMBOL_NAMES is the symbol names section (size
+  // SYMBOL_NAMES_SIZE).  RELOC_SHNDX is the relocation section if
+  // any (0 for none, -1U for multiple).  RELOC_TYPE is the type of
+  // the relocation section if any.  This does not look at any shared
+  // data, so it may be called for different objects in parallel.
+  // This returns the disposition of the section, which is also
+  // recorded in PARSED.
+  template<int size, bool big_endian>
+  static Eh_frame_section_disposition
+  parse_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
+			      const unsigned char* symbols,
+			      section_size_type symbols_size,
+			      const unsigned char* symbol_names,
+			      section_size_type symbol_names_size,
+			      unsigned int shndx, unsigned int reloc_shndx,
+			      unsigned int reloc_type,
+			      Parsed_eh_frame_section* parsed);
+
+  // Add the input section SHNDX in OBJECT.  The arguments are as for
+  // parse_ehframe_input_section.  PARSED is the result of parsing the
+  // section while reading symbols, or NULL if the section was not
+  // parsed then, in which case we parse it here.  This returns
+  // whether the section was incorporated into the .eh_frame data.
   template<int size, bool big_endian>
   Eh_frame_section_disposition
   add_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
@@ -400,7 +519,8 @@ class Eh_frame : public Output_section_data
 			    const unsigned char* symbol_names,
 			    section_size_type symbol_names_size,
 			    unsigned int shndx, unsigned int reloc_shndx,
-			    unsigned int reloc_type);
+			    unsigned int reloc_type,
+			    const Parsed_eh_frame_section* parsed);
 
   // Add a CIE and an FDE for a PLT section, to permit unwinding
   // through a PLT.  The FDE data should start with 8 bytes of zero,
@@ -457,9 +577,10 @@ class Eh_frame : public Output_section_data
   // A list of unmergeable CIEs.
   typedef std::vector<Cie*> Unmergeable_cie_offsets;
 
-  // A mapping from offsets to CIEs.  This is used while reading an
-  // input section.
-  typedef std::map<uint64_t, Cie*> Offsets_to_cie;
+  // A mapping from offsets to the index of a CIE in a
+  // Parsed_eh_frame_section.  This is used while reading an input
+  // section.
+  typedef std::map<uint64_t, unsigned int> Offsets_to_cie;
 
   // A list of CIEs, and a bool indicating whether the CIE is
   // mergeable.
@@ -469,26 +590,24 @@ class Eh_frame : public Output_section_data
   static bool
   skip_leb128(const unsigned char**, const unsigned char*);
 
-  // The implementation of add_ehframe_input_section.
+  // The implementation of parse_ehframe_input_section.
   template<int size, bool big_endian>
-  bool
-  do_add_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
-			       const unsigned char* symbols,
-			       section_size_type symbols_size,
-			       const unsigned char* symbol_names,
-			       section_size_type symbol_names_size,
-			       unsigned int shndx,
-			       unsigned int reloc_shndx,
-			       unsigned int reloc_type,
-			       const unsigned char* pcontents,
-			       section_size_type contents_len,
-			       New_cies*);
+  static bool
+  do_parse_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
+				 const unsigned char* symbols,
+				 section_size_type symbols_size,
+				 const unsigned char* symbol_names,
+				 section_size_type symbol_names_size,
+				 unsigned int reloc_shndx,
+				 unsigned int reloc_type,
+				 const unsigned char* pcontents,
+				 section_size_type contents_len,
+				 Parsed_eh_frame_section*);
 
   // Read a CIE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_cie(Sized_relobj_file<size, big_endian>* object,
-	   unsigned int shndx,
 	   const unsigned char* symbols,
 	   section_size_type symbols_size,
 	   const unsigned char* symbol_names,
@@ -498,13 +617,12 @@ class Eh_frame : public Output_section_data
 	   const unsigned char* pcieend,
 	   Track_relocs<size, big_endian>* relocs,
 	   Offsets_to_cie* cies,
-	   New_cies* new_cies);
+	   Parsed_eh_frame_section* parsed);
 
   // Read an FDE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_fde(Sized_relobj_file<size, big_endian>* object,
-	   unsigned int shndx,
 	   const unsigned char* symbols,
 	   section_size_type symbols_size,
 	   const unsigned char* pcontents,
@@ -512,7 +630,18 @@ class Eh_frame : public Output_section_data
 	   const unsigned char* pfde,
 	   const unsigned char* pfdeend,
 	   Track_relocs<size, big_endian>* relocs,
-	   Offsets_to_cie* cies);
+	   Offsets_to_cie* cies,
+	   Parsed_eh_frame_section* parsed);
+
+  // Merge the CIEs and FDEs of a parsed input section into our data
+  // structures.
+  template<int size, bool big_endian>
+  void
+  add_parsed_ehframe_input_section(
+      Sized_relobj_file<size, big_endian>* object,
+      unsigned int shndx,
+      const unsigned char* pcontents,
+      const Parsed_eh_frame_section* parsed);
 
   // Template version of write function.
   template<int size, bool big_endian>
@@ -28,10 +28,6 @@
 #include <fcntl.h>
 #include <unistd.h>
 
-#ifdef HAVE_SYS_MMAN_H
-#include <sys/mman.h>
-#endif
-
 #ifdef HAVE_READV
 #include <sys/uio.h>
 #endif
@@ -48,40 +44,9 @@
 #include "descriptors.h"
 #include "gold-threads.h"
 #include "fileread.h"
-
-// For systems without mmap support.
-#ifndef HAVE_MMAP
-# define mmap gold_mmap
-# define munmap gold_munmap
-# ifndef MAP_FAILED
-#  define MAP_FAILED (reinterpret_cast<void*>(-1))
-# endif
-# ifndef PROT_READ
-#  define PROT_READ 0
-# endif
-# ifndef MAP_PRIVATE
-#  define MAP_PRIVATE 0
-# endif
-
-# ifndef ENOSYS
-#  define ENOSYS EINVAL
-# endif
-
-static void *
-gold_mmap(void *, size_t, int, int, int, off_t)
-{
-  errno = ENOSYS;
-  return MAP_FAILED;
-}
-
-static int
-gold_munmap(void *, size_t)
-{
-  errno = ENOSYS;
-  return -1;
-}
-
-#endif
+#include "memstats.h"
+#include "server.h"
+#include "gold-mmap.h"
 
 #ifndef HAVE_READV
 struct iovec { void* iov_base; size_t iov_len; };
@@ -134,10 +99,14 @@ File_read::View::~View()
     {
     case DATA_ALLOCATED_ARRAY:
       free(const_cast<unsigned char*>(this->data_));
+      Memory_stats::add(Memory_stats::FILE_VIEWS,
+			-static_cast<int64_t>(this->size_));
       break;
     case DATA_MMAPPED:
       if (::munmap(const_cast<unsigned char*>(this->data_), this->size_) != 0)
 	gold_warning(_("munmap failed: %s"), strerror(errno));
+      Memory_stats::add(Memory_stats::FILE_VIEWS,
+			-static_cast<int64_t>(this->size_));
       if (!parameters->options_valid() || parameters->options().stats())
 	{
 	  file_counts_initialize_lock.initialize();
@@ -211,6 +180,26 @@ File_read::open(const Task* task, const std::string& name)
       gold_debug(DEBUG_FILES, "Attempt to open %s succeeded",
 		 this->name_.c_str());
       this->token_.add_writer(task);
+
+      // If a link server started this link, it may already have the
+      // contents of the file in memory.
+      if (link_server != NULL)
+	{
+	  link_server->note_input(this->name_.c_str());
+	  const unsigned char* contents = link_server->find_input(s);
+	  if (contents != NULL)
+	    {
+	      gold_debug(DEBUG_FILES, "Using cached contents of %s",
+			 this->name_.c_str());
+	      release_descriptor(this->descriptor_, true);
+	      this->descriptor_ = -1;
+	      this->is_descriptor_opened_ = false;
+	      this->whole_file_view_ = new View(0, this->size_, contents, 0,
+						false, View::DATA_NOT_OWNED);
+	      this->add_view(this->whole_file_view_);
+	      return true;
+	    }
+	}
     }
 
   return this->descriptor_ >= 0;
@@ -519,6 +508,7 @@ File_read::make_view(off_t start, section_size_type size,
   const unsigned char* pbytes = static_cast<const unsigned char*>(p);
   File_read::View* v = new File_read::View(poff, psize, pbytes, byteshift,
 					   cache, ownership);
+  Memory_stats::add(Memory_stats::FILE_VIEWS, psize);
 
   this->add_view(v);
 
@@ -597,6 +587,7 @@ File_read::find_or_make_view(off_t offset, off_t start,
       File_read::View* shifted_view =
 	  new File_read::View(v->start(), v->size(), pbytes, byteshift,
 			      cache, View::DATA_ALLOCATED_ARRAY);
+      Memory_stats::add(Memory_stats::FILE_VIEWS, v->size());
 
       this->add_view(shifted_view);
       return shifted_view;
@@ -792,7 +783,8 @@ void
 File_read::clear_views(Clear_views_mode mode)
 {
   bool keep_files_mapped = (parameters->options_valid()
-			    && parameters->options().keep_files_mapped());
+			    && parameters->options().keep_files_mapped()
+			    && !parameters->options().no_keep_memory());
   Views::iterator p = this->views_.begin();
   while (p != this->views_.end())
     {
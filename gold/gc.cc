@@ -42,6 +42,8 @@ Garbage_collection::do_transitive_closure()
       this->worklist().pop_back();
       if (!this->referenced_list().insert(entry).second)
         continue;
+      Memory_stats::add(Memory_stats::GC,
+			Memory_stats::node_size(sizeof(Section_id)));
       Garbage_collection::Section_ref::iterator find_it = 
                 this->section_reloc_map().find(entry);
       if (find_it == this->section_reloc_map().end()) 
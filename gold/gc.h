@@ -29,6 +29,7 @@
 #include "symtab.h"
 #include "object.h"
 #include "icf.h"
+#include "memstats.h"
 
 namespace gold
 {
@@ -105,8 +106,14 @@ class Garbage_collection
   {
     Section_id src_id(src_object, src_shndx);
     Section_id dst_id(dst_object, dst_shndx);
+    size_t old_count = this->section_reloc_map_.size();
     Sections_reachable& reachable = this->section_reloc_map_[src_id];
-    reachable.insert(dst_id);
+    if (this->section_reloc_map_.size() != old_count)
+      Memory_stats::add(Memory_stats::GC,
+			Memory_stats::node_size(sizeof(Section_ref::value_type)));
+    if (reachable.insert(dst_id).second)
+      Memory_stats::add(Memory_stats::GC,
+			Memory_stats::node_size(sizeof(Section_id)));
   }
 
  private:
@@ -213,9 +220,12 @@ gc_process_relocs(
       reloc_addend_size_vec = &reloc_info->reloc_addend_size_info;
     }
 
+  // An object with an address-significance table lists the symbols
+  // whose addresses matter itself, so don't guess from its relocations.
   check_section_for_function_pointers =
-    symtab->icf()->check_section_for_function_pointers(src_section_name,
-                                                       target);
+    (!src_obj->has_addrsig()
+     && symtab->icf()->check_section_for_function_pointers(src_section_name,
+                                                           target));
 
   for (size_t i = 0; i < reloc_count; ++i, prelocs += reloc_size)
     {
@@ -22,12 +22,16 @@
 
 #include "gold.h"
 
+#include <climits>
+
 #include "gdb-index.h"
 #include "dwarf_reader.h"
 #include "dwarf.h"
 #include "object.h"
 #include "output.h"
 #include "demangle.h"
+#include "debug.h"
+#include "incremental.h"
 
 namespace gold
 {
@@ -42,6 +46,10 @@ const int gdb_index_tu_size = 24;
 const int gdb_index_addr_size = 16 + gdb_index_offset_size;
 const int gdb_index_sym_size = 2 * gdb_index_offset_size;
 
+// The entry in Gdb_index::base_unit_map_ for a unit of the base index
+// which is not copied.
+const int gdb_index_no_unit = INT_MIN;
+
 // This class manages the hashed symbol table for the .gdb_index section.
 // It is essentially equivalent to the hashtab implementation in libiberty,
 // but is copied into gdb sources and here for compatibility because its
@@ -999,7 +1007,11 @@ Gdb_index::Gdb_index(Output_section* gdb_index_section)
     cu_pool_offset_(0),
     stringpool_offset_(0),
     pubnames_object_(NULL),
-    stmt_list_offset_(-1)
+    stmt_list_offset_(-1),
+    base_index_(),
+    base_index_read_(false),
+    base_index_added_(false),
+    base_unit_map_()
 {
   this->gdb_symtab_ = new Gdb_hashtab<Gdb_symbol>();
 }
@@ -1156,6 +1168,196 @@ Gdb_index::add_symbol(int cu_index, const char* sym_name, uint8_t flags)
     cu_vec->push_back(std::make_pair(cu_index, flags));
 }
 
+// Read the .gdb_index section of the incremental base file IBASE into
+// base_index_.  The section is copied, because its space in the output
+// file may be reused before we are done with it.  We only use an index
+// in the format we write ourselves; otherwise base_index_ is left
+// empty.
+
+void
+Gdb_index::read_base_index(Incremental_binary* ibase)
+{
+  this->base_index_read_ = true;
+
+  const Incremental_binary::Location& loc = ibase->gdb_index_location();
+  if (loc.data_size < gdb_index_hdr_size)
+    return;
+
+  Incremental_binary::View view(ibase->view(loc));
+  const unsigned char* p = view.data();
+  this->base_index_.assign(p, p + loc.data_size);
+
+  // Check the header.  The parts of the index must follow each other
+  // in order, and each must be a whole number of records.
+  off_t size = loc.data_size;
+  uint32_t cu_offset = this->base_header_word(1);
+  uint32_t tu_offset = this->base_header_word(2);
+  uint32_t addr_offset = this->base_header_word(3);
+  uint32_t symtab_offset = this->base_header_word(4);
+  uint32_t pool_offset = this->base_header_word(5);
+  if (this->base_header_word(0) != static_cast<uint32_t>(gdb_index_version)
+      || cu_offset < static_cast<uint32_t>(gdb_index_hdr_size)
+      || tu_offset < cu_offset
+      || addr_offset < tu_offset
+      || symtab_offset < addr_offset
+      || pool_offset < symtab_offset
+      || pool_offset > size
+      || (tu_offset - cu_offset) % gdb_index_cu_size != 0
+      || (addr_offset - tu_offset) % gdb_index_tu_size != 0
+      || (symtab_offset - addr_offset) % gdb_index_addr_size != 0
+      || (pool_offset - symtab_offset) % gdb_index_sym_size != 0)
+    {
+      gold_debug(DEBUG_INCREMENTAL, "Ignoring unusable .gdb_index in base");
+      this->base_index_.clear();
+      return;
+    }
+
+  unsigned int cu_count = (tu_offset - cu_offset) / gdb_index_cu_size;
+  unsigned int tu_count = (addr_offset - tu_offset) / gdb_index_tu_size;
+  this->base_unit_map_.assign(cu_count + tu_count, gdb_index_no_unit);
+}
+
+// Return word N of the header of the base index.
+
+uint32_t
+Gdb_index::base_header_word(int n) const
+{
+  return elfcpp::Swap_unaligned<32, false>::readval(
+      &this->base_index_[n * gdb_index_offset_size]);
+}
+
+// Add the units of the base index which lie within [START, END) of
+// the output .debug_info or .debug_types section.  These are the
+// units of an unchanged input file, which has been left where it was
+// in the output file, so the offsets and addresses recorded for them
+// in the base index are still correct.
+
+bool
+Gdb_index::add_units_from_base(Incremental_binary* ibase, bool is_type_unit,
+			       off_t start, off_t end)
+{
+  if (!this->base_index_read_)
+    this->read_base_index(ibase);
+  if (this->base_index_.empty())
+    return false;
+
+  // All the units must be added before the ranges and symbols.
+  gold_assert(!this->base_index_added_);
+
+  const unsigned char* const base = &this->base_index_[0];
+  uint32_t cu_offset = this->base_header_word(1);
+  uint32_t tu_offset = this->base_header_word(2);
+  uint32_t addr_offset = this->base_header_word(3);
+  unsigned int cu_count = (tu_offset - cu_offset) / gdb_index_cu_size;
+
+  if (!is_type_unit)
+    {
+      for (unsigned int i = 0; i < cu_count; ++i)
+	{
+	  const unsigned char* p = base + cu_offset + i * gdb_index_cu_size;
+	  uint64_t off = elfcpp::Swap_unaligned<64, false>::readval(p);
+	  uint64_t len = elfcpp::Swap_unaligned<64, false>::readval(p + 8);
+	  if (off >= static_cast<uint64_t>(start)
+	      && off < static_cast<uint64_t>(end))
+	    this->base_unit_map_[i] = this->add_comp_unit(off, len);
+	}
+    }
+  else
+    {
+      unsigned int tu_count = (addr_offset - tu_offset) / gdb_index_tu_size;
+      for (unsigned int i = 0; i < tu_count; ++i)
+	{
+	  const unsigned char* p = base + tu_offset + i * gdb_index_tu_size;
+	  uint64_t off = elfcpp::Swap_unaligned<64, false>::readval(p);
+	  uint64_t type_off = elfcpp::Swap_unaligned<64, false>::readval(p + 8);
+	  uint64_t sig = elfcpp::Swap_unaligned<64, false>::readval(p + 16);
+	  if (off >= static_cast<uint64_t>(start)
+	      && off < static_cast<uint64_t>(end))
+	    this->base_unit_map_[cu_count + i] =
+		-1 - this->add_type_unit(off, type_off, sig);
+	}
+    }
+
+  return true;
+}
+
+// Add the address ranges and symbols of the base index which belong
+// to the units we copied from it.  The addresses in the base index
+// are absolute, so they are recorded with a section index of 0.
+
+void
+Gdb_index::add_base_ranges_and_symbols()
+{
+  this->base_index_added_ = true;
+
+  const unsigned char* const base = &this->base_index_[0];
+  const off_t size = this->base_index_.size();
+  uint32_t addr_offset = this->base_header_word(3);
+  uint32_t symtab_offset = this->base_header_word(4);
+  uint32_t pool_offset = this->base_header_word(5);
+  const unsigned int unit_count = this->base_unit_map_.size();
+
+  // The address area.  The ranges of a unit are usually together, so
+  // collect each run of them into a single list.
+  Dwarf_range_list* ranges = NULL;
+  int ranges_index = gdb_index_no_unit;
+  for (uint32_t off = addr_offset;
+       off < symtab_offset;
+       off += gdb_index_addr_size)
+    {
+      const unsigned char* p = base + off;
+      uint32_t old_index = elfcpp::Swap_unaligned<32, false>::readval(p + 16);
+      if (old_index >= unit_count
+	  || this->base_unit_map_[old_index] == gdb_index_no_unit)
+	continue;
+      int new_index = this->base_unit_map_[old_index];
+      if (ranges == NULL || new_index != ranges_index)
+	{
+	  ranges = new Dwarf_range_list();
+	  ranges_index = new_index;
+	  this->add_address_range_list(NULL, new_index, ranges);
+	}
+      ranges->add(0, elfcpp::Swap_unaligned<64, false>::readval(p),
+		  elfcpp::Swap_unaligned<64, false>::readval(p + 8));
+    }
+
+  // The symbol table.  Empty slots have a name and CU vector offset
+  // of zero.  Both offsets are relative to the constant pool.
+  for (uint32_t off = symtab_offset;
+       off < pool_offset;
+       off += gdb_index_sym_size)
+    {
+      const unsigned char* p = base + off;
+      uint32_t name_offset = elfcpp::Swap_unaligned<32, false>::readval(p);
+      uint32_t vec_offset = elfcpp::Swap_unaligned<32, false>::readval(p + 4);
+      if (name_offset == 0 && vec_offset == 0)
+	continue;
+
+      off_t name_pos = static_cast<off_t>(pool_offset) + name_offset;
+      off_t vec_pos = static_cast<off_t>(pool_offset) + vec_offset;
+      if (name_pos >= size
+	  || vec_pos + gdb_index_offset_size > size
+	  || memchr(base + name_pos, '\0', size - name_pos) == NULL)
+	continue;
+      const char* name = reinterpret_cast<const char*>(base + name_pos);
+
+      uint32_t count = elfcpp::Swap_unaligned<32, false>::readval(base
+								  + vec_pos);
+      if (count > (size - vec_pos) / gdb_index_offset_size - 1)
+	continue;
+      const unsigned char* pvec = base + vec_pos + gdb_index_offset_size;
+      for (uint32_t j = 0; j < count; ++j, pvec += gdb_index_offset_size)
+	{
+	  uint32_t val = elfcpp::Swap_unaligned<32, false>::readval(pvec);
+	  uint32_t old_index = val & 0xffffff;
+	  if (old_index >= unit_count
+	      || this->base_unit_map_[old_index] == gdb_index_no_unit)
+	    continue;
+	  this->add_symbol(this->base_unit_map_[old_index], name, val >> 24);
+	}
+    }
+}
+
 // Return TRUE if we have already processed the pubnames associated
 // with the statement list at the given OFFSET.
 
@@ -1182,6 +1384,10 @@ Gdb_index::set_pubnames_read(const Relobj* object, off_t offset)
 void
 Gdb_index::set_final_data_size()
 {
+  // Add what we kept from the base index in an incremental update.
+  if (!this->base_index_.empty() && !this->base_index_added_)
+    this->add_base_ranges_and_symbols();
+
   // Finalize the string pool.
   this->stringpool_.set_string_offsets();
 
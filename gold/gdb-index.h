@@ -44,6 +44,7 @@ template <typename T>
 class Gdb_hashtab;
 class Gdb_index_info_reader;
 class Dwarf_pubnames_table;
+class Incremental_binary;
 
 // This class manages the .gdb_index section, which is a fast
 // lookup table for DWARF information used by the gdb debugger.
@@ -94,6 +95,16 @@ class Gdb_index : public Output_section_data
   void
   add_symbol(int cu_index, const char* sym_name, uint8_t flags);
 
+  // In an incremental update, add the compilation units (or type
+  // units, if IS_TYPE_UNIT) of the .gdb_index section of the base
+  // file IBASE that lie at offsets [START, END) of the output
+  // .debug_info (or .debug_types) section.  Their address ranges and
+  // symbols are copied from the old index when the section size is
+  // set.  Return false if the base file has no index we can use.
+  bool
+  add_units_from_base(Incremental_binary* ibase, bool is_type_unit,
+		      off_t start, off_t end);
+
   // Return the offset into the pubnames table for the cu at the given
   // offset.
   off_t
@@ -227,6 +238,19 @@ class Gdb_index : public Output_section_data
   map_pubtable_to_dies(Dwarf_pubnames_table* table,
                        Pubname_offset_map* map);
 
+  // Read the .gdb_index section of the incremental base file.
+  void
+  read_base_index(Incremental_binary* ibase);
+
+  // Return word N of the header of the base index.
+  uint32_t
+  base_header_word(int n) const;
+
+  // Add the address ranges and symbols of the units copied from the
+  // base index.
+  void
+  add_base_ranges_and_symbols();
+
   // Tables to store the pubnames section of the current object.
   Dwarf_pubnames_table* pubnames_table_;
   Dwarf_pubnames_table* pubtypes_table_;
@@ -257,6 +281,16 @@ class Gdb_index : public Output_section_data
   // last read pubnames and pubtypes sections.
   const Relobj* pubnames_object_;
   off_t stmt_list_offset_;
+  // A copy of the .gdb_index section of the incremental base file.
+  // This is empty if there is no such section or we can not use it.
+  std::vector<unsigned char> base_index_;
+  // Whether we have tried to read base_index_.
+  bool base_index_read_;
+  // Whether the ranges and symbols of the base index have been added.
+  bool base_index_added_;
+  // Map from a unit index in the base index, with the TUs following
+  // the CUs, to the index of the same unit in this one.
+  std::vector<int> base_unit_map_;
 };
 
 } // End namespace gold.
@@ -46,6 +46,7 @@
 #include "icf.h"
 #include "incremental.h"
 #include "timer.h"
+#include "memstats.h"
 
 namespace gold
 {
@@ -490,7 +491,10 @@ queue_middle_tasks(const General_options& options,
 {
   Timer* timer = parameters->timer();
   if (timer != NULL)
-    timer->stamp(0);
+    {
+      timer->stamp(0);
+      Memory_stats::stamp(0);
+    }
 
   // We have to support the case of not seeing any input objects, and
   // generate an empty file.  Existing builds depend on being able to
@@ -740,6 +744,13 @@ queue_middle_tasks(const General_options& options,
       // Doing that is more complex, since we may later decide to discard
       // some of the sections, and thus change our minds about the types
       // of references made to the symbols.
+      //
+      // The Read_relocs tasks run in parallel, but each one queues a
+      // Scan_relocs task which waits for the scan of the previous
+      // object.  The target scan code allocates GOT and PLT entries,
+      // dynamic relocs and COPY relocs as it sees each reloc, so
+      // scanning the objects one at a time, in input order, makes the
+      // layout of those sections deterministic without any locking.
       for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
 	   p != input_objects->relobj_end();
 	   ++p)
@@ -771,6 +782,44 @@ queue_middle_tasks(const General_options& options,
 	}
     }
 
+  // When using threads, compute the mappings of the merged string
+  // sections in parallel once the relocs have been scanned, rather
+  // than one after the other in Layout::finalize.  This matters for
+  // a relocatable link, which has a merge section for each comdat
+  // group.
+  unsigned int merge_chunks = 0;
+  if (parameters->options().threads() && !parameters->incremental())
+    {
+      layout->collect_merge_sections_to_finalize();
+      merge_chunks = layout->merge_sections_chunk_count();
+    }
+
+  // For --detect-odr-violations, read the line information of the
+  // objects which define the candidate symbols now, one task per
+  // object, rather than in Layout_task_runner.
+  unsigned int odr_objects = 0;
+  if (parameters->options().detect_odr_violations())
+    {
+      symtab->group_odr_locations();
+      odr_objects = symtab->odr_object_count();
+    }
+
+  if (merge_chunks + odr_objects > 0)
+    {
+      Task_token* next_blocker = new Task_token(true);
+      next_blocker->add_blockers(merge_chunks + odr_objects);
+      for (unsigned int i = 0; i < merge_chunks; ++i)
+	workqueue->queue(new Finalize_merge_sections_task(layout, i,
+							  this_blocker,
+							  next_blocker));
+      for (unsigned int i = 0; i < odr_objects; ++i)
+	workqueue->queue(new Read_odr_lines_task(symtab,
+						 symtab->odr_object(i), i,
+						 this_blocker,
+						 next_blocker));
+      this_blocker = next_blocker;
+    }
+
   // When all those tasks are complete, we can start laying out the
   // output file.
   workqueue->queue(new Task_function(new Layout_task_runner(options,
@@ -796,7 +845,10 @@ queue_final_tasks(const General_options& options,
 {
   Timer* timer = parameters->timer();
   if (timer != NULL)
-    timer->stamp(1);
+    {
+      timer->stamp(1);
+      Memory_stats::stamp(1);
+    }
 
   int thread_count = options.thread_count_final();
   if (thread_count == 0)
@@ -821,23 +873,30 @@ queue_final_tasks(const General_options& options,
   Task_token* output_sections_blocker = new Task_token(true);
   output_sections_blocker->add_blocker();
 
+  // The global symbols may have been split into several chunks
+  // which can be written out in parallel.
+  unsigned int symtab_chunks = symtab->write_globals_chunk_count();
+
   // Use a blocker to block the final cleanup task.
   Task_token* final_blocker = new Task_token(true);
-  // Write_symbols_task, Write_sections_task, Write_data_task,
+  // Write_symbols_tasks, Write_sections_task, Write_data_task,
   // Relocate_tasks.
-  final_blocker->add_blockers(3);
+  final_blocker->add_blockers(symtab_chunks);
+  final_blocker->add_blockers(2);
   final_blocker->add_blockers(input_objects->number_of_relobjs());
   if (!any_postprocessing_sections)
     final_blocker->add_blocker();
 
-  // Queue a task to write out the symbol table.
-  workqueue->queue(new Write_symbols_task(layout,
-					  symtab,
-					  input_objects,
-					  layout->sympool(),
-					  layout->dynpool(),
-					  of,
-					  final_blocker));
+  // Queue tasks to write out the symbol table.
+  for (unsigned int i = 0; i < symtab_chunks; ++i)
+    workqueue->queue(new Write_symbols_task(layout,
+					    symtab,
+					    input_objects,
+					    layout->sympool(),
+					    layout->dynpool(),
+					    of,
+					    final_blocker,
+					    i));
 
   // Queue a task to write out the output sections.
   workqueue->queue(new Write_sections_task(layout, of, output_sections_blocker,
@@ -863,9 +922,20 @@ queue_final_tasks(const General_options& options,
   // the output file.
   if (!any_postprocessing_sections)
     {
-      Task* t = new Write_after_input_sections_task(layout, of,
-						    input_sections_blocker,
-						    final_blocker);
+      Task* t;
+      if (parameters->options().threads() && layout->eh_frame_hdr() != NULL)
+	{
+	  // Build the .eh_frame_hdr lookup table in parallel before
+	  // writing it out.
+	  t = new Task_function(new Eh_frame_hdr_task_runner(layout, of,
+							     final_blocker),
+				input_sections_blocker,
+				"Task_function Eh_frame_hdr_task_runner");
+	}
+      else
+	t = new Write_after_input_sections_task(layout, of,
+						input_sections_blocker,
+						final_blocker);
       workqueue->queue(t);
     }
   else
@@ -109,6 +109,15 @@
 // type to determine if a function's pointer is taken or not and only folds
 // functions whose pointers are definitely not taken.
 //
+// An object file may carry an address-significance table (an
+// SHT_LLVM_ADDRSIG section), which lists the symbols whose addresses
+// it uses in a way that matters, such as in a comparison.  Safe
+// folding trusts such a table in place of the relocation heuristics
+// for the relocations of that object, so a function may be folded
+// even if its address is taken, as long as no table lists it and it
+// is not visible to other modules.  If every object in the link has
+// a table, this works on every target.
+//
 // Caveat with safe folding :
 // ------------------------
 //
@@ -147,6 +156,7 @@
 #include "demangle.h"
 #include "elfcpp.h"
 #include "int_encoding.h"
+#include "memstats.h"
 
 namespace gold
 {
@@ -766,6 +776,28 @@ is_function_ctor_or_dtor(const std::string& section_name)
   return false;
 }
 
+// Return an estimate of the memory used by the relocation information
+// in RELOC_INFO_LIST, for --stats.
+
+static size_t
+reloc_info_list_size(const Icf::Reloc_info_list& reloc_info_list)
+{
+  size_t ret = 0;
+  for (Icf::Reloc_info_list::const_iterator p = reloc_info_list.begin();
+       p != reloc_info_list.end();
+       ++p)
+    {
+      const Icf::Reloc_info& ri(p->second);
+      ret += Memory_stats::node_size(sizeof(*p));
+      ret += ri.section_info.capacity() * sizeof(Section_id);
+      ret += ri.symbol_info.capacity() * sizeof(Symbol*);
+      ret += ri.addend_info.capacity() * sizeof(ri.addend_info[0]);
+      ret += ri.offset_info.capacity() * sizeof(uint64_t);
+      ret += ri.reloc_addend_size_info.capacity() * sizeof(unsigned int);
+    }
+  return ret;
+}
+
 // This is the main ICF function called in gold.cc.  This does the
 // initialization and calls match_sections repeatedly (twice by default)
 // which computes the crc checksums and detects identical functions.
@@ -781,6 +813,28 @@ Icf::find_identical_sections(const Input_objects* input_objects,
   std::vector<std::string> section_contents;
   const Target& target = parameters->target();
 
+  // With --icf=safe, record the sections listed in the
+  // address-significance tables.  If every object has one, we know
+  // every section whose address is taken, even if the target cannot
+  // check relocations for function pointers.
+  bool have_all_addrsig = parameters->options().icf_safe_folding();
+  if (parameters->options().icf_safe_folding())
+    {
+      for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
+	   p != input_objects->relobj_end();
+	   ++p)
+	{
+	  if (!(*p)->has_addrsig())
+	    {
+	      have_all_addrsig = false;
+	      continue;
+	    }
+	  const Task* dummy_task = reinterpret_cast<const Task*>(-1);
+	  Task_lock_obj<Object> tl(dummy_task, *p);
+	  (*p)->find_address_significant_sections(symtab);
+	}
+    }
+
   // Decide which sections are possible candidates first.
 
   for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
@@ -808,7 +862,8 @@ Icf::find_identical_sections(const Input_objects* input_objects,
 	  // section name by stripping the section prefix.
 	  if (parameters->options().icf_safe_folding()
               && !is_function_ctor_or_dtor(section_name)
-	      && (!target.can_check_for_function_pointers()
+	      && ((!target.can_check_for_function_pointers()
+		   && !have_all_addrsig)
                   || section_has_function_pointers(*p, i)))
             {
 	      continue;
@@ -878,6 +933,27 @@ Icf::find_identical_sections(const Input_objects* input_objects,
 
     }
 
+  if (parameters->options().stats())
+    {
+      // Count the contents of the sections, which are freed when we
+      // return, as well as what we keep.
+      size_t contents_size = 0;
+      for (std::vector<std::string>::const_iterator p =
+	     section_contents.begin();
+	   p != section_contents.end();
+	   ++p)
+	contents_size += sizeof(*p) + p->capacity();
+      size_t kept_size =
+	(reloc_info_list_size(this->reloc_info_list_)
+	 + this->id_section_.capacity() * sizeof(Section_id)
+	 + (this->section_id_.size()
+	    * Memory_stats::node_size(sizeof(Uniq_secn_id_map::value_type)))
+	 + this->kept_section_id_.capacity() * sizeof(unsigned int));
+      Memory_stats::add(Memory_stats::ICF, kept_size + contents_size);
+      Memory_stats::add(Memory_stats::ICF,
+			-static_cast<int64_t>(contents_size));
+    }
+
   this->icf_ready();
 }
 
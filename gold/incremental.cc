@@ -22,6 +22,7 @@
 
 #include "gold.h"
 
+#include <algorithm>
 #include <set>
 #include <cstdarg>
 #include "libiberty.h"
@@ -559,6 +560,13 @@ Sized_incremental_binary<size, big_endian>::do_init_layout(Layout* layout)
 		 static_cast<long>(shdr.get_sh_size()),
 		 shdr.get_sh_type(), name ? name : "<null>");
       this->section_map_[i] = layout->init_fixed_output_section(name, shdr);
+      // Remember where the old .gdb_index is, so that the entries for
+      // unchanged input files can be copied from it.
+      if (name != NULL
+	  && shdr.get_sh_type() == elfcpp::SHT_PROGBITS
+	  && strcmp(name, ".gdb_index") == 0)
+	this->gdb_index_loc_ = Location(shdr.get_sh_offset(),
+					shdr.get_sh_size());
       pshdr += shdr_size;
     }
 }
@@ -730,14 +738,35 @@ Sized_incremental_binary<size, big_endian>::do_emit_copy_relocs(
     }
 }
 
+// Return the number of chunks into which the global symbols are split
+// for do_apply_incremental_relocs.
+
+template<int size, bool big_endian>
+unsigned int
+Sized_incremental_binary<size, big_endian>::do_incremental_relocs_chunk_count()
+    const
+{
+  Incremental_symtab_reader<big_endian> isymtab(this->symtab_reader());
+  unsigned int nglobals = isymtab.symbol_count();
+  if (nglobals == 0)
+    return 1;
+  return ((nglobals + incremental_relocs_chunk_size - 1)
+	  / incremental_relocs_chunk_size);
+}
+
 // Apply incremental relocations for symbols whose values have changed.
+// We only look at the global symbols in chunk CHUNK.  The chunks are
+// processed by separate tasks, which may run in parallel.  That is
+// safe because each relocation only writes to its own location in the
+// output file.
 
 template<int size, bool big_endian>
 void
 Sized_incremental_binary<size, big_endian>::do_apply_incremental_relocs(
     const Symbol_table* symtab,
     Layout* layout,
-    Output_file* of)
+    Output_file* of,
+    unsigned int chunk)
 {
   typedef typename elfcpp::Elf_types<size>::Elf_Addr Address;
   typedef typename elfcpp::Elf_types<size>::Elf_Swxword Addend;
@@ -746,6 +775,10 @@ Sized_incremental_binary<size, big_endian>::do_apply_incremental_relocs(
   unsigned int nglobals = isymtab.symbol_count();
   const unsigned int incr_reloc_size = irelocs.reloc_size;
 
+  unsigned int first = chunk * incremental_relocs_chunk_size;
+  unsigned int last = std::min(nglobals,
+			       first + incremental_relocs_chunk_size);
+
   Relocate_info<size, big_endian> relinfo;
   relinfo.symtab = symtab;
   relinfo.layout = layout;
@@ -758,7 +791,7 @@ Sized_incremental_binary<size, big_endian>::do_apply_incremental_relocs(
   Sized_target<size, big_endian>* target =
       parameters->sized_target<size, big_endian>();
 
-  for (unsigned int i = 0; i < nglobals; i++)
+  for (unsigned int i = first; i < last; i++)
     {
       const Symbol* gsym = this->global_symbol(i);
 
@@ -2090,15 +2123,20 @@ Sized_relobj_incr<size, big_endian>::do_layout(
 		    signature);
     }
 
-  // When building a .gdb_index section, scan the .debug_info and
-  // .debug_types sections.
+  // When building a .gdb_index section, copy the entries for the
+  // .debug_info and .debug_types sections from the index in the base
+  // file, or scan the sections if there is no such index.
   for (std::vector<unsigned int>::const_iterator p
 	   = debug_info_sections.begin();
        p != debug_info_sections.end();
        ++p)
     {
       unsigned int i = *p;
-      layout->add_to_gdb_index(false, this, NULL, 0, i, 0, 0);
+      off_t start = this->section_offsets()[i];
+      off_t end = (start
+		   + this->input_reader_.get_input_section(i - 1).sh_size);
+      if (!layout->add_base_units_to_gdb_index(false, start, end))
+	layout->add_to_gdb_index(false, this, NULL, 0, i, 0, 0);
     }
   for (std::vector<unsigned int>::const_iterator p
 	   = debug_types_sections.begin();
@@ -2106,7 +2144,11 @@ Sized_relobj_incr<size, big_endian>::do_layout(
        ++p)
     {
       unsigned int i = *p;
-      layout->add_to_gdb_index(true, this, 0, 0, i, 0, 0);
+      off_t start = this->section_offsets()[i];
+      off_t end = (start
+		   + this->input_reader_.get_input_section(i - 1).sh_size);
+      if (!layout->add_base_units_to_gdb_index(true, start, end))
+	layout->add_to_gdb_index(true, this, 0, 0, i, 0, 0);
     }
 }
 
@@ -1342,7 +1342,7 @@ class Incremental_binary
  public:
   Incremental_binary(Output_file* output, Target* /*target*/)
     : input_args_map_(), library_map_(), script_map_(),
-      output_(output)
+      gdb_index_loc_(), output_(output)
   { }
 
   virtual
@@ -1477,11 +1477,19 @@ class Incremental_binary
   emit_copy_relocs(Symbol_table* symtab)
   { this->do_emit_copy_relocs(symtab); }
 
-  // Apply incremental relocations for symbols whose values have changed.
+  // Return the number of chunks into which the global symbols are
+  // split for apply_incremental_relocs.  Each chunk may be handled by
+  // a separate task.
+  unsigned int
+  incremental_relocs_chunk_count() const
+  { return this->do_incremental_relocs_chunk_count(); }
+
+  // Apply incremental relocations for the symbols in chunk CHUNK
+  // whose values have changed.
   void
   apply_incremental_relocs(const Symbol_table* symtab, Layout* layout,
-			   Output_file* of)
-  { this->do_apply_incremental_relocs(symtab, layout, of); }
+			   Output_file* of, unsigned int chunk)
+  { this->do_apply_incremental_relocs(symtab, layout, of, chunk); }
 
   // Functions and types for the elfcpp::Elf_file interface.  This
   // permit us to use Incremental_binary as the File template parameter for
@@ -1535,6 +1543,12 @@ class Incremental_binary
   output_file()
   { return this->output_; }
 
+  // Return the location of the .gdb_index section in the base file.
+  // The data_size is zero if there is no such section.
+  const Location&
+  gdb_index_location() const
+  { return this->gdb_index_loc_; }
+
  protected:
   // Check the .gnu_incremental_inputs section to see whether an incremental
   // build is possible.
@@ -1563,9 +1577,14 @@ class Incremental_binary
   virtual void
   do_emit_copy_relocs(Symbol_table* symtab) = 0;
 
+  // Return the number of chunks for apply_incremental_relocs.
+  virtual unsigned int
+  do_incremental_relocs_chunk_count() const = 0;
+
   // Apply incremental relocations for symbols whose values have changed.
   virtual void
-  do_apply_incremental_relocs(const Symbol_table*, Layout*, Output_file*) = 0;
+  do_apply_incremental_relocs(const Symbol_table*, Layout*, Output_file*,
+			      unsigned int chunk) = 0;
 
   virtual unsigned int
   do_input_file_count() const = 0;
@@ -1579,6 +1598,8 @@ class Incremental_binary
   std::vector<Incremental_library*> library_map_;
   // Map from an input file index to a Script_info.
   std::vector<Script_info*> script_map_;
+  // Location of the .gdb_index section, set by do_init_layout.
+  Location gdb_index_loc_;
 
  private:
   // Edited output file object.
@@ -1697,10 +1718,14 @@ class Sized_incremental_binary : public Incremental_binary
   virtual void
   do_emit_copy_relocs(Symbol_table* symtab);
 
+  // Return the number of chunks for apply_incremental_relocs.
+  virtual unsigned int
+  do_incremental_relocs_chunk_count() const;
+
   // Apply incremental relocations for symbols whose values have changed.
   virtual void
   do_apply_incremental_relocs(const Symbol_table* symtab, Layout* layout,
-			      Output_file* of);
+			      Output_file* of, unsigned int chunk);
 
   // Proxy class for a sized Incremental_input_entry_reader.
 
@@ -1775,6 +1800,10 @@ class Sized_incremental_binary : public Incremental_binary
   };
   typedef std::vector<Copy_reloc> Copy_relocs;
 
+  // The number of global symbols handled by each call to
+  // do_apply_incremental_relocs.
+  static const unsigned int incremental_relocs_chunk_size = 8 * 1024;
+
   bool
   find_incremental_inputs_sections(unsigned int* p_inputs_shndx,
 				   unsigned int* p_symtab_shndx,
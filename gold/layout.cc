@@ -25,12 +25,11 @@
 #include <cerrno>
 #include <cstring>
 #include <algorithm>
-#include <iostream>
-#include <fstream>
 #include <utility>
 #include <fcntl.h>
 #include <fnmatch.h>
 #include <unistd.h>
+#include <sys/stat.h>
 #include "libiberty.h"
 #include "md5.h"
 #include "sha1.h"
@@ -50,13 +49,16 @@
 #include "ehframe.h"
 #include "gdb-index.h"
 #include "compressed_output.h"
+#include "merge.h"
 #include "reduced_debug_output.h"
 #include "object.h"
 #include "reloc.h"
 #include "descriptors.h"
 #include "plugin.h"
 #include "incremental.h"
+#include "call-graph.h"
 #include "layout.h"
+#include "gold-mmap.h"
 
 namespace gold
 {
@@ -86,20 +88,88 @@ Free_list::init(off_t len, bool extend)
 {
   this->list_.push_front(Free_list_node(0, len));
   this->last_remove_ = this->list_.begin();
+  this->buckets_.resize(bucket_count);
+  this->add_to_bucket(this->list_.begin());
   this->extend_ = extend;
   this->length_ = len;
   ++Free_list::num_lists;
   ++Free_list::num_nodes;
 }
 
+// Return the size bucket for a chunk of length LEN.
+
+unsigned int
+Free_list::bucket_index(off_t len)
+{
+  unsigned int b = 0;
+  while (b + 1 < bucket_count && (static_cast<off_t>(1) << (b + 1)) <= len)
+    ++b;
+  return b;
+}
+
+// Add node P to its size bucket.
+
+void
+Free_list::add_to_bucket(Iterator p)
+{
+  bool inserted =
+    this->buckets_[bucket_index(p->end_ - p->start_)].insert(
+	std::make_pair(p->end_, p)).second;
+  gold_assert(inserted);
+}
+
+// Remove node P from its size bucket.
+
+void
+Free_list::remove_from_bucket(Iterator p)
+{
+  this->buckets_[bucket_index(p->end_ - p->start_)].erase(p->end_);
+}
+
+// Remove the range [START, END) from node P.  This is shared by
+// remove and allocate.  Add some fuzz to avoid creating tiny free
+// chunks.
+
+Free_list::Iterator
+Free_list::carve(Iterator p, off_t start, off_t end, off_t fuzz)
+{
+  this->remove_from_bucket(p);
+
+  // Case 1: the indicated region spans the whole node.
+  if (p->start_ + fuzz >= start && p->end_ <= end + fuzz)
+    {
+      bool was_last_remove = p == this->last_remove_;
+      p = this->list_.erase(p);
+      if (was_last_remove)
+	this->last_remove_ = p;
+      return p;
+    }
+
+  // Case 2: remove a chunk from the start of the node.
+  if (p->start_ + fuzz >= start)
+    p->start_ = end;
+  // Case 3: remove a chunk from the end of the node.
+  else if (p->end_ <= end + fuzz)
+    p->end_ = start;
+  // Case 4: remove a chunk from the middle, and split the node into
+  // two.
+  else
+    {
+      Free_list_node newnode(p->start_, start);
+      p->start_ = end;
+      this->add_to_bucket(this->list_.insert(p, newnode));
+      ++Free_list::num_nodes;
+    }
+  this->add_to_bucket(p);
+  return p;
+}
+
 // Remove a chunk from the free list.  Because we start with a single
 // node that covers the entire section, and remove chunks from it one
 // at a time, we do not need to coalesce chunks or handle cases that
 // span more than one free node.  We expect to remove chunks from the
-// free list in order, and we expect to have only a few chunks of free
-// space left (corresponding to files that have changed since the last
-// incremental link), so a simple linear list should provide sufficient
-// performance.
+// free list in order, so we start looking at the node where the last
+// removal left off.
 
 void
 Free_list::remove(off_t start, off_t end)
@@ -111,7 +181,7 @@ Free_list::remove(off_t start, off_t end)
   ++Free_list::num_removes;
 
   Iterator p = this->last_remove_;
-  if (p->start_ > start)
+  if (p == this->list_.end() || p->start_ > start)
     p = this->list_.begin();
 
   for (; p != this->list_.end(); ++p)
@@ -120,26 +190,7 @@ Free_list::remove(off_t start, off_t end)
       // Find a node that wholly contains the indicated region.
       if (p->start_ <= start && p->end_ >= end)
 	{
-	  // Case 1: the indicated region spans the whole node.
-	  // Add some fuzz to avoid creating tiny free chunks.
-	  if (p->start_ + 3 >= start && p->end_ <= end + 3)
-	    p = this->list_.erase(p);
-	  // Case 2: remove a chunk from the start of the node.
-	  else if (p->start_ + 3 >= start)
-	    p->start_ = end;
-	  // Case 3: remove a chunk from the end of the node.
-	  else if (p->end_ <= end + 3)
-	    p->end_ = start;
-	  // Case 4: remove a chunk from the middle, and split
-	  // the node into two.
-	  else
-	    {
-	      Free_list_node newnode(p->start_, start);
-	      p->start_ = end;
-	      this->list_.insert(p, newnode);
-	      ++Free_list::num_nodes;
-	    }
-	  this->last_remove_ = p;
+	  this->last_remove_ = this->carve(p, start, end, 3);
 	  return;
 	}
     }
@@ -153,7 +204,10 @@ Free_list::remove(off_t start, off_t end)
 
 // Allocate a chunk of size LEN from the free list.  Returns -1ULL
 // if a sufficiently large chunk of free space is not found.
-// We use a simple first-fit algorithm.
+// We use a first-fit algorithm: the caller relies on getting the
+// lowest suitable chunk at or above MINOFF.  Rather than walk the
+// whole list, we look for the lowest suitable chunk in each size
+// bucket which may hold LEN bytes, and take the lowest of those.
 
 off_t
 Free_list::allocate(off_t len, uint64_t align, off_t minoff)
@@ -172,37 +226,59 @@ Free_list::allocate(off_t len, uint64_t align, off_t minoff)
   // to keep track of all free chunks.
   const int fuzz = this->min_hole_ > 0 ? 0 : 3;
 
-  for (Iterator p = this->list_.begin(); p != this->list_.end(); ++p)
+  Iterator best = this->list_.end();
+  off_t best_start = 0;
+  for (unsigned int b = bucket_index(len); b < this->buckets_.size(); ++b)
     {
-      ++Free_list::num_allocate_visits;
-      off_t start = p->start_ > minoff ? p->start_ : minoff;
-      start = align_address(start, align);
-      off_t end = start + len;
-      if (end > p->end_ && p->end_ == this->length_ && this->extend_)
-	{
-	  this->length_ = end;
-	  p->end_ = end;
-	}
-      if (end == p->end_ || (end <= p->end_ - this->min_hole_))
+      // A chunk which ends before MINOFF + LEN can not hold the
+      // allocation.
+      const Bucket& bucket(this->buckets_[b]);
+      for (Bucket::const_iterator q = bucket.lower_bound(minoff + len);
+	   q != bucket.end();
+	   ++q)
 	{
-	  if (p->start_ + fuzz >= start && p->end_ <= end + fuzz)
-	    this->list_.erase(p);
-	  else if (p->start_ + fuzz >= start)
-	    p->start_ = end;
-	  else if (p->end_ <= end + fuzz)
-	    p->end_ = start;
-	  else
+	  Iterator p = q->second;
+	  if (best != this->list_.end() && p->start_ >= best_start)
+	    break;
+	  ++Free_list::num_allocate_visits;
+	  off_t start = p->start_ > minoff ? p->start_ : minoff;
+	  start = align_address(start, align);
+	  off_t end = start + len;
+	  if (end == p->end_ || (end <= p->end_ - this->min_hole_))
 	    {
-	      Free_list_node newnode(p->start_, start);
-	      p->start_ = end;
-	      this->list_.insert(p, newnode);
-	      ++Free_list::num_nodes;
+	      best = p;
+	      best_start = start;
+	      break;
 	    }
-	  return start;
 	}
     }
+  if (best != this->list_.end())
+    {
+      this->carve(best, best_start, best_start + len, fuzz);
+      return best_start;
+    }
+
   if (this->extend_)
     {
+      // If the last free chunk runs to the end of the region, grow it
+      // to hold the new chunk.
+      if (!this->list_.empty() && this->list_.back().end_ == this->length_)
+	{
+	  Iterator p = this->list_.end();
+	  --p;
+	  off_t start = p->start_ > minoff ? p->start_ : minoff;
+	  start = align_address(start, align);
+	  off_t end = start + len;
+	  if (end >= p->end_)
+	    {
+	      this->remove_from_bucket(p);
+	      p->end_ = end;
+	      this->add_to_bucket(p);
+	      this->length_ = end;
+	      this->carve(p, start, end, fuzz);
+	      return start;
+	    }
+	}
       off_t start = align_address(this->length_, align);
       this->length_ = start + len;
       return start;
@@ -324,10 +400,41 @@ Layout::Relaxation_debug_check::read_sections(
       info.address = os->is_address_valid() ? os->address() : 0;
       info.data_size = os->is_data_size_valid() ? os->data_size() : -1;
       info.offset = os->is_offset_valid()? os->offset() : -1 ;
+      read_input_sections(os, &info.input_addresses);
       this->section_infos_.push_back(info);
     }
 }
 
+// Record the positions of the input sections of OS in
+// *INPUT_ADDRESSES.  A relaxation pass may reuse the layout of an
+// output section rather than lay out its input sections again, so we
+// check these as well as the output section.
+
+void
+Layout::Relaxation_debug_check::read_input_sections(
+    const Output_section* os,
+    std::vector<uint64_t>* input_addresses)
+{
+  const Output_section::Input_section_list& input_sections(
+    os->input_sections());
+  for (Output_section::Input_section_list::const_iterator p =
+	 input_sections.begin();
+       p != input_sections.end();
+       ++p)
+    {
+      if (p->is_input_section())
+	input_addresses->push_back(p->relobj()->output_section_offset(
+				     p->shndx()));
+      else
+	{
+	  const Output_section_data* posd = p->output_section_data();
+	  input_addresses->push_back(posd->is_address_valid()
+				     ? posd->address()
+				     : 0);
+	}
+    }
+}
+
 // Verify SECTIONS using previously recorded information.
 
 void
@@ -356,17 +463,113 @@ Layout::Relaxation_debug_check::verify_sections(
 	  || data_size != info.data_size
 	  || offset != info.offset)
 	gold_fatal("Section %s changed.\n", os->name());
+
+      std::vector<uint64_t> input_addresses;
+      read_input_sections(os, &input_addresses);
+      if (input_addresses != info.input_addresses)
+	gold_fatal("Input sections of %s changed.\n", os->name());
     }
 }
 
 // Layout_task_runner methods.
 
+// An Apply_incremental_relocs_task applies the incremental relocations
+// for one chunk of the global symbols in the base file of an
+// incremental update.
+
+class Apply_incremental_relocs_task : public Task
+{
+ public:
+  Apply_incremental_relocs_task(Incremental_binary* ibase,
+				const Symbol_table* symtab,
+				Layout* layout,
+				Output_file* of,
+				unsigned int chunk,
+				Task_token* final_blocker)
+    : ibase_(ibase), symtab_(symtab), layout_(layout), of_(of),
+      chunk_(chunk), final_blocker_(final_blocker)
+  { }
+
+  void
+  run(Workqueue*)
+  {
+    this->ibase_->apply_incremental_relocs(this->symtab_, this->layout_,
+					   this->of_, this->chunk_);
+  }
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  // Unblock FINAL_BLOCKER_ when done.
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->final_blocker_); }
+
+  std::string
+  get_name() const
+  { return "Apply_incremental_relocs_task"; }
+
+ private:
+  Incremental_binary* ibase_;
+  const Symbol_table* symtab_;
+  Layout* layout_;
+  Output_file* of_;
+  const unsigned int chunk_;
+  Task_token* const final_blocker_;
+};
+
+// After the incremental relocations have been applied, resize the
+// output file of an incremental update and queue the final tasks.
+
+class Incremental_resize_runner : public Task_function_runner
+{
+ public:
+  Incremental_resize_runner(const General_options& options,
+			    const Input_objects* input_objects,
+			    const Symbol_table* symtab,
+			    Layout* layout,
+			    Output_file* of,
+			    off_t file_size)
+    : options_(options), input_objects_(input_objects), symtab_(symtab),
+      layout_(layout), of_(of), file_size_(file_size)
+  { }
+
+  void
+  run(Workqueue* workqueue, const Task*)
+  {
+    this->of_->resize(this->file_size_);
+    gold::queue_final_tasks(this->options_, this->input_objects_,
+			    this->symtab_, this->layout_, workqueue,
+			    this->of_);
+  }
+
+ private:
+  const General_options& options_;
+  const Input_objects* input_objects_;
+  const Symbol_table* symtab_;
+  Layout* layout_;
+  Output_file* of_;
+  off_t file_size_;
+};
+
 // Lay out the sections.  This is called after all the input objects
 // have been read.
 
 void
 Layout_task_runner::run(Workqueue* workqueue, const Task* task)
 {
+  // If --call-graph-ordering was used, order the executable input
+  // sections.  The Read_relocs tasks have recorded the calls by now.
+  // An order given by a plugin takes precedence.
+  if (Call_graph::is_enabled()
+      && this->layout_->get_section_order_map()->empty())
+    {
+      Call_graph call_graph;
+      call_graph.order_sections(task, this->symtab_, this->layout_,
+				this->input_objects_);
+    }
+
   // See if any of the input definitions violate the One Definition Rule.
   // TODO: if this is too slow, do this as a task, rather than inline.
   this->symtab_->detect_odr_violations(task, this->options_.output_file_name());
@@ -402,11 +605,29 @@ Layout_task_runner::run(Workqueue* workqueue, const Task* task)
       // have changed.  We do this before we resize the file and start
       // writing anything else to it, so that we can read the old
       // incremental information from the file before (possibly)
-      // overwriting it.
+      // overwriting it.  The symbols are split into chunks which are
+      // handled by separate tasks; the last task to finish unblocks
+      // the one which resizes the file and queues the final tasks.
       if (parameters->incremental_update())
-	layout->incremental_base()->apply_incremental_relocs(this->symtab_,
-							     this->layout_,
-							     of);
+	{
+	  Incremental_binary* ibase = layout->incremental_base();
+	  unsigned int chunks = ibase->incremental_relocs_chunk_count();
+	  Task_token* resize_blocker = new Task_token(true);
+	  resize_blocker->add_blockers(chunks);
+	  for (unsigned int i = 0; i < chunks; ++i)
+	    workqueue->queue(new Apply_incremental_relocs_task(ibase,
+							       this->symtab_,
+							       layout, of, i,
+							       resize_blocker));
+	  workqueue->queue(new Task_function(
+	      new Incremental_resize_runner(this->options_,
+					    this->input_objects_,
+					    this->symtab_, layout, of,
+					    file_size),
+	      resize_blocker,
+	      "Task_function Incremental_resize_runner"));
+	  return;
+	}
 
       of->resize(file_size);
     }
@@ -464,6 +685,7 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     have_stabstr_section_(false),
     section_ordering_specified_(false),
     unique_segment_for_sections_specified_(false),
+    relr_data_(NULL),
     incremental_inputs_(NULL),
     record_output_section_data_from_script_(false),
     script_output_section_data_list_(),
@@ -473,6 +695,9 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     section_segment_map_(),
     input_section_position_(),
     input_section_glob_(),
+    input_section_glob_prefixes_(),
+    input_section_glob_prefix_lengths_(),
+    input_section_glob_others_(),
     incremental_base_(NULL),
     free_list_(),
     gnu_properties_()
@@ -663,6 +888,11 @@ Layout::include_section(Sized_relobj_file<size, big_endian>*, const char* name,
 
   elfcpp::Elf_Word sh_type = shdr.get_sh_type();
 
+  // An address-significance table refers to the input symbol table
+  // by index, so it is meaningless in the output, even with -r.
+  if (sh_type == elfcpp::SHT_LLVM_ADDRSIG)
+    return false;
+
   if ((sh_type >= elfcpp::SHT_LOOS && sh_type <= elfcpp::SHT_HIOS)
       || (sh_type >= elfcpp::SHT_LOPROC && sh_type <= elfcpp::SHT_HIPROC))
     return parameters->target().should_include_section(sh_type);
@@ -1435,6 +1665,7 @@ Layout::layout_eh_frame(Sized_relobj_file<size, big_endian>* object,
 			unsigned int shndx,
 			const elfcpp::Shdr<size, big_endian>& shdr,
 			unsigned int reloc_shndx, unsigned int reloc_type,
+			const Parsed_eh_frame_section* parsed,
 			off_t* off)
 {
   const unsigned int unwind_section_type =
@@ -1463,7 +1694,8 @@ Layout::layout_eh_frame(Sized_relobj_file<size, big_endian>* object,
 							     symbol_names_size,
 							     shndx,
 							     reloc_shndx,
-							     reloc_type);
+							     reloc_type,
+							     parsed);
     }
 
   if (disp == Eh_frame::EH_OPTIMIZABLE_SECTION)
@@ -1507,6 +1739,16 @@ Layout::layout_eh_frame(Sized_relobj_file<size, big_endian>* object,
   return os;
 }
 
+// Return the data for the .eh_frame_hdr section, if any.
+
+Eh_frame_hdr*
+Layout::eh_frame_hdr() const
+{
+  if (this->eh_frame_data_ == NULL)
+    return NULL;
+  return this->eh_frame_data_->eh_frame_hdr();
+}
+
 void
 Layout::finalize_eh_frame_section()
 {
@@ -1633,6 +1875,35 @@ Layout::add_to_gdb_index(bool is_type_unit,
 			 unsigned int shndx,
 			 unsigned int reloc_shndx,
 			 unsigned int reloc_type)
+{
+  Gdb_index* gdb_index = this->gdb_index_data();
+  if (gdb_index == NULL)
+    return;
+
+  gdb_index->scan_debug_info(is_type_unit, object, symbols, symbols_size,
+			     shndx, reloc_shndx, reloc_type);
+}
+
+// Copy the units of an unchanged input section from the .gdb_index
+// section of the incremental base file.
+
+bool
+Layout::add_base_units_to_gdb_index(bool is_type_unit, off_t start,
+				    off_t end)
+{
+  gold_assert(this->incremental_base_ != NULL);
+  Gdb_index* gdb_index = this->gdb_index_data();
+  if (gdb_index == NULL)
+    return true;
+
+  return gdb_index->add_units_from_base(this->incremental_base_,
+					is_type_unit, start, end);
+}
+
+// Return the .gdb_index section data, creating it if necessary.
+
+Gdb_index*
+Layout::gdb_index_data()
 {
   if (this->gdb_index_data_ == NULL)
     {
@@ -1641,16 +1912,13 @@ Layout::add_to_gdb_index(bool is_type_unit,
 						       false, ORDER_INVALID,
 						       false, false, false);
       if (os == NULL)
-	return;
+	return NULL;
 
       this->gdb_index_data_ = new Gdb_index(os);
       os->add_output_section_data(this->gdb_index_data_);
       os->set_after_input_sections();
     }
-
-  this->gdb_index_data_->scan_debug_info(is_type_unit, object, symbols,
-					 symbols_size, shndx, reloc_shndx,
-					 reloc_type);
+  return this->gdb_index_data_;
 }
 
 // Add POSD to an output section using NAME, TYPE, and FLAGS.  Return
@@ -1774,6 +2042,16 @@ Layout::make_output_section(const char* name, elfcpp::Elf_Word type,
 
   os->set_order(order);
 
+  // With --hugepage-text, the hot text starts on a huge page and is
+  // padded to fill whole huge pages.
+  if (order == ORDER_TEXT_HOT && parameters->options().hugepage_text())
+    {
+      uint64_t hugepage_size = parameters->options().hugepage_size();
+      if (os->addralign() < hugepage_size)
+	os->set_addralign(hugepage_size);
+      os->set_end_alignment(hugepage_size);
+    }
+
   parameters->target().new_output_section(os);
 
   this->section_list_.push_back(os);
@@ -2515,6 +2793,46 @@ Layout::define_section_symbols(Symbol_table* symtab)
 					true); // only_if_ref
 	}
     }
+
+  // With --hugepage-text, define __hot_start and __hot_end around the
+  // hot text, so that the program can remap it onto huge pages.  The
+  // range is padded to whole huge pages.  If there is no hot text,
+  // the range is empty.
+  if (parameters->options().hugepage_text())
+    {
+      Output_section* os = this->find_output_section(".text.hot");
+      bool is_empty = os == NULL;
+      if (is_empty)
+	os = this->find_output_section(".text");
+      if (os != NULL)
+	{
+	  symtab->define_in_output_data("__hot_start",
+					NULL, // version
+					Symbol_table::PREDEFINED,
+					os,
+					0, // value
+					0, // symsize
+					elfcpp::STT_NOTYPE,
+					elfcpp::STB_GLOBAL,
+					elfcpp::STV_HIDDEN,
+					0, // nonvis
+					false, // offset_is_from_end
+					true); // only_if_ref
+
+	  symtab->define_in_output_data("__hot_end",
+					NULL, // version
+					Symbol_table::PREDEFINED,
+					os,
+					0, // value
+					0, // symsize
+					elfcpp::STT_NOTYPE,
+					elfcpp::STB_GLOBAL,
+					elfcpp::STV_HIDDEN,
+					0, // nonvis
+					!is_empty, // offset_is_from_end
+					true); // only_if_ref
+	}
+    }
 }
 
 // Define symbols for group signatures.
@@ -2881,70 +3199,213 @@ Layout::relaxation_loop_body(
 // Search the list of patterns and find the position of the given section
 // name in the output section.  If the section name matches a glob
 // pattern and a non-glob name, then the non-glob position takes
-// precedence.  Return 0 if no match is found.
+// precedence.  Return 0 if no match is found.  This only reads the
+// tables built by read_layout_from_file, so it may be called by
+// several threads at once.
 
 unsigned int
-Layout::find_section_order_index(const std::string& section_name)
+Layout::find_section_order_index(const std::string& section_name) const
 {
-  Unordered_map<std::string, unsigned int>::iterator map_it;
+  Unordered_map<std::string, unsigned int>::const_iterator map_it;
   map_it = this->input_section_position_.find(section_name);
   if (map_it != this->input_section_position_.end())
     return map_it->second;
 
-  // Absolute match failed.  Linear search the glob patterns.
-  std::vector<std::string>::iterator it;
-  for (it = this->input_section_glob_.begin();
-       it != this->input_section_glob_.end();
-       ++it)
+  // Absolute match failed.  Find the first glob pattern in the file
+  // which matches, only trying the patterns whose literal prefix
+  // matches the section name.
+  unsigned int best = -1U;
+  for (std::vector<size_t>::const_iterator pl =
+	 this->input_section_glob_prefix_lengths_.begin();
+       (pl != this->input_section_glob_prefix_lengths_.end()
+	&& *pl <= section_name.length());
+       ++pl)
     {
-       if (fnmatch((*it).c_str(), section_name.c_str(), FNM_NOESCAPE) == 0)
-	 {
-	   map_it = this->input_section_position_.find(*it);
-	   gold_assert(map_it != this->input_section_position_.end());
-	   return map_it->second;
-	 }
+      Unordered_map<std::string, std::vector<unsigned int> >::const_iterator
+	pp = this->input_section_glob_prefixes_.find(section_name.substr(0,
+									 *pl));
+      if (pp != this->input_section_glob_prefixes_.end())
+	this->match_section_order_glob(pp->second, section_name, &best);
+    }
+  this->match_section_order_glob(this->input_section_glob_others_,
+				 section_name, &best);
+
+  if (best == -1U)
+    return 0;
+  map_it = this->input_section_position_.find(this->input_section_glob_[best]);
+  gold_assert(map_it != this->input_section_position_.end());
+  return map_it->second;
+}
+
+// Set *PBEST to the first index in INDEXES which is smaller than
+// *PBEST and whose glob pattern matches SECTION_NAME.
+
+void
+Layout::match_section_order_glob(const std::vector<unsigned int>& indexes,
+				 const std::string& section_name,
+				 unsigned int* pbest) const
+{
+  for (std::vector<unsigned int>::const_iterator p = indexes.begin();
+       p != indexes.end() && *p < *pbest;
+       ++p)
+    {
+      if (fnmatch(this->input_section_glob_[*p].c_str(),
+		  section_name.c_str(), FNM_NOESCAPE) == 0)
+	{
+	  *pbest = *p;
+	  return;
+	}
     }
-  return 0;
+}
+
+// Record LINE, which is at POSITION in the --section-ordering-file.
+
+void
+Layout::add_section_order_line(const std::string& line, unsigned int position)
+{
+  this->input_section_position_[line] = position;
+  if (!is_wildcard_string(line.c_str()))
+    return;
+
+  // Store all glob patterns in a vector, and index them by the
+  // literal characters they start with.
+  unsigned int index = this->input_section_glob_.size();
+  this->input_section_glob_.push_back(line);
+
+  size_t len = line.find_first_of("?*[");
+  if (len == 0)
+    {
+      this->input_section_glob_others_.push_back(index);
+      return;
+    }
+  this->input_section_glob_prefixes_[line.substr(0, len)].push_back(index);
+  std::vector<size_t>::iterator p =
+    std::lower_bound(this->input_section_glob_prefix_lengths_.begin(),
+		     this->input_section_glob_prefix_lengths_.end(), len);
+  if (p == this->input_section_glob_prefix_lengths_.end() || *p != len)
+    this->input_section_glob_prefix_lengths_.insert(p, len);
 }
 
 // Read the sequence of input sections from the file specified with
-// option --section-ordering-file.
+// option --section-ordering-file.  The file may list millions of
+// sections, so we map it into memory and split it into lines in
+// place.
 
 void
 Layout::read_layout_from_file()
 {
   const char* filename = parameters->options().section_ordering_file();
-  std::ifstream in;
-  std::string line;
 
-  in.open(filename);
-  if (!in)
+  int o = open_descriptor(-1, filename, O_RDONLY);
+  if (o < 0)
     gold_fatal(_("unable to open --section-ordering-file file %s: %s"),
 	       filename, strerror(errno));
 
-  std::getline(in, line);   // this chops off the trailing \n, if any
-  unsigned int position = 1;
-  this->set_section_ordering_specified();
+  const char* contents = NULL;
+  size_t contents_size = 0;
+  void* map = MAP_FAILED;
+  std::string buffer;
 
-  while (in)
+  struct stat st;
+  if (::fstat(o, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
     {
-      if (!line.empty() && line[line.length() - 1] == '\r')   // Windows
-	line.resize(line.length() - 1);
+      map = ::mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, o, 0);
+      if (map != MAP_FAILED)
+	{
+	  contents = static_cast<const char*>(map);
+	  contents_size = st.st_size;
+	}
+    }
+
+  if (map == MAP_FAILED)
+    {
+      // We could not map the file, perhaps because it is a pipe.
+      // Read it instead.
+      char buf[8192];
+      ssize_t len;
+      while ((len = ::read(o, buf, sizeof buf)) > 0)
+	buffer.append(buf, len);
+      if (len < 0)
+	gold_fatal(_("unable to read --section-ordering-file file %s: %s"),
+		   filename, strerror(errno));
+      contents = buffer.data();
+      contents_size = buffer.size();
+    }
+
+  this->set_section_ordering_specified();
+
+  unsigned int position = 1;
+  const char* p = contents;
+  const char* pend = contents + contents_size;
+  std::string line;
+  while (p < pend)
+    {
+      const char* eol = static_cast<const char*>(memchr(p, '\n', pend - p));
+      if (eol == NULL)
+	eol = pend;
+      size_t len = eol - p;
+      if (len > 0 && p[len - 1] == '\r')   // Windows
+	--len;
       // Ignore comments, beginning with '#'
-      if (line[0] == '#')
+      if (len == 0 || p[0] != '#')
 	{
-	  std::getline(in, line);
-	  continue;
+	  line.assign(p, len);
+	  this->add_section_order_line(line, position);
+	  position++;
+	}
+      p = eol + 1;
+    }
+
+  if (map != MAP_FAILED)
+    ::munmap(map, contents_size);
+  release_descriptor(o, true);
+}
+
+// Collect the merged string sections whose mappings may be computed
+// by Finalize_merge_sections_task before finalize.  We skip sections
+// which keep their input sections, as a linker script may still
+// replace them.
+
+void
+Layout::collect_merge_sections_to_finalize()
+{
+  gold_assert(this->merge_sections_to_finalize_.empty());
+  for (Section_list::const_iterator p = this->section_list_.begin();
+       p != this->section_list_.end();
+       ++p)
+    {
+      const Output_section::Input_section_list& input_sections =
+	(*p)->input_sections();
+      for (Output_section::Input_section_list::const_iterator q =
+	     input_sections.begin();
+	   q != input_sections.end();
+	   ++q)
+	{
+	  if (!q->is_merge_section())
+	    continue;
+	  Output_merge_base* pomb = q->output_merge_base();
+	  if (pomb->is_string() && !pomb->keeps_input_sections())
+	    this->merge_sections_to_finalize_.push_back(pomb);
 	}
-      this->input_section_position_[line] = position;
-      // Store all glob patterns in a vector.
-      if (is_wildcard_string(line.c_str()))
-	this->input_section_glob_.push_back(line);
-      position++;
-      std::getline(in, line);
     }
 }
 
+// Compute the mappings of the merged string sections in chunk CHUNK.
+// Each merge section is only in one chunk, and its mappings only
+// change its own data and its own Input_merge_maps.
+
+void
+Layout::finalize_merge_sections(unsigned int chunk)
+{
+  size_t begin = chunk * merge_sections_chunk_size;
+  size_t end = begin + merge_sections_chunk_size;
+  if (end > this->merge_sections_to_finalize_.size())
+    end = this->merge_sections_to_finalize_.size();
+  gold_assert(begin < end);
+  for (size_t i = begin; i < end; ++i)
+    this->merge_sections_to_finalize_[i]->finalize_mappings();
+}
+
 // Finalize the layout.  When this is called, we have created all the
 // output sections and all the output segments which are based on
 // input sections.  We have several things to do, and we have to do
@@ -3064,11 +3525,14 @@ Layout::finalize(const Input_objects* input_objects, Symbol_table* symtab,
   unsigned int shndx;
   int pass = 0;
 
-  // Take a snapshot of the section layout as needed.
-  if (target->may_relax())
+  // Take a snapshot of the section layout as needed.  The size of a
+  // SHT_RELR section depends on the addresses of the words it
+  // relocates, so it may need another layout as well.
+  if (target->may_relax() || this->relr_data_ != NULL)
     this->prepare_for_relaxation();
 
-  // Run the relaxation loop to lay out sections.
+  // Run the relaxation loop to lay out sections.  Once the target is
+  // done, lay them out again if the SHT_RELR section had to grow.
   do
     {
       off = this->relaxation_loop_body(pass, target, symtab, &load_seg,
@@ -3076,8 +3540,9 @@ Layout::finalize(const Input_objects* input_objects, Symbol_table* symtab,
 				       &shndx);
       pass++;
     }
-  while (target->may_relax()
-	 && target->relax(pass, input_objects, symtab, this, task));
+  while ((target->may_relax()
+	  && target->relax(pass, input_objects, symtab, this, task))
+	 || (this->relr_data_ != NULL && this->relr_data_->encode_relocs()));
 
   // If there is a load segment that contains the file and program headers,
   // provide a symbol __ehdr_start pointing there.
@@ -3850,6 +4315,12 @@ Layout::set_segment_offsets(const Target* target, Output_segment* load_seg,
   const bool check_sections = parameters->options().check_sections();
   Output_segment* last_load_segment = NULL;
 
+  uint64_t hugepage_size = 0;
+  if (parameters->options().hugepage_text()
+      && !parameters->options().nmagic()
+      && !parameters->options().omagic())
+    hugepage_size = parameters->options().hugepage_size();
+
   unsigned int shndx_begin = *pshndx;
   unsigned int shndx_load_seg = *pshndx;
 
@@ -3930,6 +4401,25 @@ Layout::set_segment_offsets(const Target* target, Output_segment* load_seg,
 	      && !parameters->options().omagic())
 	    (*p)->set_minimum_p_align(abi_pagesize);
 
+	  // With --hugepage-text the text segment is aligned to a huge
+	  // page, and the segment after it starts on the next huge page,
+	  // so that the text can be remapped onto huge pages without
+	  // taking anything else along.
+	  uint64_t segment_align = (*p)->maximum_alignment();
+	  uint64_t hugepage_align = 0;
+	  if (hugepage_size != 0)
+	    {
+	      if (((*p)->flags() & elfcpp::PF_X) != 0)
+		{
+		  (*p)->set_minimum_p_align(hugepage_size);
+		  segment_align = std::max(segment_align, hugepage_size);
+		  hugepage_align = hugepage_size;
+		}
+	      else if (last_load_segment != NULL
+		       && (last_load_segment->flags() & elfcpp::PF_X) != 0)
+		hugepage_align = hugepage_size;
+	    }
+
 	  if (!are_addresses_set)
 	    {
 	      // Skip the address forward one page, maintaining the same
@@ -3938,7 +4428,8 @@ Layout::set_segment_offsets(const Target* target, Output_segment* load_seg,
 	      // put them on different pages in memory. We will revisit this
 	      // decision once we know the size of the segment.
 
-	      uint64_t max_align = (*p)->maximum_alignment();
+	      uint64_t max_align = std::max((*p)->maximum_alignment(),
+					    hugepage_align);
 	      if (max_align > abi_pagesize)
 		addr = align_address(addr, max_align);
 	      aligned_addr = addr;
@@ -3979,8 +4470,7 @@ Layout::set_segment_offsets(const Target* target, Output_segment* load_seg,
 	      // Here we are also taking care of the case when
 	      // the maximum segment alignment is larger than the page size.
 	      off = align_file_offset(off, addr,
-				      std::max(abi_pagesize,
-					       (*p)->maximum_alignment()));
+				      std::max(abi_pagesize, segment_align));
 	    }
 	  else
 	    {
@@ -4634,6 +5124,8 @@ Layout::create_dynamic_symtab(const Input_objects* input_objects,
   unsigned int local_symcount = index;
   unsigned int forced_local_count = 0;
 
+  if (this->relr_data_ != NULL)
+    pversions->set_needs_relr_version();
   index = symtab->set_dynsym_indexes(index, &forced_local_count,
 				     pdynamic_symbols, &this->dynpool_,
 				     pversions);
@@ -4753,12 +5245,25 @@ Layout::create_dynamic_symtab(const Input_objects* input_objects,
   // built first, because it changes the order of the symbols
   // in the dynamic symbol table.
 
-  if (strcmp(parameters->options().hash_style(), "gnu") == 0
-      || strcmp(parameters->options().hash_style(), "both") == 0)
+  const char* hash_style = parameters->options().hash_style();
+  const bool gnu_hash = (strcmp(hash_style, "gnu") == 0
+			 || strcmp(hash_style, "both") == 0);
+  const bool sysv_hash = (strcmp(hash_style, "sysv") == 0
+			  || strcmp(hash_style, "both") == 0);
+
+  // Compute the hash codes for both tables at once.
+  std::vector<uint32_t> gnu_hashvals;
+  std::vector<uint32_t> elf_hashvals;
+  if (gnu_hash || sysv_hash)
+    Dynobj::compute_hash_values(*pdynamic_symbols,
+				gnu_hash ? &gnu_hashvals : NULL,
+				sysv_hash ? &elf_hashvals : NULL);
+
+  if (gnu_hash)
     {
       unsigned char* phash;
       unsigned int hashlen;
-      Dynobj::create_gnu_hash_table(*pdynamic_symbols,
+      Dynobj::create_gnu_hash_table(*pdynamic_symbols, gnu_hashvals,
 				    local_symcount + forced_local_count,
 				    &phash, &hashlen);
 
@@ -4791,12 +5296,11 @@ Layout::create_dynamic_symtab(const Input_objects* input_objects,
 	}
     }
 
-  if (strcmp(parameters->options().hash_style(), "sysv") == 0
-      || strcmp(parameters->options().hash_style(), "both") == 0)
+  if (sysv_hash)
     {
       unsigned char* phash;
       unsigned int hashlen;
-      Dynobj::create_elf_hash_table(*pdynamic_symbols,
+      Dynobj::create_elf_hash_table(*pdynamic_symbols, elf_hashvals,
 				    local_symcount + forced_local_count,
 				    &phash, &hashlen);
 
@@ -5134,6 +5638,22 @@ Layout::add_target_dynamic_tags(bool use_rel, const Output_data* plt_got,
     }
 }
 
+// Add DT_RELR, DT_RELRSZ and DT_RELRENT for the SHT_RELR section
+// RELR, if it was attached to an output section.
+
+void
+Layout::add_relr_dynamic_tags(Output_data_relr_generic* relr)
+{
+  Output_data_dynamic* odyn = this->dynamic_data_;
+  if (odyn == NULL || relr == NULL || relr->output_section() == NULL)
+    return;
+
+  odyn->add_section_address(elfcpp::DT_RELR, relr->output_section());
+  odyn->add_section_size(elfcpp::DT_RELRSZ, relr->output_section());
+  odyn->add_constant(elfcpp::DT_RELRENT, parameters->target().get_size() / 8);
+  this->relr_data_ = relr;
+}
+
 void
 Layout::add_target_specific_dynamic_tag(elfcpp::DT tag, unsigned int val)
 {
@@ -5973,6 +6493,34 @@ Layout::print_stats() const
     (*p)->print_merge_stats();
 }
 
+// Finalize_merge_sections_task methods.
+
+// We can run after the relocs have been scanned.
+
+Task_token*
+Finalize_merge_sections_task::is_runnable()
+{
+  if (this->this_blocker_->is_blocked())
+    return this->this_blocker_;
+  return NULL;
+}
+
+// We need to unlock NEXT_BLOCKER when finished.
+
+void
+Finalize_merge_sections_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->next_blocker_);
+}
+
+// Run the task.
+
+void
+Finalize_merge_sections_task::run(Workqueue*)
+{
+  this->layout_->finalize_merge_sections(this->chunk_);
+}
+
 // Write_sections_task methods.
 
 // We can always run this task.
@@ -6047,14 +6595,15 @@ Write_symbols_task::locks(Task_locker* tl)
   tl->add(this, this->final_blocker_);
 }
 
-// Run the task--write out the symbols.
+// Run the task--write out one chunk of the symbols.
 
 void
 Write_symbols_task::run(Workqueue*)
 {
   this->symtab_->write_globals(this->sympool_, this->dynpool_,
 			       this->layout_->symtab_xindex(),
-			       this->layout_->dynsym_xindex(), this->of_);
+			       this->layout_->dynsym_xindex(), this->of_,
+			       this->chunk_);
 }
 
 // Write_after_input_sections_task methods.
@@ -6085,6 +6634,26 @@ Write_after_input_sections_task::run(Workqueue*)
   this->layout_->write_sections_after_input_sections(this->of_);
 }
 
+// Eh_frame_hdr_task_runner methods.
+
+// Queue the tasks which sort the .eh_frame_hdr lookup table, and the
+// task which writes the sections which follow the input sections,
+// including .eh_frame_hdr.
+
+void
+Eh_frame_hdr_task_runner::run(Workqueue* workqueue, const Task*)
+{
+  Task_token* sorted_blocker = new Task_token(true);
+  Eh_frame_hdr* eh_frame_hdr = this->layout_->eh_frame_hdr();
+  if (eh_frame_hdr != NULL)
+    eh_frame_hdr->queue_sort_tasks(workqueue, this->of_, sorted_blocker);
+
+  workqueue->queue(new Write_after_input_sections_task(this->layout_,
+						       this->of_,
+						       sorted_blocker,
+						       this->final_blocker_));
+}
+
 // Build IDs can be computed as a "flat" sha1 or md5 of a string of bytes,
 // or as a "tree" where each chunk of the string is hashed and then those
 // hashes are put into a (much smaller) string which is hashed with sha1.
@@ -6335,6 +6904,7 @@ Layout::layout_eh_frame<32, false>(Sized_relobj_file<32, false>* object,
 				   const elfcpp::Shdr<32, false>& shdr,
 				   unsigned int reloc_shndx,
 				   unsigned int reloc_type,
+				   const Parsed_eh_frame_section* parsed,
 				   off_t* off);
 #endif
 
@@ -6350,6 +6920,7 @@ Layout::layout_eh_frame<32, true>(Sized_relobj_file<32, true>* object,
 				  const elfcpp::Shdr<32, true>& shdr,
 				  unsigned int reloc_shndx,
 				  unsigned int reloc_type,
+				  const Parsed_eh_frame_section* parsed,
 				  off_t* off);
 #endif
 
@@ -6365,6 +6936,7 @@ Layout::layout_eh_frame<64, false>(Sized_relobj_file<64, false>* object,
 				   const elfcpp::Shdr<64, false>& shdr,
 				   unsigned int reloc_shndx,
 				   unsigned int reloc_type,
+				   const Parsed_eh_frame_section* parsed,
 				   off_t* off);
 #endif
 
@@ -6380,6 +6952,7 @@ Layout::layout_eh_frame<64, true>(Sized_relobj_file<64, true>* object,
 				  const elfcpp::Shdr<64, true>& shdr,
 				  unsigned int reloc_shndx,
 				  unsigned int reloc_type,
+				  const Parsed_eh_frame_section* parsed,
 				  off_t* off);
 #endif
 
@@ -53,11 +53,14 @@ class Output_file_header;
 class Output_segment;
 class Output_data;
 class Output_data_reloc_generic;
+class Output_data_relr_generic;
 class Output_data_dynamic;
+class Output_merge_base;
 class Output_symtab_xindex;
 class Output_reduced_debug_abbrev_section;
 class Output_reduced_debug_info_section;
 class Eh_frame;
+class Eh_frame_hdr;
 class Gdb_index;
 class Target;
 struct Timespec;
@@ -71,7 +74,9 @@ extern std::string
 corresponding_uncompressed_section_name(std::string secname);
 
 // Maintain a list of free space within a section, segment, or file.
-// Used for incremental update links.
+// Used for incremental update links.  The free chunks are kept in
+// address order, and are also grouped by size so that allocate does
+// not have to walk the whole list.
 
 class Free_list
 {
@@ -87,8 +92,8 @@ class Free_list
   typedef std::list<Free_list_node>::const_iterator Const_iterator;
 
   Free_list()
-    : list_(), last_remove_(list_.begin()), extend_(false), length_(0),
-      min_hole_(0)
+    : list_(), last_remove_(list_.begin()), buckets_(), extend_(false),
+      length_(0), min_hole_(0)
   { }
 
   // Initialize the free list for a section of length LEN.
@@ -132,12 +137,42 @@ class Free_list
  private:
   typedef std::list<Free_list_node>::iterator Iterator;
 
+  // The free chunks in a size bucket, indexed by their end offset.
+  // The chunks do not overlap, so this also orders them by address.
+  typedef std::map<off_t, Iterator> Bucket;
+
+  // The number of size buckets.  Bucket N holds the free chunks whose
+  // length is at least 2**N and less than 2**(N+1); the last bucket
+  // also holds all larger chunks.
+  static const unsigned int bucket_count = 48;
+
+  // Return the bucket for a chunk of length LEN.
+  static unsigned int
+  bucket_index(off_t len);
+
+  // Add node P to, or remove it from, its size bucket.  A node must
+  // be removed from its bucket before its start or end is changed.
+  void
+  add_to_bucket(Iterator p);
+
+  void
+  remove_from_bucket(Iterator p);
+
+  // Remove the range [START, END) from node P, which must contain it,
+  // dropping leftover pieces of FUZZ bytes or less.  Return the node
+  // which now follows START.
+  Iterator
+  carve(Iterator p, off_t start, off_t end, off_t fuzz);
+
   // The free list.
   std::list<Free_list_node> list_;
 
   // The last node visited during a remove operation.
   Iterator last_remove_;
 
+  // The free list nodes, grouped by size.
+  std::vector<Bucket> buckets_;
+
   // Whether we can extend past the original length.
   bool extend_;
 
@@ -198,6 +233,45 @@ class Layout_task_runner : public Task_function_runner
   Mapfile* mapfile_;
 };
 
+// This task computes the mappings of one chunk of the merged string
+// sections, before Layout_task_runner.  With many merge sections, as
+// in a relocatable link which keeps each comdat group in a separate
+// output section, this work would otherwise be done serially by
+// Layout::finalize.
+
+class Finalize_merge_sections_task : public Task
+{
+ public:
+  Finalize_merge_sections_task(Layout* layout, unsigned int chunk,
+			       Task_token* this_blocker,
+			       Task_token* next_blocker)
+    : layout_(layout), chunk_(chunk), this_blocker_(this_blocker),
+      next_blocker_(next_blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Finalize_merge_sections_task"; }
+
+ private:
+  Layout* layout_;
+  // The chunk of merge sections; see Layout::merge_sections_chunk_count.
+  unsigned int chunk_;
+  Task_token* this_blocker_;
+  Task_token* next_blocker_;
+};
+
 // This class holds information about the comdat group or
 // .gnu.linkonce section that will be kept for a given signature.
 
@@ -599,8 +673,10 @@ class Layout
   allocate(off_t len, uint64_t align, off_t minoff)
   { return this->free_list_.allocate(len, align, minoff); }
 
+  // Return the position of SECTION_NAME in the --section-ordering-file,
+  // or 0 if it is not there.
   unsigned int
-  find_section_order_index(const std::string&);
+  find_section_order_index(const std::string&) const;
 
   // Read the sequence of input sections from the file specified with
   // linker option --section-ordering-file.
@@ -638,7 +714,8 @@ class Layout
   // .eh_frame section in OBJECT.  SHDR is the section header.
   // RELOC_SHNDX is the index of a relocation section which applies to
   // this section, or 0 if none, or -1U if more than one.  RELOC_TYPE
-  // is the type of the relocation section if there is one.  This
+  // is the type of the relocation section if there is one.  PARSED
+  // is the section as parsed while reading symbols, or NULL.  This
   // returns the output section, and sets *OFFSET to the offset.
   template<int size, bool big_endian>
   Output_section*
@@ -650,6 +727,7 @@ class Layout
 		  unsigned int shndx,
 		  const elfcpp::Shdr<size, big_endian>& shdr,
 		  unsigned int reloc_shndx, unsigned int reloc_type,
+		  const Parsed_eh_frame_section* parsed,
 		  off_t* offset);
 
   // After processing all input files, we call this to make sure that
@@ -658,6 +736,11 @@ class Layout
   void
   finalize_eh_frame_section();
 
+  // Return the data for the .eh_frame_hdr section, or NULL if we are
+  // not creating one.
+  Eh_frame_hdr*
+  eh_frame_hdr() const;
+
   // Add .eh_frame information for a PLT.  The FDE must start with a
   // 4-byte PC-relative reference to the start of the PLT, followed by
   // a 4-byte size of PLT.
@@ -685,6 +768,15 @@ class Layout
 		   unsigned int reloc_shndx,
 		   unsigned int reloc_type);
 
+  // In an incremental update, add the units of an unchanged
+  // .debug_info or .debug_types input section, which occupies
+  // [START, END) in the output section, to the .gdb_index section by
+  // copying them from the index in the base file.  Return false if
+  // the base file has no usable index, in which case the input
+  // section must be scanned with add_to_gdb_index.
+  bool
+  add_base_units_to_gdb_index(bool is_type_unit, off_t start, off_t end);
+
   // Handle a GNU stack note.  This is called once per input object
   // file.  SEEN_GNU_STACK is true if the object file has a
   // .note.GNU-stack section.  GNU_STACK_FLAGS is the section flags
@@ -731,7 +823,8 @@ class Layout
   void
   create_initial_dynamic_sections(Symbol_table*);
 
-  // Define __start and __stop symbols for output sections.
+  // Define __start and __stop symbols for output sections, and the
+  // symbols marking the hot text for --hugepage-text.
   void
   define_section_symbols(Symbol_table*);
 
@@ -831,6 +924,28 @@ class Layout
 			   unsigned int shndx, bool is_comdat,
 			   bool is_group_name, Kept_section** kept_section);
 
+  // Collect the merged string sections whose mappings can be computed
+  // before finalize, and split them into chunks.  This may only be
+  // called once.
+  void
+  collect_merge_sections_to_finalize();
+
+  // Return the number of chunks found by
+  // collect_merge_sections_to_finalize, which is 0 if there are no
+  // such sections.
+  unsigned int
+  merge_sections_chunk_count() const
+  {
+    return ((this->merge_sections_to_finalize_.size()
+	     + merge_sections_chunk_size - 1)
+	    / merge_sections_chunk_size);
+  }
+
+  // Compute the mappings of the merged string sections in chunk
+  // CHUNK.  Different chunks may be handled in parallel.
+  void
+  finalize_merge_sections(unsigned int chunk);
+
   // Finalize the layout after all the input sections have been added.
   off_t
   finalize(const Input_objects*, Symbol_table*, Target*, const Task*);
@@ -941,6 +1056,16 @@ class Layout
 			  const Output_data_reloc_generic* dyn_rel,
 			  bool add_debug, bool dynrel_includes_plt);
 
+  // For the target-specific code to add the dynamic tags for a
+  // SHT_RELR section.  RELR may be NULL.
+  void
+  add_relr_dynamic_tags(Output_data_relr_generic* relr);
+
+  // Whether the output has a SHT_RELR section.
+  bool
+  has_relr_section() const
+  { return this->relr_data_ != NULL; }
+
   // Add a target-specific dynamic tag with constant value.
   void
   add_target_specific_dynamic_tag(elfcpp::DT tag, unsigned int val);
@@ -1056,6 +1181,17 @@ class Layout
 					const int count, const char* name,
 					size_t* plen);
 
+  // Record a line of the --section-ordering-file.
+  void
+  add_section_order_line(const std::string& line, unsigned int position);
+
+  // Look for a glob pattern from the --section-ordering-file which
+  // matches a section name.
+  void
+  match_section_order_glob(const std::vector<unsigned int>& indexes,
+			   const std::string& section_name,
+			   unsigned int* pbest) const;
+
   // During a relocatable link, a list of group sections and
   // signatures.
   struct Group_signature
@@ -1185,6 +1321,11 @@ class Layout
   size_t
   allocated_output_section_count() const;
 
+  // Return the .gdb_index section data, creating it if necessary.
+  // Return NULL if the section is discarded.
+  Gdb_index*
+  gdb_index_data();
+
   // Return the output section for NAME, TYPE and FLAGS.
   Output_section*
   get_output_section(const char* name, Stringpool::Key name_key,
@@ -1364,8 +1505,15 @@ class Layout
       off_t data_size;
       // File offset.
       off_t offset;
+      // The offsets of plain input sections and the addresses of other
+      // input sections, in input section order.
+      std::vector<uint64_t> input_addresses;
     };
 
+    // Record the positions of the input sections of an output section.
+    static void
+    read_input_sections(const Output_section*, std::vector<uint64_t>*);
+
     // Section information.
     std::vector<Section_info> section_infos_;
   };
@@ -1399,6 +1547,11 @@ class Layout
   // The list of output sections which are not attached to any output
   // segment.
   Section_list unattached_section_list_;
+  // The merged string sections collected by
+  // collect_merge_sections_to_finalize.
+  std::vector<Output_merge_base*> merge_sections_to_finalize_;
+  // The number of merged string sections in each chunk.
+  static const size_t merge_sections_chunk_size = 16;
   // The list of unattached Output_data objects which require special
   // handling because they are not Output_sections.
   Data_list special_output_list_;
@@ -1477,6 +1630,9 @@ class Layout
   // True if some input sections need to be mapped to a unique segment,
   // after being mapped to a unique Output_section.
   bool unique_segment_for_sections_specified_;
+  // The SHT_RELR section passed to add_relr_dynamic_tags, if it was
+  // attached to an output section.
+  Output_data_relr_generic* relr_data_;
   // In incremental build, holds information check the inputs and build the
   // .gnu_incremental_inputs section.
   Incremental_inputs* incremental_inputs_;
@@ -1500,6 +1656,17 @@ class Layout
   Unordered_map<std::string, unsigned int> input_section_position_;
   // Vector of glob only patterns in the section_ordering file.
   std::vector<std::string> input_section_glob_;
+  // Glob patterns which start with literal characters, keyed by
+  // those characters.  The values are indexes into
+  // input_section_glob_, in increasing order.
+  Unordered_map<std::string, std::vector<unsigned int> >
+    input_section_glob_prefixes_;
+  // The distinct lengths of the keys in input_section_glob_prefixes_,
+  // in increasing order.
+  std::vector<size_t> input_section_glob_prefix_lengths_;
+  // Indexes into input_section_glob_ of the patterns which start with
+  // a wildcard.
+  std::vector<unsigned int> input_section_glob_others_;
   // For incremental links, the base file to be modified.
   Incremental_binary* incremental_base_;
   // For incremental links, a list of free space within the file.
@@ -1592,10 +1759,11 @@ class Write_symbols_task : public Task
   Write_symbols_task(const Layout* layout, const Symbol_table* symtab,
 		     const Input_objects* /*input_objects*/,
 		     const Stringpool* sympool, const Stringpool* dynpool,
-		     Output_file* of, Task_token* final_blocker)
+		     Output_file* of, Task_token* final_blocker,
+		     unsigned int chunk)
     : layout_(layout), symtab_(symtab),
       sympool_(sympool), dynpool_(dynpool), of_(of),
-      final_blocker_(final_blocker)
+      final_blocker_(final_blocker), chunk_(chunk)
   { }
 
   // The standard Task methods.
@@ -1620,6 +1788,9 @@ class Write_symbols_task : public Task
   const Stringpool* dynpool_;
   Output_file* of_;
   Task_token* final_blocker_;
+  // The chunk of global symbols to write; see
+  // Symbol_table::write_globals_chunk_count.
+  unsigned int chunk_;
 };
 
 // This task handles writing out data in output sections which can't
@@ -1660,6 +1831,29 @@ class Write_after_input_sections_task : public Task
   Task_token* final_blocker_;
 };
 
+// This task function queues the tasks which build the lookup table
+// for the .eh_frame_hdr section in parallel, followed by a
+// Write_after_input_sections_task which waits for them.  This task
+// cannot run until the input sections have been written.
+
+class Eh_frame_hdr_task_runner : public Task_function_runner
+{
+ public:
+  Eh_frame_hdr_task_runner(Layout* layout, Output_file* of,
+			   Task_token* final_blocker)
+    : layout_(layout), of_(of), final_blocker_(final_blocker)
+  { }
+
+  // Run the operation.
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  Layout* layout_;
+  Output_file* of_;
+  Task_token* final_blocker_;
+};
+
 // This task function handles computation of the build id.
 // When using --build-id=tree, it schedules the tasks that
 // compute the hashes for each chunk of the file. This task
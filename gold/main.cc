@@ -29,6 +29,10 @@
 #include <malloc.h>
 #endif
 
+#ifndef __MINGW32__
+#include <sys/resource.h>
+#endif
+
 #include "libiberty.h"
 
 #include "script.h"
@@ -49,6 +53,8 @@
 #include "incremental.h"
 #include "gdb-index.h"
 #include "timer.h"
+#include "memstats.h"
+#include "server.h"
 
 using namespace gold;
 
@@ -148,6 +154,12 @@ main(int argc, char** argv)
 
   program_name = argv[0];
 
+  // Run as a link server if asked to; this only returns in a process
+  // which is to do a link.  Otherwise hand the link to a link server
+  // if there is one.
+  maybe_run_link_server(&argc, &argv);
+  maybe_use_link_server(argc, argv);
+
   // In libiberty; expands @filename to the args in "filename".
   expandargv(&argc, &argv);
 
@@ -169,6 +181,7 @@ main(int argc, char** argv)
     {
       timer.start();
       set_parameters_timer(&timer);
+      Memory_stats::enable();
     }
 
   // Store some options in the globally accessible parameters.
@@ -234,6 +247,13 @@ main(int argc, char** argv)
 
   if (parameters->options().section_ordering_file())
     layout.read_layout_from_file();
+  else if (parameters->options().call_graph_ordering()
+	   && !parameters->options().relocatable())
+    {
+      // The order is computed after all the input sections have been
+      // laid out, but we need to keep track of them until then.
+      layout.set_section_ordering_specified();
+    }
 
   // Load plugin libraries.
   if (command_line.options().has_plugins())
@@ -257,6 +277,7 @@ main(int argc, char** argv)
   if (command_line.options().stats())
     {
       timer.stamp(2);
+      Memory_stats::stamp(2);
       Timer::TimeStats elapsed = timer.get_pass_time(0);
       fprintf(stderr,
              _("%s: initial tasks run time: " \
@@ -294,6 +315,12 @@ main(int argc, char** argv)
       struct mallinfo m = mallinfo();
       fprintf(stderr, _("%s: total space allocated by malloc: %d bytes\n"),
 	      program_name, m.arena);
+#endif
+#ifndef __MINGW32__
+      struct rusage ru;
+      if (getrusage(RUSAGE_SELF, &ru) == 0)
+	fprintf(stderr, _("%s: maximum resident set size: %ld kilobytes\n"),
+		program_name, static_cast<long>(ru.ru_maxrss));
 #endif
       File_read::print_stats();
       Archive::print_stats();
@@ -304,6 +331,7 @@ main(int argc, char** argv)
       layout.print_stats();
       Gdb_index::print_stats();
       Free_list::print_stats();
+      Memory_stats::print_stats();
     }
 
   // Issue defined symbol report.
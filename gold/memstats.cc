@@ -0,0 +1,141 @@
+// memstats.cc -- memory accounting for gold
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <cstdio>
+
+#include "gold-threads.h"
+#include "memstats.h"
+
+namespace gold
+{
+
+// Class Memory_stats.
+
+bool Memory_stats::enabled_;
+int64_t Memory_stats::current_[CATEGORY_COUNT + 1];
+int64_t Memory_stats::peak_[CATEGORY_COUNT + 1];
+int64_t Memory_stats::pass_current_[pass_count][CATEGORY_COUNT + 1];
+int64_t Memory_stats::pass_peak_[pass_count][CATEGORY_COUNT + 1];
+
+// The counts are changed by many threads at once.  When the compiler
+// supports it we update them with atomic operations, as taking a lock
+// for every symbol would be slow.  Otherwise we use a lock.
+
+#ifdef ENABLE_THREADS
+# ifdef __GCC_HAVE_SYNC_COMPARE_AND_SWAP_8
+#  define MEMORY_STATS_ATOMIC
+# else
+#  define MEMORY_STATS_LOCK
+# endif
+#endif
+
+#ifdef MEMORY_STATS_LOCK
+static Lock* memory_stats_lock = NULL;
+static Initialize_lock memory_stats_initialize_lock(&memory_stats_lock);
+#endif
+
+// Add BYTES to *PCURRENT, and raise *PPEAK to the result if that is
+// larger.
+
+static inline void
+add_and_update_peak(int64_t* pcurrent, int64_t* ppeak, int64_t bytes)
+{
+#ifdef MEMORY_STATS_ATOMIC
+  int64_t current = __sync_add_and_fetch(pcurrent, bytes);
+  int64_t peak = *ppeak;
+  while (current > peak)
+    {
+      if (__sync_bool_compare_and_swap(ppeak, peak, current))
+	break;
+      peak = *ppeak;
+    }
+#else
+  *pcurrent += bytes;
+  if (*pcurrent > *ppeak)
+    *ppeak = *pcurrent;
+#endif
+}
+
+void
+Memory_stats::do_add(Category category, int64_t bytes)
+{
+  gold_assert(category < CATEGORY_COUNT);
+#ifdef MEMORY_STATS_LOCK
+  memory_stats_initialize_lock.initialize();
+  Hold_optional_lock hl(memory_stats_lock);
+#endif
+  add_and_update_peak(&Memory_stats::current_[category],
+		      &Memory_stats::peak_[category], bytes);
+  add_and_update_peak(&Memory_stats::current_[CATEGORY_COUNT],
+		      &Memory_stats::peak_[CATEGORY_COUNT], bytes);
+}
+
+// Record the counts at the end of pass N.  This is called between
+// passes, when no other thread is running.
+
+void
+Memory_stats::stamp(int n)
+{
+  if (!Memory_stats::enabled_)
+    return;
+  gold_assert(n >= 0 && n < pass_count);
+  for (int i = 0; i <= CATEGORY_COUNT; ++i)
+    {
+      Memory_stats::pass_current_[n][i] = Memory_stats::current_[i];
+      Memory_stats::pass_peak_[n][i] = Memory_stats::peak_[i];
+      Memory_stats::peak_[i] = Memory_stats::current_[i];
+    }
+}
+
+// Print the statistics.
+
+void
+Memory_stats::print_stats()
+{
+  static const char* const category_names[CATEGORY_COUNT + 1] =
+  {
+    "file views",
+    "symbols",
+    "string pools",
+    "output relocs",
+    "merge maps",
+    "icf",
+    "gc",
+    "total"
+  };
+
+  fprintf(stderr, _("%s: tracked memory in bytes "
+		    "(current/peak for the initial, middle and final tasks):\n"),
+	  program_name);
+  for (int i = 0; i <= CATEGORY_COUNT; ++i)
+    {
+      fprintf(stderr, "%s:   %-14s", program_name, category_names[i]);
+      for (int n = 0; n < pass_count; ++n)
+	fprintf(stderr, " %lld/%lld",
+		static_cast<long long>(Memory_stats::pass_current_[n][i]),
+		static_cast<long long>(Memory_stats::pass_peak_[n][i]));
+      fputc('\n', stderr);
+    }
+}
+
+} // End namespace gold.
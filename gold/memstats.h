@@ -0,0 +1,119 @@
+// memstats.h -- memory accounting for gold   -*- C++ -*-
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#ifndef GOLD_MEMSTATS_H
+#define GOLD_MEMSTATS_H
+
+namespace gold
+{
+
+// With --stats, gold keeps count of the memory used by its larger
+// data structures, grouped by the part of the linker which uses them,
+// and reports the current and the peak number of bytes of each group
+// at the end of each pass.  The counts are of the memory the data
+// structures ask for, not of what malloc uses to provide it, and for
+// the standard containers they are estimates.
+
+class Memory_stats
+{
+ public:
+  // The groups of data structures which are counted.
+  enum Category
+  {
+    // File_read views which were read into memory or mapped.
+    FILE_VIEWS,
+    // Global symbols and the per-object symbol arrays.
+    SYMBOLS,
+    // The string data held by Stringpools.
+    STRINGPOOLS,
+    // Output relocations.
+    RELOCS,
+    // The maps from input to output offsets for merged sections.
+    MERGE_MAPS,
+    // The relocation and section data used by --icf.
+    ICF,
+    // The section reference graph used by --gc-sections.
+    GC,
+    // The number of categories.
+    CATEGORY_COUNT
+  };
+
+  // Start counting.  This is called if --stats is used.
+  static void
+  enable()
+  { Memory_stats::enabled_ = true; }
+
+  // Record that BYTES bytes were allocated for CATEGORY, or freed if
+  // BYTES is negative.
+  static void
+  add(Category category, int64_t bytes)
+  {
+    if (Memory_stats::enabled_)
+      Memory_stats::do_add(category, bytes);
+  }
+
+  // Like add, but for the change in size of a container from
+  // OLD_BYTES to NEW_BYTES.
+  static void
+  resize(Category category, size_t old_bytes, size_t new_bytes)
+  {
+    if (Memory_stats::enabled_ && old_bytes != new_bytes)
+      Memory_stats::do_add(category,
+			   (static_cast<int64_t>(new_bytes)
+			    - static_cast<int64_t>(old_bytes)));
+  }
+
+  // An estimate of the size of a node of a std::map or Unordered_map
+  // holding a VALUE_SIZE byte value.
+  static size_t
+  node_size(size_t value_size)
+  { return value_size + 3 * sizeof(void*); }
+
+  // Record the memory use at the end of pass N (0 <= N <= 2), and
+  // start a new peak for the next pass.
+  static void
+  stamp(int n);
+
+  // Print the memory use of each pass.
+  static void
+  print_stats();
+
+ private:
+  static void
+  do_add(Category, int64_t bytes);
+
+  // The number of passes, as for Timer.
+  static const int pass_count = 3;
+
+  // Whether we are counting.
+  static bool enabled_;
+  // The current number of bytes used by each category, and in total.
+  static int64_t current_[CATEGORY_COUNT + 1];
+  // The largest number of bytes used since the last stamp.
+  static int64_t peak_[CATEGORY_COUNT + 1];
+  // The values recorded at the end of each pass.
+  static int64_t pass_current_[pass_count][CATEGORY_COUNT + 1];
+  static int64_t pass_peak_[pass_count][CATEGORY_COUNT + 1];
+};
+
+} // End namespace gold.
+
+#endif // !defined(GOLD_MEMSTATS_H)
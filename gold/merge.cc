@@ -27,6 +27,7 @@
 
 #include "merge.h"
 #include "compressed_output.h"
+#include "memstats.h"
 
 namespace gold
 {
@@ -40,7 +41,13 @@ Object_merge_map::~Object_merge_map()
   for (Section_merge_maps::iterator p = this->section_merge_maps_.begin();
        p != this->section_merge_maps_.end();
        ++p)
-    delete p->second;
+    {
+      Memory_stats::add(Memory_stats::MERGE_MAPS,
+			-static_cast<int64_t>(sizeof(Input_merge_map)
+					      + (p->second->entries.capacity()
+						 * sizeof(Input_merge_entry))));
+      delete p->second;
+    }
 }
 
 // Get the Input_merge_map to use for an input section, or NULL.
@@ -74,6 +81,7 @@ Object_merge_map::get_or_make_input_merge_map(
     }
 
   Input_merge_map* new_map = new Input_merge_map;
+  Memory_stats::add(Memory_stats::MERGE_MAPS, sizeof(Input_merge_map));
   new_map->output_data = output_data;
   Section_merge_maps &maps = this->section_merge_maps_;
   maps.push_back(std::make_pair(shndx, new_map));
@@ -129,7 +137,27 @@ Object_merge_map::Input_merge_map::add_mapping(
   entry.input_offset = input_offset;
   entry.length = length;
   entry.output_offset = output_offset;
+  size_t old_capacity = this->entries.capacity();
   this->entries.push_back(entry);
+  Memory_stats::resize(Memory_stats::MERGE_MAPS,
+		       old_capacity * sizeof(Input_merge_entry),
+		       this->entries.capacity() * sizeof(Input_merge_entry));
+}
+
+// Get the Input_merge_map for an input section with its entries
+// sorted, or NULL.
+
+const Object_merge_map::Input_merge_map*
+Object_merge_map::get_sorted_input_merge_map(unsigned int shndx)
+{
+  Input_merge_map* map = this->get_input_merge_map(shndx);
+  if (map != NULL && !map->sorted)
+    {
+      std::sort(map->entries.begin(), map->entries.end(),
+		Input_merge_compare());
+      map->sorted = true;
+    }
+  return map;
 }
 
 // Get the output offset for an input address.
@@ -139,17 +167,10 @@ Object_merge_map::get_output_offset(unsigned int shndx,
 				    section_offset_type input_offset,
 				    section_offset_type* output_offset)
 {
-  Input_merge_map* map = this->get_input_merge_map(shndx);
+  const Input_merge_map* map = this->get_sorted_input_merge_map(shndx);
   if (map == NULL)
     return false;
 
-  if (!map->sorted)
-    {
-      std::sort(map->entries.begin(), map->entries.end(),
-		Input_merge_compare());
-      map->sorted = true;
-    }
-
   Input_merge_entry entry;
   entry.input_offset = input_offset;
   std::vector<Input_merge_entry>::const_iterator p =
@@ -220,6 +241,64 @@ Object_merge_map::initialize_input_to_output_map(
     }
 }
 
+// Class Merge_map_cursor.
+
+// Get the output offset for an input address, starting the search at
+// the entry found by the previous call.
+
+bool
+Merge_map_cursor::output_offset(section_offset_type input_offset,
+				section_offset_type* output_offset)
+{
+  gold_assert(this->map_ != NULL);
+  typedef Object_merge_map::Input_merge_map::Entries Entries;
+  const Entries& entries(this->map_->entries);
+  if (entries.empty())
+    return false;
+
+  Object_merge_map::Input_merge_entry entry;
+  entry.input_offset = input_offset;
+  Entries::const_iterator p = entries.begin() + this->pos_;
+  if (input_offset < p->input_offset)
+    {
+      // The offsets went backward; search the entries before P.
+      p = std::upper_bound(entries.begin(), p, entry,
+			   Object_merge_map::Input_merge_compare());
+      if (p == entries.begin())
+	return false;
+      --p;
+    }
+  else
+    {
+      // Step forward over the entries which start at or before
+      // INPUT_OFFSET, and search the rest if there are many of them.
+      size_t steps = 0;
+      while (p + 1 != entries.end() && (p + 1)->input_offset <= input_offset)
+	{
+	  ++p;
+	  if (++steps == max_linear_steps)
+	    {
+	      p = std::upper_bound(p + 1, entries.end(), entry,
+				   Object_merge_map::Input_merge_compare());
+	      --p;
+	      break;
+	    }
+	}
+    }
+
+  this->pos_ = p - entries.begin();
+  gold_assert(p->input_offset <= input_offset);
+
+  if (input_offset - p->input_offset
+      >= static_cast<section_offset_type>(p->length))
+    return false;
+
+  *output_offset = p->output_offset;
+  if (*output_offset != -1)
+    *output_offset += (input_offset - p->input_offset);
+  return true;
+}
+
 // Class Output_merge_base.
 
 // Return the output offset for an input offset.  The input address is
@@ -468,8 +547,12 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
 	--pend0;
     }
 
+  Object_merge_map* merge_map = object->get_or_create_merge_map();
+  Object_merge_map::Input_merge_map* input_merge_map =
+    merge_map->get_or_make_input_merge_map(this, shndx);
+
   Merged_strings_list* merged_strings_list =
-      new Merged_strings_list(object, shndx);
+      new Merged_strings_list(object, shndx, input_merge_map);
   this->merged_strings_lists_.push_back(merged_strings_list);
   Merged_strings& merged_strings = merged_strings_list->merged_strings;
 
@@ -554,10 +637,8 @@ Output_merge_string<Char_type>::finalize_merged_data()
     {
       section_offset_type last_input_offset = 0;
       section_offset_type last_output_offset = 0;
-      Relobj *object = (*l)->object;
-      Object_merge_map* merge_map = object->get_or_create_merge_map();
       Object_merge_map::Input_merge_map* input_merge_map =
-        merge_map->get_or_make_input_merge_map(this, (*l)->shndx);
+	(*l)->input_merge_map;
 
       for (typename Merged_strings::const_iterator p =
 	     (*l)->merged_strings.begin();
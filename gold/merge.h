@@ -140,7 +140,14 @@ class Object_merge_map
   get_or_make_input_merge_map(const Output_section_data* merge_map,
                               unsigned int shndx);
 
+  // Return the Input_merge_map for the section SHNDX with its entries
+  // sorted by input offset, or NULL if there is none.
+  const Input_merge_map*
+  get_sorted_input_merge_map(unsigned int shndx);
+
   private:
+  friend class Merge_map_cursor;
+
   // A less-than comparison routine for Input_merge_entry.
   struct Input_merge_compare
   {
@@ -167,6 +174,62 @@ class Object_merge_map
   Section_merge_maps section_merge_maps_;
 };
 
+// Look up the output offsets for a series of offsets in a single
+// input section.  This is used when rewriting the relocations for a
+// section with a merge map, such as .eh_frame, during a relocatable
+// link.  The relocation offsets are normally increasing, so each
+// lookup starts from the entry found by the previous one rather than
+// searching the object's list of maps and then the whole map.
+
+class Merge_map_cursor
+{
+ public:
+  // OBJECT_MERGE_MAP may be NULL if the object has no merge maps.
+  Merge_map_cursor(Object_merge_map* object_merge_map, unsigned int shndx)
+    : map_(object_merge_map == NULL
+	   ? NULL
+	   : object_merge_map->get_sorted_input_merge_map(shndx)),
+      pos_(0)
+  { }
+
+  // Whether the input section has a merge map.
+  bool
+  is_valid() const
+  { return this->map_ != NULL; }
+
+  // Return the merged data which holds the input section.  This is
+  // only valid if is_valid returns true.
+  const Output_section_data*
+  output_data() const
+  { return this->map_->output_data; }
+
+  // Get the output offset for INPUT_OFFSET, with the same meaning as
+  // Object_merge_map::get_output_offset.
+  bool
+  output_offset(section_offset_type input_offset,
+		section_offset_type* output_offset);
+
+  // Return whether INPUT_OFFSET is being copied to the output, with
+  // the same meaning as Output_section::is_input_address_mapped.
+  bool
+  is_input_address_mapped(section_offset_type input_offset)
+  {
+    section_offset_type output_offset;
+    return (!this->output_offset(input_offset, &output_offset)
+	    || output_offset != -1);
+  }
+
+ private:
+  // The number of entries to step over before falling back to a
+  // binary search.
+  static const size_t max_linear_steps = 8;
+
+  // The map for the input section, or NULL.
+  const Object_merge_map::Input_merge_map* map_;
+  // The index of the entry found by the last lookup.
+  size_t pos_;
+};
+
 // A general class for SHF_MERGE data, to hold functions shared by
 // fixed-size constant data and string data.
 
@@ -195,6 +258,13 @@ class Output_merge_base : public Output_section_data
   keeps_input_sections() const
   { return this->keeps_input_sections_; }
 
+  // Compute the mappings from the input sections to the merged data.
+  // This is otherwise done by set_final_data_size.  Different merge
+  // sections may be finalized by different threads at the same time.
+  void
+  finalize_mappings()
+  { this->do_finalize_mappings(); }
+
   // Set the keeps-input-sections flag.  This is virtual so that sub-classes
   // can perform additional checks.
   void
@@ -253,6 +323,11 @@ class Output_merge_base : public Output_section_data
   do_set_keeps_input_sections()
   { this->keeps_input_sections_ = true; }
 
+  // This may be overridden by the child class.
+  virtual void
+  do_finalize_mappings()
+  { }
+
   // Record the merged input section for script processing.
   void
   record_input_section(Relobj* relobj, unsigned int shndx);
@@ -421,6 +496,11 @@ class Output_merge_string : public Output_merge_base
   void
   set_final_data_size();
 
+  // Compute the mappings ahead of set_final_data_size.
+  void
+  do_finalize_mappings()
+  { this->finalize_merged_data(); }
+
   // Write the data to the file.
   void
   do_write(Output_file*);
@@ -488,11 +568,17 @@ class Output_merge_string : public Output_merge_base
     Relobj* object;
     // The input section in the input object.
     unsigned int shndx;
+    // The merge map for the input section.  This is created when the
+    // section is added, so that finalizing this merge section does
+    // not change the object's list of merge maps.
+    Object_merge_map::Input_merge_map* input_merge_map;
     // The list of merged strings.
     Merged_strings merged_strings;
 
-    Merged_strings_list(Relobj* objecta, unsigned int shndxa)
-      : object(objecta), shndx(shndxa), merged_strings()
+    Merged_strings_list(Relobj* objecta, unsigned int shndxa,
+			Object_merge_map::Input_merge_map* input_merge_mapa)
+      : object(objecta), shndx(shndxa), input_merge_map(input_merge_mapa),
+	merged_strings()
     { }
   };
 
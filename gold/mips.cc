@@ -1600,6 +1600,9 @@ class Mips_relobj : public Sized_relobj_file<size, big_endian>
   {
     this->is_pic_ = (ehdr.get_e_flags() & elfcpp::EF_MIPS_PIC) != 0;
     this->is_n32_ = elfcpp::abi_n32(ehdr.get_e_flags());
+    // The MIPS GOT and the mips16 stubs are written using our local
+    // symbol values.
+    this->set_has_late_references();
   }
 
   ~Mips_relobj()
@@ -31,6 +31,7 @@
 #include "gc.h"
 #include "target-select.h"
 #include "dwarf_reader.h"
+#include "int_encoding.h"
 #include "layout.h"
 #include "output.h"
 #include "symtab.h"
@@ -42,6 +43,8 @@
 #include "compressed_output.h"
 #include "incremental.h"
 #include "merge.h"
+#include "ehframe.h"
+#include "memstats.h"
 
 namespace gold
 {
@@ -67,6 +70,10 @@ Read_symbols_data::~Read_symbols_data()
     delete this->verdef;
   if (this->verneed != NULL)
     delete this->verneed;
+  for (Parsed_eh_frames::iterator p = this->parsed_eh_frames.begin();
+       p != this->parsed_eh_frames.end();
+       ++p)
+    delete p->second;
 }
 
 // Class Xindex.
@@ -125,13 +132,16 @@ Xindex::read_symtab_xindex(Object* object, unsigned int xindex_shndx,
     }
 
   gold_assert(this->symtab_xindex_.empty());
-  this->symtab_xindex_.reserve(bytecount / 4);
-  for (section_size_type i = 0; i < bytecount; i += 4)
-    {
-      unsigned int shndx = elfcpp::Swap<32, big_endian>::readval(contents + i);
-      // We preadjust the section indexes we save.
-      this->symtab_xindex_.push_back(this->adjust_shndx(shndx));
-    }
+  this->symtab_xindex_.resize(bytecount / 4);
+  if (!this->symtab_xindex_.empty())
+    elfcpp::Swap_array<32, big_endian>::readvals(contents,
+						 &this->symtab_xindex_[0],
+						 this->symtab_xindex_.size());
+  // We preadjust the section indexes we save.
+  for (Symtab_xindex::iterator p = this->symtab_xindex_.begin();
+       p != this->symtab_xindex_.end();
+       ++p)
+    *p = this->adjust_shndx(*p);
 }
 
 // Symbol symndx has a section of SHN_XINDEX; return the real section
@@ -306,6 +316,31 @@ Relobj::find_merge_section(unsigned int shndx) const {
   return object_merge_map->find_merge_section(shndx);
 }
 
+// Free the relocatable reloc info.  Output_relocatable_relocs only
+// needs the number of output relocs, which is kept.
+
+void
+Relobj::release_relocatable_relocs()
+{
+  if (this->map_to_relocatable_relocs_ == NULL)
+    return;
+  for (std::vector<Relocatable_relocs*>::iterator p =
+	 this->map_to_relocatable_relocs_->begin();
+       p != this->map_to_relocatable_relocs_->end();
+       ++p)
+    if (*p != NULL)
+      (*p)->release_reloc_strategies();
+}
+
+// Free the mappings for merge sections.
+
+void
+Relobj::release_merge_map()
+{
+  delete this->object_merge_map_;
+  this->object_merge_map_ = NULL;
+}
+
 // To copy the symbols data read from the file to a local data structure.
 // This function is called from do_layout only while doing garbage
 // collection.
@@ -475,6 +510,7 @@ Sized_relobj_file<size, big_endian>::Sized_relobj_file(
     local_values_(),
     local_plt_offsets_(),
     kept_comdat_sections_(),
+    addrsig_shndx_(0),
     has_eh_frame_(false),
     is_deferred_layout_(false),
     deferred_layout_(),
@@ -662,6 +698,49 @@ Sized_relobj_file<size, big_endian>::find_eh_frame(
     }
 }
 
+// The decompressed contents of compressed debug sections may be kept
+// in the Compressed_section_map of their object, so that they are
+// decompressed only once.  The total size of the kept contents is
+// limited by --decompressed-section-cache-size.
+
+// A lock for decompressed_cache_bytes.
+static Lock* decompressed_cache_lock = NULL;
+static Initialize_lock
+  decompressed_cache_initialize_lock(&decompressed_cache_lock);
+
+// The number of bytes of decompressed contents currently kept.
+static uint64_t decompressed_cache_bytes;
+
+// Try to reserve SIZE bytes of the decompressed section budget.
+// Return true if the contents may be kept.
+
+static bool
+reserve_decompressed_cache(uint64_t size)
+{
+  // Tools like dwp that do not set up gold options don't cache.
+  if (!parameters->options_valid())
+    return false;
+
+  decompressed_cache_initialize_lock.initialize();
+  Hold_optional_lock hl(decompressed_cache_lock);
+  uint64_t limit = parameters->options().decompressed_section_cache_size();
+  if (size > limit || decompressed_cache_bytes > limit - size)
+    return false;
+  decompressed_cache_bytes += size;
+  return true;
+}
+
+// Return SIZE bytes to the decompressed section budget.
+
+static void
+release_decompressed_cache(uint64_t size)
+{
+  decompressed_cache_initialize_lock.initialize();
+  Hold_optional_lock hl(decompressed_cache_lock);
+  gold_assert(decompressed_cache_bytes >= size);
+  decompressed_cache_bytes -= size;
+}
+
 // Return TRUE if this is a section whose contents will be needed in the
 // Add_symbols task.  This function is only called for sections that have
 // already passed the test in is_compressed_debug_section() and the debug
@@ -771,7 +850,9 @@ build_compressed_section_map(
 	      if (uncompressed_size != -1ULL)
 		{
 		  unsigned char* uncompressed_data = NULL;
-		  if (decompress_if_needed && need_decompressed_section(name))
+		  if (decompress_if_needed
+		      && need_decompressed_section(name)
+		      && reserve_decompressed_cache(uncompressed_size))
 		    {
 		      uncompressed_data = new unsigned char[uncompressed_size];
 		      if (decompress_input_section(contents, len,
@@ -781,7 +862,10 @@ build_compressed_section_map(
 						   shdr.get_sh_flags()))
 			info.contents = uncompressed_data;
 		      else
-			delete[] uncompressed_data;
+			{
+			  delete[] uncompressed_data;
+			  release_decompressed_cache(uncompressed_size);
+			}
 		    }
 		  (*uncompressed_map)[i] = info;
 		}
@@ -806,6 +890,26 @@ Sized_relobj_file<size, big_endian>::do_find_special_sections(
   if (this->find_eh_frame(pshdrs, names, sd->section_names_size))
     this->has_eh_frame_ = true;
 
+  // With --icf=safe, look for an address-significance table.  It
+  // refers to symbols by index, so ignore it if it is not linked to
+  // our symbol table: that means that a tool which does not know
+  // about it, such as objcopy or ld -r, has rewritten the symbols.
+  if (parameters->options().icf_safe_folding() && this->symtab_shndx_ != 0)
+    {
+      const unsigned int shnum = this->shnum();
+      const unsigned char* p = pshdrs + This::shdr_size;
+      for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+	{
+	  typename This::Shdr shdr(p);
+	  if (shdr.get_sh_type() == elfcpp::SHT_LLVM_ADDRSIG
+	      && this->adjust_shndx(shdr.get_sh_link()) == this->symtab_shndx_)
+	    {
+	      this->addrsig_shndx_ = i;
+	      break;
+	    }
+	}
+    }
+
   Compressed_section_map* compressed_sections =
     build_compressed_section_map<size, big_endian>(
       pshdrs, this->shnum(), names, sd->section_names_size, this, true);
@@ -820,6 +924,94 @@ Sized_relobj_file<size, big_endian>::do_find_special_sections(
 			    "debug_types", 12) != NULL)));
 }
 
+// Record the sections whose addresses are significant according to
+// the address-significance table, for --icf=safe.  The table is a
+// sequence of ULEB128 symbol indexes.  Relocations in this object are
+// not checked for function pointers, so we also have to record the
+// sections defining symbols which may be seen by other modules.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::do_find_address_significant_sections(
+    Symbol_table* symtab)
+{
+  if (this->addrsig_shndx_ == 0)
+    return;
+
+  Icf* icf = symtab->icf();
+
+  section_size_type addrsig_size;
+  const unsigned char* p = this->section_contents(this->addrsig_shndx_,
+						  &addrsig_size, false);
+  const unsigned char* pend = p + addrsig_size;
+
+  section_size_type symtab_size;
+  const unsigned char* psyms = this->section_contents(this->symtab_shndx_,
+						      &symtab_size, false);
+  const unsigned int symcount = symtab_size / This::sym_size;
+  const unsigned int loccount = this->local_symbol_count_;
+
+  while (p < pend)
+    {
+      size_t len;
+      uint64_t symndx = read_unsigned_LEB_128(p, &len);
+      p += len;
+      if (p > pend || symndx >= symcount)
+	{
+	  this->error(_("invalid address-significance table"));
+	  return;
+	}
+
+      if (symndx < loccount)
+	{
+	  elfcpp::Sym<size, big_endian> sym(psyms + symndx * This::sym_size);
+	  bool is_ordinary;
+	  unsigned int shndx = this->adjust_sym_shndx(symndx,
+						      sym.get_st_shndx(),
+						      &is_ordinary);
+	  if (is_ordinary && shndx != elfcpp::SHN_UNDEF)
+	    icf->set_section_has_function_pointers(this, shndx);
+	}
+      else
+	{
+	  Symbol* gsym = this->global_symbol(symndx);
+	  if (gsym == NULL)
+	    continue;
+	  if (gsym->is_forwarder())
+	    gsym = symtab->resolve_forwards(gsym);
+	  if (gsym->source() != Symbol::FROM_OBJECT
+	      || gsym->object()->is_dynamic())
+	    continue;
+	  bool is_ordinary;
+	  unsigned int shndx = gsym->shndx(&is_ordinary);
+	  if (is_ordinary && shndx != elfcpp::SHN_UNDEF)
+	    icf->set_section_has_function_pointers(
+		static_cast<Relobj*>(gsym->object()), shndx);
+	}
+    }
+
+  // The address of a symbol in the dynamic symbol table may be taken
+  // by another module.
+  const bool is_exporting = (parameters->options().shared()
+			     || parameters->options().export_dynamic());
+  for (typename Symbols::const_iterator q = this->symbols_.begin();
+       q != this->symbols_.end();
+       ++q)
+    {
+      Symbol* gsym = *q;
+      if (gsym == NULL
+	  || gsym->object() != this
+	  || !gsym->is_defined()
+	  || !gsym->is_externally_visible()
+	  || (!is_exporting && !gsym->in_dyn()))
+	continue;
+      bool is_ordinary;
+      unsigned int shndx = gsym->shndx(&is_ordinary);
+      if (is_ordinary)
+	icf->set_section_has_function_pointers(this, shndx);
+    }
+}
+
 // Read the sections and symbols from an object file.
 
 template<int size, bool big_endian>
@@ -873,6 +1065,8 @@ Sized_relobj_file<size, big_endian>::base_read_symbols(Read_symbols_data* sd)
   const unsigned int loccount = symtabshdr.get_sh_info();
   this->local_symbol_count_ = loccount;
   this->local_values_.resize(loccount);
+  Memory_stats::add(Memory_stats::SYMBOLS,
+		    loccount * sizeof(Symbol_value<size>));
   section_offset_type locsize = loccount * sym_size;
   off_t dataoff = symtabshdr.get_sh_offset();
   section_size_type datasize =
@@ -917,6 +1111,82 @@ Sized_relobj_file<size, big_endian>::base_read_symbols(Read_symbols_data* sd)
   sd->symbol_names = fvstrtab;
   sd->symbol_names_size =
     convert_to_section_size_type(strtabshdr.get_sh_size());
+
+#ifdef ENABLE_THREADS
+  // Parsing the .eh_frame sections now will help only if we're
+  // multithreaded, since reading symbols runs in parallel while
+  // layout does not.  When laying out in two passes, the second pass
+  // does not see this data, so don't bother.
+  if (this->has_eh_frame_
+      && parameters->options().threads()
+      && !parameters->options().relocatable()
+      && !parameters->incremental()
+      && !parameters->options().gc_sections()
+      && !parameters->options().icf_enabled())
+    this->parse_eh_frame_sections(sd);
+#endif
+}
+
+// Parse the .eh_frame sections, so that layout only has to merge the
+// results into the output.  The symbols must have been read into SD,
+// including the local symbols.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::parse_eh_frame_sections(
+    Read_symbols_data* sd)
+{
+  gold_assert(this->has_eh_frame_);
+
+  const unsigned int shnum = this->shnum();
+  const unsigned char* const pshdrs = sd->section_headers->data();
+  const char* const names =
+    reinterpret_cast<const char*>(sd->section_names->data());
+
+  // Find the .eh_frame sections, and the relocation section for each
+  // one, as do_layout does.
+  std::vector<unsigned int> reloc_shndx(shnum, 0);
+  std::vector<unsigned int> reloc_type(shnum, elfcpp::SHT_NULL);
+  std::vector<unsigned int> eh_frame_sections;
+  const unsigned char* p = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+    {
+      typename This::Shdr shdr(p);
+      unsigned int sh_type = shdr.get_sh_type();
+      if (sh_type == elfcpp::SHT_REL || sh_type == elfcpp::SHT_RELA)
+	{
+	  unsigned int target_shndx = this->adjust_shndx(shdr.get_sh_info());
+	  if (target_shndx == 0 || target_shndx >= shnum)
+	    continue;
+	  if (reloc_shndx[target_shndx] != 0)
+	    reloc_shndx[target_shndx] = -1U;
+	  else
+	    {
+	      reloc_shndx[target_shndx] = i;
+	      reloc_type[target_shndx] = sh_type;
+	    }
+	}
+      else if (shdr.get_sh_name() < sd->section_names_size
+	       && strcmp(names + shdr.get_sh_name(), ".eh_frame") == 0
+	       && this->check_eh_frame_flags(&shdr))
+	eh_frame_sections.push_back(i);
+    }
+
+  for (std::vector<unsigned int>::const_iterator pe = eh_frame_sections.begin();
+       pe != eh_frame_sections.end();
+       ++pe)
+    {
+      unsigned int i = *pe;
+      Parsed_eh_frame_section* parsed = new Parsed_eh_frame_section();
+      Eh_frame::parse_ehframe_input_section(this,
+					    sd->symbols->data(),
+					    sd->symbols_size,
+					    sd->symbol_names->data(),
+					    sd->symbol_names_size,
+					    i, reloc_shndx[i], reloc_type[i],
+					    parsed);
+      sd->parsed_eh_frames[i] = parsed;
+    }
 }
 
 // Return the section index of symbol SYM.  Set *VALUE to its value in
@@ -1254,7 +1524,8 @@ Sized_relobj_file<size, big_endian>::layout_eh_frame_section(
     unsigned int shndx,
     const typename This::Shdr& shdr,
     unsigned int reloc_shndx,
-    unsigned int reloc_type)
+    unsigned int reloc_type,
+    const Parsed_eh_frame_section* parsed)
 {
   gold_assert(this->has_eh_frame_);
 
@@ -1268,6 +1539,7 @@ Sized_relobj_file<size, big_endian>::layout_eh_frame_section(
 					       shdr,
 					       reloc_shndx,
 					       reloc_type,
+					       parsed,
 					       &offset);
   this->output_sections()[shndx] = os;
   if (os == NULL || offset == -1)
@@ -1878,6 +2150,17 @@ Sized_relobj_file<size, big_endian>::do_layout(Symbol_table* symtab,
       pshdr = section_headers_data + i * This::shdr_size;
       typename This::Shdr shdr(pshdr);
 
+      // Use the results of parsing the section while reading
+      // symbols, if we did that.
+      const Parsed_eh_frame_section* parsed = NULL;
+      if (sd != NULL)
+	{
+	  Read_symbols_data::Parsed_eh_frames::const_iterator pp =
+	    sd->parsed_eh_frames.find(i);
+	  if (pp != sd->parsed_eh_frames.end())
+	    parsed = pp->second;
+	}
+
       this->layout_eh_frame_section(layout,
 				    symbols_data,
 				    symbols_size,
@@ -1886,7 +2169,8 @@ Sized_relobj_file<size, big_endian>::do_layout(Symbol_table* symtab,
 				    i,
 				    shdr,
 				    reloc_shndx[i],
-				    reloc_type[i]);
+				    reloc_type[i],
+				    parsed);
     }
 
   // When doing a relocatable link handle the reloc sections at the
@@ -2016,6 +2300,8 @@ Sized_relobj_file<size, big_endian>::do_layout_deferred_sections(Layout* layout)
 	  // Reading the symbols again here may be slow.
 	  Read_symbols_data sd;
 	  this->base_read_symbols(&sd);
+	  Read_symbols_data::Parsed_eh_frames::const_iterator pp =
+	    sd.parsed_eh_frames.find(deferred->shndx_);
 	  this->layout_eh_frame_section(layout,
 					sd.symbols->data(),
 					sd.symbols_size,
@@ -2024,7 +2310,10 @@ Sized_relobj_file<size, big_endian>::do_layout_deferred_sections(Layout* layout)
 					deferred->shndx_,
 					shdr,
 					deferred->reloc_shndx_,
-					deferred->reloc_type_);
+					deferred->reloc_type_,
+					(pp == sd.parsed_eh_frames.end()
+					 ? NULL
+					 : pp->second));
 	  continue;
 	}
 
@@ -2095,6 +2384,7 @@ Sized_relobj_file<size, big_endian>::do_add_symbols(Symbol_table* symtab,
     }
 
   this->symbols_.resize(symcount);
+  Memory_stats::add(Memory_stats::SYMBOLS, symcount * sizeof(Symbol*));
 
   const char* sym_names =
     reinterpret_cast<const char*>(sd->symbol_names->data());
@@ -2999,6 +3289,41 @@ Sized_relobj_file<size, big_endian>::find_kept_section_object(
   return NULL;
 }
 
+// Free the data which is only needed for relocation.  This is called
+// by Relocate_task once the sections have been relocated and the local
+// symbols written.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::do_release_relocation_data()
+{
+  // The kept comdat sections are only used to resolve relocations
+  // against discarded sections.
+  this->kept_comdat_sections_.clear();
+  this->release_relocatable_relocs();
+
+  // The local symbol values, the global symbol array and the merge
+  // maps are still needed if dynamic relocations, GOT entries or
+  // target specific data refer to this object, and by --gdb-index,
+  // --cref, --print-symbol-counts and incremental links.
+  if (this->has_late_references()
+      || parameters->incremental()
+      || parameters->options().gdb_index()
+      || parameters->options().cref()
+      || parameters->options().user_set_print_symbol_counts())
+    return;
+
+  Memory_stats::add(Memory_stats::SYMBOLS,
+		    -static_cast<int64_t>((this->local_values_.size()
+					   * sizeof(Symbol_value<size>))
+					  + (this->symbols_.size()
+					     * sizeof(Symbol*))));
+  Local_values().swap(this->local_values_);
+  Symbols().swap(this->symbols_);
+  this->local_plt_offsets_.clear();
+  this->release_merge_map();
+}
+
 // Return the name of symbol SYMNDX.
 
 template<int size, bool big_endian>
@@ -3073,7 +3398,7 @@ Object::decompressed_section_contents(
       return buffer;
     }
 
-  Compressed_section_map::const_iterator p =
+  Compressed_section_map::iterator p =
       this->compressed_sections_->find(shndx);
   if (p == this->compressed_sections_->end())
     {
@@ -3098,25 +3423,38 @@ Object::decompressed_section_contents(
 				elfsize(),
 				is_big_endian(),
 				p->second.flag))
-    this->error(_("could not decompress section %s"),
-		this->do_section_name(shndx).c_str());
-
-  // We could cache the results in p->second.contents and store
-  // false in *IS_NEW, but build_compressed_section_map() would
-  // have done so if it had expected it to be profitable.  If
-  // we reach this point, we expect to need the contents only
-  // once in this pass.
+    {
+      this->error(_("could not decompress section %s"),
+		  this->do_section_name(shndx).c_str());
+      *plen = uncompressed_size;
+      *is_new = true;
+      return uncompressed_data;
+    }
+
+  // Keep the contents if there is room, so that a later consumer
+  // (merge processing, the gdb index, the line number reader, or the
+  // relocation of the section itself) does not decompress the section
+  // again.
   *plen = uncompressed_size;
-  *is_new = true;
+  if (this->may_cache_decompressed_sections_
+      && reserve_decompressed_cache(uncompressed_size))
+    {
+      p->second.contents = uncompressed_data;
+      *is_new = false;
+    }
+  else
+    *is_new = true;
   return uncompressed_data;
 }
 
 // Discard any buffers of uncompressed sections.  This is done
-// at the end of the Add_symbols task.
+// at the end of the Relocate_task, when nothing else will read them.
 
 void
 Object::discard_decompressed_sections()
 {
+  this->may_cache_decompressed_sections_ = false;
+
   if (this->compressed_sections_ == NULL)
     return;
 
@@ -3128,6 +3466,7 @@ Object::discard_decompressed_sections()
 	{
 	  delete[] p->second.contents;
 	  p->second.contents = NULL;
+	  release_decompressed_cache(p->second.size);
 	}
     }
 }
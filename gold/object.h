@@ -23,6 +23,7 @@
 #ifndef GOLD_OBJECT_H
 #define GOLD_OBJECT_H
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -49,6 +50,7 @@ class Pluginobj;
 class Dynobj;
 class Object_merge_map;
 class Relocatable_relocs;
+class Parsed_eh_frame_section;
 struct Symbols_data;
 
 template<typename Stringpool_char>
@@ -60,7 +62,8 @@ struct Read_symbols_data
 {
   Read_symbols_data()
     : section_headers(NULL), section_names(NULL), symbols(NULL),
-      symbol_names(NULL), versym(NULL), verdef(NULL), verneed(NULL)
+      symbol_names(NULL), versym(NULL), verdef(NULL), verneed(NULL),
+      parsed_eh_frames()
   { }
 
   ~Read_symbols_data();
@@ -96,6 +99,11 @@ struct Read_symbols_data
   File_view* verneed;
   section_size_type verneed_size;
   unsigned int verneed_info;
+
+  // The .eh_frame sections which were parsed while reading symbols,
+  // indexed by section index.  This is only used on object files.
+  typedef std::map<unsigned int, Parsed_eh_frame_section*> Parsed_eh_frames;
+  Parsed_eh_frames parsed_eh_frames;
 };
 
 // Information used to print error messages.
@@ -156,6 +164,28 @@ struct Read_relocs_data
   File_view* local_symbols;
 };
 
+// A call from an input section of a Relobj, found in its relocs for
+// --call-graph-ordering.  The callee is either the section
+// CALLEE_SHNDX of the same object, or, if CALLEE_SYMBOL is not NULL,
+// the section which defines that symbol.  COUNT is the number of
+// relocs which make the call.
+
+struct Call_graph_call
+{
+  Call_graph_call(unsigned int caller_shndx, unsigned int callee_shndx,
+		  Symbol* callee_symbol)
+    : caller_shndx(caller_shndx), callee_shndx(callee_shndx),
+      callee_symbol(callee_symbol), count(1)
+  { }
+
+  unsigned int caller_shndx;
+  unsigned int callee_shndx;
+  Symbol* callee_symbol;
+  uint64_t count;
+};
+
+typedef std::vector<Call_graph_call> Call_graph_calls;
+
 // The Xindex class manages section indexes for objects with more than
 // 0xff00 sections.
 
@@ -401,7 +431,8 @@ class Object
     : name_(name), input_file_(input_file), offset_(offset), shnum_(-1U),
       is_dynamic_(is_dynamic), is_needed_(false), uses_split_stack_(false),
       has_no_split_stack_(false), no_export_(false),
-      is_in_system_directory_(false), as_needed_(false), xindex_(NULL),
+      is_in_system_directory_(false), as_needed_(false),
+      may_cache_decompressed_sections_(true), xindex_(NULL),
       compressed_sections_(NULL)
   {
     if (input_file != NULL)
@@ -755,6 +786,15 @@ class Object
       this->input_file_->file().clear_view_cache_marks();
   }
 
+  // Discard all uncached views in the underlying file, even if it is
+  // an archive.
+  void
+  clear_uncached_views()
+  {
+    if (this->input_file_ != NULL)
+      this->input_file_->file().clear_uncached_views();
+  }
+
   // Get the number of global symbols defined by this object, and the
   // number of the symbols whose final definition came from this
   // object.
@@ -825,13 +865,30 @@ class Object
 
   // Return a view of the decompressed contents of a section.  Set *PLEN
   // to the size.  Set *IS_NEW to true if the contents need to be freed
-  // by the caller.
+  // by the caller.  Until discard_decompressed_sections is called,
+  // newly decompressed contents are kept for later callers if they fit
+  // in the --decompressed-section-cache-size budget.
   const unsigned char*
   decompressed_section_contents(unsigned int shndx, section_size_type* plen,
 				bool* is_cached);
 
-  // Discard any buffers of decompressed sections.  This is done
-  // at the end of the Add_symbols task.
+  // Return the decompressed contents of section SHNDX if they were
+  // kept, or NULL.
+  const unsigned char*
+  cached_decompressed_section_contents(unsigned int shndx) const
+  {
+    if (this->compressed_sections_ == NULL)
+      return NULL;
+    Compressed_section_map::const_iterator p =
+        this->compressed_sections_->find(shndx);
+    if (p == this->compressed_sections_->end())
+      return NULL;
+    return p->second.contents;
+  }
+
+  // Discard any buffers of decompressed sections, returning their
+  // memory to the cache budget.  This is done at the end of the
+  // Relocate_task, or when the object is not added to the link.
   void
   discard_decompressed_sections();
 
@@ -1080,6 +1137,9 @@ class Object
   bool is_in_system_directory_ : 1;
   // True if the object was linked with --as-needed.
   bool as_needed_ : 1;
+  // True if decompressed_section_contents may keep the contents it
+  // decompresses; cleared by discard_decompressed_sections.
+  bool may_cache_decompressed_sections_ : 1;
   // Many sections for objects with more than SHN_LORESERVE sections.
   Xindex* xindex_;
   // For compressed debug sections, map section index to uncompressed size
@@ -1099,11 +1159,13 @@ class Relobj : public Object
       map_to_relocatable_relocs_(NULL),
       object_merge_map_(NULL),
       relocs_must_follow_section_writes_(false),
+      has_late_references_(false),
       sd_(NULL),
       reloc_counts_(NULL),
       reloc_bases_(NULL),
       first_dyn_reloc_(0),
-      dyn_reloc_count_(0)
+      dyn_reloc_count_(0),
+      call_graph_calls_()
   { }
 
   // During garbage collection, the Read_symbols_data pass for 
@@ -1156,6 +1218,33 @@ class Relobj : public Object
   scan_relocs(Symbol_table* symtab, Layout* layout, Read_relocs_data* rd)
   { return this->do_scan_relocs(symtab, layout, rd); }
 
+  // Record the calls between sections found in the relocs RD.  This
+  // is used by --call-graph-ordering when there is no profile.  It is
+  // called by the Read_relocs tasks, which run in parallel, so it
+  // only looks at this object; calls to global symbols are resolved
+  // later by Call_graph.
+  void
+  find_call_graph_edges(Read_relocs_data* rd)
+  { this->do_find_call_graph_edges(rd); }
+
+  // The calls recorded by find_call_graph_edges.
+  Call_graph_calls*
+  call_graph_calls()
+  { return &this->call_graph_calls_; }
+
+  // Return whether this object has an address-significance table.
+  // This is only looked for with --icf=safe.
+  bool
+  has_addrsig() const
+  { return this->do_has_addrsig(); }
+
+  // Record the sections whose addresses are significant according to
+  // the address-significance table as having their function pointers
+  // taken, for --icf=safe.
+  void
+  find_address_significant_sections(Symbol_table* symtab)
+  { this->do_find_address_significant_sections(symtab); }
+
   // Return the value of the local symbol whose index is SYMNDX, plus
   // ADDEND.  ADDEND is passed in so that we can correctly handle the
   // section symbol for a merge section.
@@ -1280,6 +1369,24 @@ class Relobj : public Object
   relocate(const Symbol_table* symtab, const Layout* layout, Output_file* of)
   { return this->do_relocate(symtab, layout, of); }
 
+  // Free the data which is no longer needed once the object has been
+  // relocated.
+  void
+  release_relocation_data()
+  { this->do_release_relocation_data(); }
+
+  // Record that something written after this object has been
+  // relocated, such as a dynamic relocation or a GOT entry, refers to
+  // its local symbols or to an offset in one of its input sections.
+  void
+  set_has_late_references()
+  { this->has_late_references_ = true; }
+
+  // Return whether set_has_late_references has been called.
+  bool
+  has_late_references() const
+  { return this->has_late_references_; }
+
   // Return whether an input section is being included in the link.
   bool
   is_section_included(unsigned int shndx) const
@@ -1314,6 +1421,12 @@ class Relobj : public Object
   Object_merge_map*
   get_or_create_merge_map();
 
+  // Return the merge map, or NULL if no section of this object has
+  // been merged.
+  Object_merge_map*
+  merge_map() const
+  { return this->object_merge_map_; }
+
   template<int size>
   void
   initialize_input_to_output_map(unsigned int shndx,
@@ -1394,6 +1507,23 @@ class Relobj : public Object
   virtual void
   do_scan_relocs(Symbol_table*, Layout*, Read_relocs_data*) = 0;
 
+  // Find the calls between sections.  Only regular object files
+  // provide any.
+  virtual void
+  do_find_call_graph_edges(Read_relocs_data*)
+  { }
+
+  // Return whether there is an address-significance table.  Only
+  // regular object files have one.
+  virtual bool
+  do_has_addrsig() const
+  { return false; }
+
+  // Record the address-significant sections.
+  virtual void
+  do_find_address_significant_sections(Symbol_table*)
+  { }
+
   // Return the value of a local symbol.
   virtual uint64_t
   do_local_symbol_value(unsigned int symndx, uint64_t addend) const = 0;
@@ -1458,6 +1588,12 @@ class Relobj : public Object
   virtual void
   do_relocate(const Symbol_table* symtab, const Layout*, Output_file* of) = 0;
 
+  // Free the data only needed for relocation--may be implemented by
+  // child class.
+  virtual void
+  do_release_relocation_data()
+  { }
+
   // Set the offset of a section--implemented by child class.
   virtual void
   do_set_section_offset(unsigned int shndx, uint64_t off) = 0;
@@ -1494,6 +1630,15 @@ class Relobj : public Object
       new std::vector<Relocatable_relocs*>(this->shnum());
   }
 
+  // Free the relocatable reloc info, once the relocs have been
+  // written.
+  void
+  release_relocatable_relocs();
+
+  // Free the mappings for merge sections.
+  void
+  release_merge_map();
+
   // Record that we must wait for the output sections to be written
   // before applying relocations.
   void
@@ -1562,6 +1707,8 @@ class Relobj : public Object
   // Whether we need to wait for output sections to be written before
   // we can apply relocations.
   bool relocs_must_follow_section_writes_;
+  // Whether data written after relocation refers to this object.
+  bool has_late_references_;
   // Used to store the relocs data computed by the Read_relocs pass. 
   // Used during garbage collection of unused sections.
   Read_relocs_data* rd_;
@@ -1577,6 +1724,8 @@ class Relobj : public Object
   unsigned int first_dyn_reloc_;
   // Count of dynamic relocations for this object.
   unsigned int dyn_reloc_count_;
+  // The calls found in the relocs for --call-graph-ordering.
+  Call_graph_calls call_graph_calls_;
 };
 
 // This class is used to handle relocations against a section symbol
@@ -2422,6 +2571,19 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   void
   do_scan_relocs(Symbol_table*, Layout*, Read_relocs_data*);
 
+  // Find the calls between sections.
+  void
+  do_find_call_graph_edges(Read_relocs_data*);
+
+  // Return whether there is an address-significance table.
+  bool
+  do_has_addrsig() const
+  { return this->addrsig_shndx_ != 0; }
+
+  // Record the address-significant sections.
+  void
+  do_find_address_significant_sections(Symbol_table*);
+
   // Count the local symbols.
   void
   do_count_local_symbols(Stringpool_template<char>*,
@@ -2443,6 +2605,10 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   void
   do_relocate(const Symbol_table* symtab, const Layout*, Output_file* of);
 
+  // Free the data only needed for relocation.
+  void
+  do_release_relocation_data();
+
   // Get the size of a section.
   uint64_t
   do_section_size(unsigned int shndx)
@@ -2661,7 +2827,13 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
 			  const unsigned char* symbol_names_data,
 			  section_size_type symbol_names_size,
 			  unsigned int shndx, const typename This::Shdr&,
-			  unsigned int reloc_shndx, unsigned int reloc_type);
+			  unsigned int reloc_shndx, unsigned int reloc_type,
+			  const Parsed_eh_frame_section* parsed);
+
+  // Parse the .eh_frame sections while reading symbols, recording the
+  // results in SD.
+  void
+  parse_eh_frame_sections(Read_symbols_data* sd);
 
   // Layout an input .note.gnu.property section.
   void
@@ -2867,6 +3039,9 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   Local_plt_offsets local_plt_offsets_;
   // Table mapping discarded comdat sections to corresponding kept sections.
   Kept_comdat_section_table kept_comdat_sections_;
+  // The index of the address-significance table, or 0 if there is
+  // none or we are not looking for one.
+  unsigned int addrsig_shndx_;
   // Whether this object has a GNU style .eh_frame section.
   bool has_eh_frame_;
   // True if the layout of this object was deferred, waiting for plugin
@@ -1329,6 +1329,19 @@ General_options::finalize()
 		 "[0.0, 1.0)"),
 	       this->hash_bucket_empty_fraction());
 
+  // --hugepage-size implies --hugepage-text.
+  if (this->user_set_hugepage_size())
+    {
+      uint64_t hugepage_size = this->hugepage_size();
+      if (hugepage_size == 0 || (hugepage_size & (hugepage_size - 1)) != 0)
+	gold_fatal(_("--hugepage-size value 0x%llx is not a power of two"),
+		   static_cast<unsigned long long>(hugepage_size));
+      this->set_hugepage_text(true);
+    }
+
+  if (this->hugepage_text() && this->relocatable())
+    gold_fatal(_("--hugepage-text and -r are incompatible"));
+
   if (this->implicit_incremental_ && this->incremental_mode_ == INCREMENTAL_OFF)
     gold_fatal(_("Options --incremental-changed, --incremental-unchanged, "
 		 "--incremental-unknown require the use of --incremental"));
@@ -1366,12 +1379,37 @@ General_options::finalize()
 			 "incremental link"));
 	  this->set_compress_debug_sections("none");
 	}
+      if (this->call_graph_ordering() || this->call_graph_profile() != NULL)
+	{
+	  gold_warning(_("ignoring --call-graph-ordering for an "
+			 "incremental link"));
+	  this->set_call_graph_ordering(false);
+	  this->set_call_graph_profile(NULL);
+	}
+      if (strcmp(this->pack_dyn_relocs(), "none") != 0)
+	{
+	  gold_warning(_("ignoring --pack-dyn-relocs for an incremental link"));
+	  this->set_pack_dyn_relocs("none");
+	}
+      if (this->hugepage_text())
+	{
+	  gold_warning(_("ignoring --hugepage-text for an incremental link"));
+	  this->set_hugepage_text(false);
+	}
     }
 
+  // --call-graph-profile implies --call-graph-ordering.
+  if (this->call_graph_profile() != NULL)
+    this->set_call_graph_ordering(true);
+
   // --rosegment-gap implies --rosegment.
   if (this->user_set_rosegment_gap())
     this->set_rosegment(true);
 
+  // --hugepage-text needs .text.hot in an output section of its own.
+  if (this->hugepage_text())
+    this->set_keep_text_section_prefix(true);
+
   // FIXME: we can/should be doing a lot more sanity checking here.
 }
 
@@ -755,6 +755,13 @@ class General_options
 
   // c
 
+  DEFINE_bool(call_graph_ordering, options::TWO_DASHES, '\0', false,
+	      N_("Order executable sections using the call graph"),
+	      N_("Do not order executable sections using the call graph"));
+  DEFINE_string(call_graph_profile, options::TWO_DASHES, '\0', NULL,
+		N_("Read call counts for --call-graph-ordering from FILENAME"),
+		N_("FILENAME"));
+
   DEFINE_bool(check_sections, options::TWO_DASHES, '\0', true,
 	      N_("Check segment addresses for overlaps"),
 	      N_("Do not check segment addresses for overlaps"));
@@ -790,6 +797,11 @@ class General_options
 		N_("Turn on debugging"),
 		N_("[all,files,script,task][,...]"));
 
+  DEFINE_uint64(decompressed_section_cache_size, options::TWO_DASHES, '\0',
+		256 << 20,
+		N_("Maximum memory used to keep decompressed debug sections"),
+		N_("SIZE"));
+
   DEFINE_special(defsym, options::TWO_DASHES, '\0',
 		 N_("Define a symbol"), N_("SYMBOL=EXPRESSION"));
 
@@ -933,6 +945,13 @@ class General_options
 	      N_("Dynamic hash style"), N_("[sysv,gnu,both]"),
 	      {"sysv", "gnu", "both"});
 
+  DEFINE_bool(hugepage_text, options::TWO_DASHES, '\0', false,
+	      N_("Align and pad hot text and the text segment to huge pages"),
+	      N_("Do not align text to huge pages (default)"));
+  DEFINE_uint64(hugepage_size, options::TWO_DASHES, '\0', 0x200000,
+		N_("Set the huge page size used by --hugepage-text"),
+		N_("SIZE"));
+
   // i
 
   DEFINE_bool_alias(i, relocatable, options::EXACTLY_ONE_DASH, '\0',
@@ -1055,8 +1074,8 @@ class General_options
 	      N_("Page align data, make text readonly"));
 
   DEFINE_bool(no_keep_memory, options::TWO_DASHES, '\0', false,
-	      N_("Use less memory and more disk I/O "
-		 "(included only for compatibility with GNU ld)"), NULL);
+	      N_("Use less memory and more disk I/O: release input file "
+		 "views as soon as they are used"), NULL);
 
   DEFINE_bool_alias(no_undefined, defs, options::TWO_DASHES, '\0',
 		    N_("Report undefined symbols (even with --shared)"),
@@ -1089,6 +1108,11 @@ class General_options
   DEFINE_bool(p, options::ONE_DASH, 'p', false,
 	      N_("Ignored for ARM compatibility"), NULL);
 
+  DEFINE_enum(pack_dyn_relocs, options::TWO_DASHES, '\0', "none",
+	      N_("Pack dynamic relocations in the given format"),
+	      N_("[none,relr]"),
+	      {"none", "relr"});
+
   DEFINE_bool(pie, options::ONE_DASH, '\0', false,
 	      N_("Create a position independent executable"),
 	      N_("Do not create a position independent executable"));
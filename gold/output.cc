@@ -30,10 +30,6 @@
 #include <sys/stat.h>
 #include <algorithm>
 
-#ifdef HAVE_SYS_MMAN_H
-#include <sys/mman.h>
-#endif
-
 #include "libiberty.h"
 
 #include "dwarf.h"
@@ -45,57 +41,7 @@
 #include "descriptors.h"
 #include "layout.h"
 #include "output.h"
-
-// For systems without mmap support.
-#ifndef HAVE_MMAP
-# define mmap gold_mmap
-# define munmap gold_munmap
-# define mremap gold_mremap
-# ifndef MAP_FAILED
-#  define MAP_FAILED (reinterpret_cast<void*>(-1))
-# endif
-# ifndef PROT_READ
-#  define PROT_READ 0
-# endif
-# ifndef PROT_WRITE
-#  define PROT_WRITE 0
-# endif
-# ifndef MAP_PRIVATE
-#  define MAP_PRIVATE 0
-# endif
-# ifndef MAP_ANONYMOUS
-#  define MAP_ANONYMOUS 0
-# endif
-# ifndef MAP_SHARED
-#  define MAP_SHARED 0
-# endif
-
-# ifndef ENOSYS
-#  define ENOSYS EINVAL
-# endif
-
-static void *
-gold_mmap(void *, size_t, int, int, int, off_t)
-{
-  errno = ENOSYS;
-  return MAP_FAILED;
-}
-
-static int
-gold_munmap(void *, size_t)
-{
-  errno = ENOSYS;
-  return -1;
-}
-
-static void *
-gold_mremap(void *, size_t, size_t, int)
-{
-  errno = ENOSYS;
-  return MAP_FAILED;
-}
-
-#endif
+#include "gold-mmap.h"
 
 #if defined(HAVE_MMAP) && !defined(HAVE_MREMAP)
 # define mremap gold_mremap
@@ -757,6 +703,7 @@ Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::Output_reloc(
   gold_assert(this->type_ == type);
   this->u1_.gsym = gsym;
   this->u2_.relobj = relobj;
+  relobj->set_has_late_references();
   if (dynamic)
     this->set_needs_dynsym_index();
 }
@@ -784,6 +731,7 @@ Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::Output_reloc(
   // this->type_ is a bitfield; make sure TYPE fits.
   gold_assert(this->type_ == type);
   this->u1_.relobj = relobj;
+  relobj->set_has_late_references();
   this->u2_.od = od;
   if (dynamic)
     this->set_needs_dynsym_index();
@@ -812,6 +760,7 @@ Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::Output_reloc(
   gold_assert(this->type_ == type);
   this->u1_.relobj = relobj;
   this->u2_.relobj = relobj;
+  relobj->set_has_late_references();
   if (dynamic)
     this->set_needs_dynsym_index();
 }
@@ -856,6 +805,7 @@ Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::Output_reloc(
   gold_assert(this->type_ == type);
   this->u1_.os = os;
   this->u2_.relobj = relobj;
+  relobj->set_has_late_references();
   if (dynamic)
     this->set_needs_dynsym_index();
   else
@@ -896,6 +846,7 @@ Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::Output_reloc(
   gold_assert(this->type_ == type);
   this->u1_.relobj = NULL;
   this->u2_.relobj = relobj;
+  relobj->set_has_late_references();
 }
 
 // A target specific relocation.
@@ -932,6 +883,7 @@ Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::Output_reloc(
   gold_assert(this->type_ == type);
   this->u1_.arg = arg;
   this->u2_.relobj = relobj;
+  relobj->set_has_late_references();
 }
 
 // Record that we need a dynamic symbol index for this relocation.
@@ -1130,6 +1082,17 @@ Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::write(
   this->write_rel(&orel);
 }
 
+// Write out a Rel relocation in host byte order.
+
+template<bool dynamic, int size, bool big_endian>
+void
+Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::write_host(
+    unsigned char* pov) const
+{
+  elfcpp::Rel_write<size, elfcpp::Endian::host_big_endian> orel(pov);
+  this->write_rel(&orel);
+}
+
 // Get the value of the symbol referred to by a Rel relocation.
 
 template<bool dynamic, int size, bool big_endian>
@@ -1216,15 +1179,13 @@ Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>::
   return 0;
 }
 
-// Write out a Rela relocation.
+// Return the addend of a Rela relocation as written to the output.
 
 template<bool dynamic, int size, bool big_endian>
-void
-Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>::write(
-    unsigned char* pov) const
+typename Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>::Addend
+Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>::output_addend()
+    const
 {
-  elfcpp::Rela_write<size, big_endian> orel(pov);
-  this->rel_.write_rel(&orel);
   Addend addend = this->addend_;
   if (this->rel_.is_target_specific())
     addend = parameters->target().reloc_addend(this->rel_.target_arg(),
@@ -1233,7 +1194,31 @@ Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>::write(
     addend = this->rel_.symbol_value(addend);
   else if (this->rel_.is_local_section_symbol())
     addend = this->rel_.local_section_offset(addend);
-  orel.put_r_addend(addend);
+  return addend;
+}
+
+// Write out a Rela relocation.
+
+template<bool dynamic, int size, bool big_endian>
+void
+Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>::write(
+    unsigned char* pov) const
+{
+  elfcpp::Rela_write<size, big_endian> orel(pov);
+  this->rel_.write_rel(&orel);
+  orel.put_r_addend(this->output_addend());
+}
+
+// Write out a Rela relocation in host byte order.
+
+template<bool dynamic, int size, bool big_endian>
+void
+Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>::write_host(
+    unsigned char* pov) const
+{
+  elfcpp::Rela_write<size, elfcpp::Endian::host_big_endian> orel(pov);
+  this->rel_.write_rel(&orel);
+  orel.put_r_addend(this->output_addend());
 }
 
 // Output_data_reloc_base methods.
@@ -1277,15 +1262,200 @@ struct Output_reloc_writer
   { p->write(pov); }
 };
 
-// Write out relocation data.
+// Relocation writer which writes the entry in host byte order, for
+// targets whose byte order differs from the host's.
+
+template<int sh_type, bool dynamic, int size, bool big_endian>
+struct Output_reloc_host_writer
+{
+  typedef Output_reloc<sh_type, dynamic, size, big_endian> Output_reloc_type;
+  typedef std::vector<Output_reloc_type> Relocs;
+
+  static void
+  write(typename Relocs::const_iterator p, unsigned char* pov)
+  { p->write_host(pov); }
+};
+
+// Write out relocation data.  All the fields of a standard Rel or
+// Rela entry are SIZE bits wide, so when the target byte order
+// differs from the host's we write the entries in host order and
+// then swap the whole section in one pass.
 
 template<int sh_type, bool dynamic, int size, bool big_endian>
 void
 Output_data_reloc_base<sh_type, dynamic, size, big_endian>::do_write(
     Output_file* of)
 {
-  typedef Output_reloc_writer<sh_type, dynamic, size, big_endian> Writer;
-  this->do_write_generic<Writer>(of);
+  if (big_endian == elfcpp::Endian::host_big_endian)
+    {
+      typedef Output_reloc_writer<sh_type, dynamic, size, big_endian> Writer;
+      this->do_write_generic<Writer>(of);
+    }
+  else
+    {
+      typedef Output_reloc_host_writer<sh_type, dynamic, size, big_endian>
+	Writer;
+      this->do_write_generic<Writer>(of, true);
+    }
+}
+
+// Class Output_data_relr.
+
+// Return whether the word at offset ADDRESS within OD can be
+// relocated by a RELR entry.  The word must be aligned, and it must
+// be in a writable section.  We don't pack relocations in read-only
+// sections so that they still show up as text relocations.
+
+template<int size, bool big_endian>
+bool
+Output_data_relr<size, big_endian>::is_packable(Output_data* od,
+						 Address address) const
+{
+  if (address % (size / 8) != 0)
+    return false;
+  Output_section* os = od->output_section();
+  return os != NULL && (os->flags() & elfcpp::SHF_WRITE) != 0;
+}
+
+// Add a RELATIVE relocation against the word at offset ADDRESS within
+// OD.
+
+template<int size, bool big_endian>
+bool
+Output_data_relr<size, big_endian>::add(unsigned int type, Output_data* od,
+					 Address address)
+{
+  if (od->addralign() < size / 8 || !this->is_packable(od, address))
+    return false;
+  this->add_reloc(od, Reloc(type, od, address, true));
+  return true;
+}
+
+// Add a RELATIVE relocation against the word at offset ADDRESS within
+// section SHNDX of RELOBJ.  Merged sections are not packed, since we
+// do not know where their contents will end up.
+
+template<int size, bool big_endian>
+bool
+Output_data_relr<size, big_endian>::add(
+    unsigned int type,
+    Output_data* od,
+    Sized_relobj<size, big_endian>* relobj,
+    unsigned int shndx,
+    Address address)
+{
+  if (relobj->is_output_section_offset_invalid(shndx)
+      || !this->is_packable(od, address)
+      || relobj->section_addralign(shndx) < size / 8)
+    return false;
+  this->add_reloc(od, Reloc(type, relobj, shndx, address, true));
+  return true;
+}
+
+template<int size, bool big_endian>
+void
+Output_data_relr<size, big_endian>::add_reloc(Output_data* od,
+					       const Reloc& reloc)
+{
+  if (this->relocs_.empty())
+    this->layout_->add_output_section_data(".relr.dyn", elfcpp::SHT_RELR,
+					   elfcpp::SHF_ALLOC, this,
+					   ORDER_DYNAMIC_RELOCS, false);
+  size_t old_capacity = this->relocs_.capacity();
+  this->relocs_.push_back(reloc);
+  Memory_stats::resize(Memory_stats::RELOCS,
+		       old_capacity * sizeof(Reloc),
+		       this->relocs_.capacity() * sizeof(Reloc));
+  od->add_dynamic_reloc();
+}
+
+// Encode the relocations.  Each address is written as a word, and
+// may be followed by bitmap words, which have the low bit set.  Bit N
+// of the first bitmap, counting from 1, relocates the Nth word after
+// the address; each later bitmap continues where the previous one
+// stopped.  If the encoding is smaller than the space reserved for
+// it, pad it with bitmaps which relocate nothing, so that the size of
+// the section does not change; otherwise reserve more space and
+// return true.
+
+template<int size, bool big_endian>
+bool
+Output_data_relr<size, big_endian>::encode_relocs()
+{
+  const Address wordsize = size / 8;
+  const unsigned int nbits = size - 1;
+
+  std::vector<Address> addrs;
+  addrs.reserve(this->relocs_.size());
+  for (typename std::vector<Reloc>::const_iterator p = this->relocs_.begin();
+       p != this->relocs_.end();
+       ++p)
+    {
+      Address addr = p->get_address();
+      gold_assert(addr % wordsize == 0);
+      addrs.push_back(addr);
+    }
+  std::sort(addrs.begin(), addrs.end());
+  addrs.erase(std::unique(addrs.begin(), addrs.end()), addrs.end());
+
+  std::vector<Address> entries;
+  size_t i = 0;
+  while (i < addrs.size())
+    {
+      entries.push_back(addrs[i]);
+      Address base = addrs[i] + wordsize;
+      ++i;
+      while (true)
+	{
+	  Address bitmap = 0;
+	  while (i < addrs.size() && addrs[i] - base < nbits * wordsize)
+	    {
+	      bitmap |= static_cast<Address>(1) << ((addrs[i] - base)
+						    / wordsize);
+	      ++i;
+	    }
+	  if (bitmap == 0)
+	    break;
+	  entries.push_back((bitmap << 1) | 1);
+	  base += nbits * wordsize;
+	}
+    }
+
+  bool grew = entries.size() > this->entries_.size();
+  if (!grew)
+    entries.resize(this->entries_.size(), 1);
+  this->entries_.swap(entries);
+  return grew;
+}
+
+// Set the entry size of the output section.
+
+template<int size, bool big_endian>
+void
+Output_data_relr<size, big_endian>::do_adjust_output_section(
+    Output_section* os)
+{
+  os->set_entsize(size / 8);
+}
+
+// Write out the encoded relocations.
+
+template<int size, bool big_endian>
+void
+Output_data_relr<size, big_endian>::do_write(Output_file* of)
+{
+  const off_t off = this->offset();
+  const section_size_type oview_size =
+    convert_to_section_size_type(this->data_size());
+  unsigned char* const oview = of->get_output_view(off, oview_size);
+
+  gold_assert(this->entries_.size() * (size / 8) == oview_size);
+  if (!this->entries_.empty())
+    elfcpp::Swap_array<size, big_endian>::writevals(oview,
+						    &this->entries_[0],
+						    this->entries_.size());
+
+  of->write_output_view(off, oview_size, oview);
 }
 
 // Class Output_relocatable_relocs.
@@ -1325,14 +1495,14 @@ Output_data_group<size, big_endian>::do_write(Output_file* of)
     convert_to_section_size_type(this->data_size());
   unsigned char* const oview = of->get_output_view(off, oview_size);
 
-  elfcpp::Elf_Word* contents = reinterpret_cast<elfcpp::Elf_Word*>(oview);
-  elfcpp::Swap<32, big_endian>::writeval(contents, this->flags_);
-  ++contents;
+  std::vector<elfcpp::Elf_Word> contents;
+  contents.reserve(this->input_shndxes_.size() + 1);
+  contents.push_back(this->flags_);
 
   for (std::vector<unsigned int>::const_iterator p =
 	 this->input_shndxes_.begin();
        p != this->input_shndxes_.end();
-       ++p, ++contents)
+       ++p)
     {
       Output_section* os = this->relobj_->output_section(*p);
 
@@ -1346,11 +1516,12 @@ Output_data_group<size, big_endian>::do_write(Output_file* of)
 	  output_shndx = 0;
 	}
 
-      elfcpp::Swap<32, big_endian>::writeval(contents, output_shndx);
+      contents.push_back(output_shndx);
     }
 
-  size_t wrote = reinterpret_cast<unsigned char*>(contents) - oview;
-  gold_assert(wrote == oview_size);
+  gold_assert(contents.size() * 4 == oview_size);
+  elfcpp::Swap_array<32, big_endian>::writevals(oview, &contents[0],
+						contents.size());
 
   of->write_output_view(off, oview_size, oview);
 
@@ -2396,6 +2567,7 @@ Output_section::Output_section(const char* name, elfcpp::Elf_Word type,
     free_list_(),
     free_space_fill_(NULL),
     patch_space_(0),
+    end_alignment_(0),
     reloc_section_(NULL)
 {
   // An unallocated section has no address.  Forcing this means that
@@ -2555,6 +2727,7 @@ Output_section::add_input_section(Layout* layout,
 	  std::string fill_data(parameters->target().code_fill(fill_len));
 	  Output_data_const* odc = new Output_data_const(fill_data, 1);
 	  this->input_sections_.push_back(Input_section(odc));
+	  this->input_sections_changed();
 	}
     }
 
@@ -2588,6 +2761,7 @@ Output_section::add_input_section(Layout* layout,
 	    }
 	}
       this->input_sections_.push_back(isecn);
+      this->input_sections_changed();
     }
 
   return aligned_offset_in_section;
@@ -2689,6 +2863,7 @@ Output_section::add_output_section_data(Input_section* inp)
     this->first_input_offset_ = this->current_data_size_for_child();
 
   this->input_sections_.push_back(*inp);
+  this->input_sections_changed();
 
   uint64_t addralign = inp->addralign();
   if (addralign > this->addralign_)
@@ -2885,6 +3060,7 @@ Output_section::convert_input_sections_to_relaxed_sections(
 	    relaxed_sections,
 	    map,
 	    &this->input_sections_);
+  this->input_sections_changed();
 
   // Update fast look-up map.
   if (this->lookup_maps_->is_valid())
@@ -3178,17 +3354,37 @@ Output_section::set_final_data_size()
 
       uint64_t address = this->address();
       off_t startoff = this->offset();
-      off_t off = this->first_input_offset_;
-      for (Input_section_list::iterator p = this->input_sections_.begin();
-	   p != this->input_sections_.end();
-	   ++p)
+      data_size = this->set_input_section_addresses_from_layout(address,
+								startoff);
+      if (data_size < 0)
 	{
-	  off = align_address(off, p->addralign());
-	  p->set_address_and_file_offset(address + off, startoff + off,
-					 startoff);
-	  off += p->data_size();
+	  // During relaxation, save the positions of the input sections
+	  // which are not plain input sections, so that the next pass
+	  // can reuse this layout if nothing in this section changes.
+	  Checkpoint_output_section::Input_positions* positions =
+	    (this->checkpoint_ != NULL
+	     ? this->checkpoint_->start_layout()
+	     : NULL);
+	  off_t off = this->first_input_offset_;
+	  for (Input_section_list::iterator p = this->input_sections_.begin();
+	       p != this->input_sections_.end();
+	       ++p)
+	    {
+	      off = align_address(off, p->addralign());
+	      p->set_address_and_file_offset(address + off, startoff + off,
+					     startoff);
+	      if (positions != NULL && !p->is_input_section())
+		positions->push_back(
+		    Checkpoint_output_section::Input_position(
+			p - this->input_sections_.begin(), off,
+			p->data_size(), p->addralign()));
+	      off += p->data_size();
+	    }
+	  data_size = off;
+	  if (positions != NULL)
+	    this->checkpoint_->finish_layout(this->first_input_offset_,
+					     data_size);
 	}
-      data_size = off;
     }
 
   // For full incremental links, we want to allocate some patch space
@@ -3210,9 +3406,56 @@ Output_section::set_final_data_size()
       data_size = new_size;
     }
 
+  if (this->end_alignment_ != 0)
+    data_size = align_address(data_size, this->end_alignment_);
+
   this->set_data_size(data_size);
 }
 
+// Set the addresses of the input sections from the layout saved by the
+// last relaxation pass.  Plain input sections are placed by their
+// offset from the start of the output section, which does not change
+// unless the size or alignment of an earlier input section does.  So
+// we only need to place the other input sections, and check that they
+// have not changed.  Return -1 if the layout can not be reused.
+
+off_t
+Output_section::set_input_section_addresses_from_layout(uint64_t address,
+							off_t startoff)
+{
+  if (this->checkpoint_ == NULL
+      || !this->checkpoint_->has_layout()
+      || (this->checkpoint_->layout_first_input_offset()
+	  != this->first_input_offset_))
+    return -1;
+
+  typedef Checkpoint_output_section::Input_positions Input_positions;
+  const Input_positions& positions(this->checkpoint_->layout_positions());
+  for (Input_positions::const_iterator p = positions.begin();
+       p != positions.end();
+       ++p)
+    {
+      Input_section& is(this->input_sections_[p->index]);
+      if (is.addralign() == p->addralign)
+	{
+	  is.set_address_and_file_offset(address + p->offset,
+					 startoff + p->offset, startoff);
+	  if (is.data_size() == p->data_size)
+	    continue;
+	  ++p;
+	}
+
+      // Something changed.  Undo what we have done so far.
+      for (Input_positions::const_iterator q = positions.begin();
+	   q != p;
+	   ++q)
+	this->input_sections_[q->index].reset_address_and_file_offset();
+      return -1;
+    }
+
+  return this->checkpoint_->layout_data_size();
+}
+
 // Reset the address and file offset.
 
 void
@@ -3225,10 +3468,24 @@ Output_section::do_reset_address_and_file_offset()
   if (((this->flags_ & elfcpp::SHF_ALLOC) == 0) && !this->is_noload_)
      this->set_address(0);
 
-  for (Input_section_list::iterator p = this->input_sections_.begin();
-       p != this->input_sections_.end();
-       ++p)
-    p->reset_address_and_file_offset();
+  // Only input sections which are not plain input sections have an
+  // address to reset.  If we saved a layout, we know where they are.
+  if (this->checkpoint_ != NULL && this->checkpoint_->has_layout())
+    {
+      typedef Checkpoint_output_section::Input_positions Input_positions;
+      const Input_positions& positions(this->checkpoint_->layout_positions());
+      for (Input_positions::const_iterator p = positions.begin();
+	   p != positions.end();
+	   ++p)
+	this->input_sections_[p->index].reset_address_and_file_offset();
+    }
+  else
+    {
+      for (Input_section_list::iterator p = this->input_sections_.begin();
+	   p != this->input_sections_.end();
+	   ++p)
+	p->reset_address_and_file_offset();
+    }
 
   // Remove any patch space that was added in set_final_data_size.
   if (this->patch_space_ > 0)
@@ -3672,6 +3929,15 @@ Output_section::sort_attached_input_sections()
        p != sort_list.end();
        ++p)
     this->input_sections_.push_back(p->input_section());
+  this->input_sections_changed();
+
+  // During relaxation, keep the sorted list so that restore_states
+  // does not undo the sort.
+  if (this->checkpoint_ != NULL
+      && (this->input_sections_.size()
+	  == this->checkpoint_->input_sections_size()))
+    this->checkpoint_->save_sorted_input_sections();
+
   sort_list.clear();
 
   // Remember that we sorted the input sections, since we might get
@@ -3764,6 +4030,17 @@ Output_section::do_write(Output_file* of)
       off = aligned_off + p->data_size();
     }
 
+  // Fill the padding added by set_end_alignment.
+  if (this->end_alignment_ != 0 && !this->input_sections_.empty())
+    {
+      off_t end = this->offset() + this->data_size();
+      if (off < end)
+	{
+	  std::string fill_data(parameters->target().code_fill(end - off));
+	  of->write(off, fill_data.data(), fill_data.size());
+	}
+    }
+
   // For incremental links, fill in unused chunks in debug sections
   // with dummy compilation unit headers.
   if (this->free_space_fill_ != NULL)
@@ -3917,6 +4194,7 @@ Output_section::get_input_sections(
     }
 
   this->input_sections_.swap(remaining);
+  this->input_sections_changed();
   this->first_input_offset_ = 0;
 
   uint64_t data_size = address - orig_address;
@@ -3945,6 +4223,7 @@ Output_section::add_script_input_section(const Input_section& sis)
 					+ data_size);
 
   this->input_sections_.push_back(sis);
+  this->input_sections_changed();
 
   // Update fast lookup maps if necessary.
   if (this->lookup_maps_->is_valid())
@@ -4001,15 +4280,22 @@ Output_section::restore_states()
       // If we have not copied the input sections, just resize it.
       size_t old_size = checkpoint->input_sections_size();
       gold_assert(this->input_sections_.size() >= old_size);
-      this->input_sections_.resize(old_size);
+      if (this->input_sections_.size() != old_size)
+	{
+	  this->input_sections_.resize(old_size);
+	  this->input_sections_changed();
+	}
     }
-  else
+  else if (!checkpoint->input_sections_restored())
     {
       // We need to copy the whole list.  This is not efficient for
       // extremely large output with hundreads of thousands of input
       // objects.  We may need to re-think how we should pass sections
-      // to scripts.
+      // to scripts.  We avoid the copy if the list has not changed
+      // since the last time we restored it.
       this->input_sections_ = *checkpoint->input_sections();
+      this->input_sections_changed();
+      checkpoint->set_input_sections_restored();
     }
 
   this->attached_input_sections_are_sorted_ =
@@ -5579,6 +5865,26 @@ template
 class Output_relocatable_relocs<elfcpp::SHT_RELA, 64, true>;
 #endif
 
+#ifdef HAVE_TARGET_32_LITTLE
+template
+class Output_data_relr<32, false>;
+#endif
+
+#ifdef HAVE_TARGET_32_BIG
+template
+class Output_data_relr<32, true>;
+#endif
+
+#ifdef HAVE_TARGET_64_LITTLE
+template
+class Output_data_relr<64, false>;
+#endif
+
+#ifdef HAVE_TARGET_64_BIG
+template
+class Output_data_relr<64, true>;
+#endif
+
 #ifdef HAVE_TARGET_32_LITTLE
 template
 class Output_data_group<32, false>;
@@ -31,6 +31,7 @@
 #include "mapfile.h"
 #include "layout.h"
 #include "reloc-types.h"
+#include "memstats.h"
 
 namespace gold
 {
@@ -1258,6 +1259,10 @@ class Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>
   void
   write(unsigned char* pov) const;
 
+  // Write the reloc entry to an output view in host byte order.
+  void
+  write_host(unsigned char* pov) const;
+
   // Write the offset and info fields to Write_rel.
   template<typename Write_rel>
   void write_rel(Write_rel*) const;
@@ -1478,6 +1483,10 @@ class Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
   void
   write(unsigned char* pov) const;
 
+  // Write the reloc entry to an output view in host byte order.
+  void
+  write_host(unsigned char* pov) const;
+
   // Return whether this reloc should be sorted before the argument
   // when sorting dynamic relocs.
   bool
@@ -1494,12 +1503,122 @@ class Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
   }
 
  private:
+  // Return the addend to write out for this reloc.
+  Addend
+  output_addend() const;
+
   // The basic reloc.
   Output_reloc<elfcpp::SHT_REL, dynamic, size, big_endian> rel_;
   // The addend.
   Addend addend_;
 };
 
+// Output_data_relr_generic is a non-template base class for
+// Output_data_relr.  This gives Layout a way to hold a pointer to the
+// packed relocations.
+
+class Output_data_relr_generic : public Output_section_data
+{
+ public:
+  Output_data_relr_generic(uint64_t addralign)
+    : Output_section_data(addralign)
+  { }
+
+  // Encode the relocations, once every section has an address.
+  // Return true if the encoding does not fit in the space reserved by
+  // the last layout, in which case the space is increased and the
+  // sections must be laid out again.
+  virtual bool
+  encode_relocs() = 0;
+};
+
+// Output_data_relr is used for --pack-dyn-relocs=relr.  It holds
+// RELATIVE relocations in the compact SHT_RELR format, which records
+// only the addresses of the words to relocate.  The link time value
+// already stored in each word serves as the addend.  Like the other
+// dynamic relocations, the section is read-only and precedes the
+// writable data which it relocates.  The size of the encoding depends
+// on the distances between those words, though, so Layout::finalize
+// lays the sections out again whenever the encoding outgrows the
+// space reserved for it.  The space never shrinks; what is not needed
+// is filled with empty bitmap words, which relocate nothing.
+
+template<int size, bool big_endian>
+class Output_data_relr : public Output_data_relr_generic
+{
+ public:
+  typedef typename elfcpp::Elf_types<size>::Elf_Addr Address;
+
+  Output_data_relr(Layout* layout)
+    : Output_data_relr_generic(size / 8), layout_(layout), relocs_(),
+      entries_()
+  { }
+
+  // Add a RELATIVE relocation of type TYPE for the word at offset
+  // ADDRESS within OD.  This returns false if the relocation can not
+  // be packed, in which case the caller must emit an ordinary
+  // relocation.
+  bool
+  add(unsigned int type, Output_data* od, Address address);
+
+  // Likewise, for the word at offset ADDRESS within section SHNDX of
+  // RELOBJ.  OD is the output section.
+  bool
+  add(unsigned int type, Output_data* od,
+      Sized_relobj<size, big_endian>* relobj, unsigned int shndx,
+      Address address);
+
+  // Return the number of relocations which were packed.
+  size_t
+  reloc_count() const
+  { return this->relocs_.size(); }
+
+  // Encode the relocations.
+  bool
+  encode_relocs();
+
+ protected:
+  // Set the size to the space reserved by the last layout.
+  void
+  set_final_data_size()
+  { this->set_data_size(this->entries_.size() * (size / 8)); }
+
+  // Write out the data.
+  void
+  do_write(Output_file*);
+
+  // Set the entry size.
+  void
+  do_adjust_output_section(Output_section* os);
+
+  // Write to a map file.
+  void
+  do_print_to_mapfile(Mapfile* mapfile) const
+  { mapfile->print_output_data(this, _("** packed relative relocs")); }
+
+ private:
+  // The relocations only need an address, so we store them as REL
+  // relocations without a symbol.
+  typedef Output_reloc<elfcpp::SHT_REL, true, size, big_endian> Reloc;
+
+  // Return whether a word in OD can be relocated through this
+  // section.
+  bool
+  is_packable(Output_data* od, Address address) const;
+
+  // Record RELOC, attaching this section to the output file the first
+  // time.
+  void
+  add_reloc(Output_data* od, const Reloc& reloc);
+
+  // The layout, used to create the output section.
+  Layout* layout_;
+  // The packed relocations.
+  std::vector<Reloc> relocs_;
+  // The encoded section contents, padded to the reserved size.
+  std::vector<Address> entries_;
+};
+
 // Output_data_reloc_generic is a non-template base class for
 // Output_data_reloc_base.  This gives the generic code a way to hold
 // a pointer to a reloc section.
@@ -1614,9 +1733,13 @@ class Output_data_reloc_base : public Output_data_reloc_generic
 
   // Generic implementation of do_write, allowing a customized
   // class for writing the output relocation (e.g., for MIPS-64).
+  // If HOST_ORDER is true, Output_reloc_writer writes each field in
+  // host byte order, and the whole view is converted to target byte
+  // order at the end; every field of the entry must then be SIZE
+  // bits wide.
   template<class Output_reloc_writer>
   void
-  do_write_generic(Output_file* of)
+  do_write_generic(Output_file* of, bool host_order = false)
   {
     const off_t off = this->offset();
     const off_t oview_size = this->data_size();
@@ -1640,6 +1763,10 @@ class Output_data_reloc_base : public Output_data_reloc_generic
 
     gold_assert(pov - oview == oview_size);
 
+    if (host_order)
+      elfcpp::Swap_array<size, big_endian>::convert(oview,
+						    oview_size / (size / 8));
+
     of->write_output_view(off, oview_size, oview);
 
     // We no longer need the relocation entries.
@@ -1664,7 +1791,11 @@ class Output_data_reloc_base : public Output_data_reloc_generic
   void
   add(Output_data* od, const Output_reloc_type& reloc)
   {
+    size_t old_capacity = this->relocs_.capacity();
     this->relocs_.push_back(reloc);
+    Memory_stats::resize(Memory_stats::RELOCS,
+			 old_capacity * sizeof(Output_reloc_type),
+			 this->relocs_.capacity() * sizeof(Output_reloc_type));
     this->set_current_data_size(this->relocs_.size() * reloc_size);
     if (dynamic)
       od->add_dynamic_reloc();
@@ -2025,9 +2156,25 @@ class Output_data_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
   typedef typename Output_reloc_type::Addend Addend;
 
   Output_data_reloc(bool sr)
-    : Output_data_reloc_base<elfcpp::SHT_RELA, dynamic, size, big_endian>(sr)
+    : Output_data_reloc_base<elfcpp::SHT_RELA, dynamic, size, big_endian>(sr),
+      relr_(NULL), relr_type_(0)
   { }
 
+  // Pack the RELATIVE relocations of type TYPE into RELR when
+  // possible, rather than adding them to this section.
+  void
+  set_relr(Output_data_relr<size, big_endian>* relr, unsigned int type)
+  {
+    gold_assert(dynamic);
+    this->relr_ = relr;
+    this->relr_type_ = type;
+  }
+
+  // Return the RELR section, or NULL.
+  Output_data_relr<size, big_endian>*
+  relr() const
+  { return this->relr_; }
+
   // Add a reloc against a global symbol.
 
   void
@@ -2080,6 +2227,8 @@ class Output_data_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
   add_global_relative(Symbol* gsym, unsigned int type, Output_data* od,
 		      Address address, Addend addend, bool use_plt_offset)
   {
+    if (!use_plt_offset && this->add_relr(type, od, address))
+      return;
     this->add(od, Output_reloc_type(gsym, type, od, address, addend, true,
 				    true, use_plt_offset));
   }
@@ -2090,6 +2239,9 @@ class Output_data_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
 		      unsigned int shndx, Address address, Addend addend,
 		      bool use_plt_offset)
   {
+    if (!use_plt_offset
+	&& this->add_relr(type, od, relobj, shndx, address))
+      return;
     this->add(od, Output_reloc_type(gsym, type, relobj, shndx, address,
 				    addend, true, true, use_plt_offset));
   }
@@ -2172,6 +2324,8 @@ class Output_data_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
 		     Output_data* od, Address address, Addend addend,
 		     bool use_plt_offset)
   {
+    if (!use_plt_offset && this->add_relr(type, od, address))
+      return;
     this->add(od, Output_reloc_type(relobj, local_sym_index, type, od, address,
 				    addend, true, true, false,
 				    use_plt_offset));
@@ -2183,6 +2337,9 @@ class Output_data_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
 		     Output_data* od, unsigned int shndx, Address address,
 		     Addend addend, bool use_plt_offset)
   {
+    if (!use_plt_offset
+	&& this->add_relr(type, od, relobj, shndx, address))
+      return;
     this->add(od, Output_reloc_type(relobj, local_sym_index, type, shndx,
 				    address, addend, true, true, false,
 				    use_plt_offset));
@@ -2315,13 +2472,19 @@ class Output_data_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
   void
   add_relative(unsigned int type, Output_data* od, Address address,
 	       Addend addend)
-  { this->add(od, Output_reloc_type(type, od, address, addend, true)); }
+  {
+    if (this->add_relr(type, od, address))
+      return;
+    this->add(od, Output_reloc_type(type, od, address, addend, true));
+  }
 
   void
   add_relative(unsigned int type, Output_data* od,
 	       Sized_relobj<size, big_endian>* relobj,
 	       unsigned int shndx, Address address, Addend addend)
   {
+    if (this->add_relr(type, od, relobj, shndx, address))
+      return;
     this->add(od, Output_reloc_type(type, relobj, shndx, address, addend,
 				    true));
   }
@@ -2342,6 +2505,32 @@ class Output_data_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
     this->add(od, Output_reloc_type(type, arg, relobj, shndx, address,
 				    addend));
   }
+
+ private:
+  // Try to add a RELATIVE reloc to the RELR section.  Return false
+  // if it must go in this section instead.
+  bool
+  add_relr(unsigned int type, Output_data* od, Address address)
+  {
+    return (this->relr_ != NULL
+	    && type == this->relr_type_
+	    && this->relr_->add(type, od, address));
+  }
+
+  bool
+  add_relr(unsigned int type, Output_data* od,
+	   Sized_relobj<size, big_endian>* relobj, unsigned int shndx,
+	   Address address)
+  {
+    return (this->relr_ != NULL
+	    && type == this->relr_type_
+	    && this->relr_->add(type, od, relobj, shndx, address));
+  }
+
+  // The section holding packed RELATIVE relocs, or NULL.
+  Output_data_relr<size, big_endian>* relr_;
+  // The type of the RELATIVE relocs which may be packed.
+  unsigned int relr_type_;
 };
 
 // Output_relocatable_relocs represents a relocation section in a
@@ -2639,6 +2828,7 @@ class Output_data_got : public Output_data_got_base
 		  && local_sym_index != RESERVED_CODE
 		  && local_sym_index == this->local_sym_index_);
       this->u_.object = object;
+      object->set_has_late_references();
     }
 
     // Create a local symbol entry plus addend.
@@ -2652,6 +2842,7 @@ class Output_data_got : public Output_data_got_base
       && local_sym_index != RESERVED_CODE
       && local_sym_index == this->local_sym_index_);
       this->u_.object = object;
+      object->set_has_late_references();
     }
 
     // Create a constant entry.  The constant is a host value--it will
@@ -2930,13 +3121,17 @@ class Output_symtab_xindex : public Output_section_data
  public:
   Output_symtab_xindex(size_t symcount)
     : Output_section_data(symcount * 4, 4, true),
-      entries_()
+      entries_(), lock_()
   { }
 
-  // Add an entry: symbol number SYMNDX has section SHNDX.
+  // Add an entry: symbol number SYMNDX has section SHNDX.  This may
+  // be called by several tasks writing out global symbols at once.
   void
   add(unsigned int symndx, unsigned int shndx)
-  { this->entries_.push_back(std::make_pair(symndx, shndx)); }
+  {
+    Hold_lock hl(this->lock_);
+    this->entries_.push_back(std::make_pair(symndx, shndx));
+  }
 
  protected:
   void
@@ -2959,6 +3154,8 @@ class Output_symtab_xindex : public Output_section_data
 
   // The entries we need.
   Xindex_entries entries_;
+  // Lock controlling access to entries_.
+  Lock lock_;
 };
 
 // A relaxed input section.
@@ -4106,6 +4303,13 @@ class Output_section : public Output_data
   set_is_patch_space_allowed()
   { this->is_patch_space_allowed_ = true; }
 
+  // Pad the section so that its size is a multiple of ALIGN.  Used
+  // for --hugepage-text, so that nothing else shares the last huge
+  // page of the hot text.
+  void
+  set_end_alignment(uint64_t align)
+  { this->end_alignment_ = align; }
+
   // Set a fill method to use for free space left in the output section
   // during incremental links.
   void
@@ -4294,7 +4498,10 @@ class Output_section : public Output_data
 	input_sections_(input_sections),
 	input_sections_size_(input_sections_.size()),
 	input_sections_copy_(), first_input_offset_(first_input_offset),
-	attached_input_sections_are_sorted_(attached_input_sections_are_sorted)
+	attached_input_sections_are_sorted_(attached_input_sections_are_sorted),
+	input_sections_restored_(false), has_layout_(false),
+	layout_first_input_offset_(0), layout_data_size_(0),
+	layout_positions_()
     { }
 
     virtual
@@ -4351,6 +4558,99 @@ class Output_section : public Output_data
 	this->input_sections_copy_.push_back(*p);
     }
 
+    // Replace the saved input sections with the current list, which
+    // has just been sorted.  Sorting is deterministic, so this saves
+    // sorting again, and invalidating the layout, on every pass.
+    void
+    save_sorted_input_sections()
+    {
+      gold_assert(this->input_sections_.size() == this->input_sections_size_);
+      this->input_sections_copy_ = this->input_sections_;
+      this->attached_input_sections_are_sorted_ = true;
+      this->input_sections_restored_ = true;
+    }
+
+    // Whether the input section list still matches the saved copy,
+    // because it has not changed since it was last restored.
+    bool
+    input_sections_restored() const
+    { return this->input_sections_restored_; }
+
+    void
+    set_input_sections_restored()
+    { this->input_sections_restored_ = true; }
+
+    // Record that the input section list has changed.  This invalidates
+    // the saved layout.
+    void
+    input_sections_changed()
+    {
+      this->input_sections_restored_ = false;
+      this->has_layout_ = false;
+    }
+
+    // The position of an input section which is not a plain input
+    // section, as laid out by the last relaxation pass.  The addresses
+    // of plain input sections are kept as offsets from the start of the
+    // output section, so they need no position.
+    struct Input_position
+    {
+      Input_position(size_t index, off_t offset, off_t data_size,
+		     uint64_t addralign)
+	: index(index), offset(offset), data_size(data_size),
+	  addralign(addralign)
+      { }
+
+      // Index in the input section list.
+      size_t index;
+      // Offset from the start of the output section.
+      off_t offset;
+      // Size and alignment when laid out.
+      off_t data_size;
+      uint64_t addralign;
+    };
+
+    typedef std::vector<Input_position> Input_positions;
+
+    // Whether a layout was saved by the last relaxation pass, and the
+    // input section list has not changed since.
+    bool
+    has_layout() const
+    { return this->has_layout_; }
+
+    // The first input offset and data size of the saved layout.
+    off_t
+    layout_first_input_offset() const
+    { return this->layout_first_input_offset_; }
+
+    off_t
+    layout_data_size() const
+    { return this->layout_data_size_; }
+
+    // The positions of the input sections which are not plain input
+    // sections in the saved layout.
+    const Input_positions&
+    layout_positions() const
+    { return this->layout_positions_; }
+
+    // Start saving a layout.
+    Input_positions*
+    start_layout()
+    {
+      this->has_layout_ = false;
+      this->layout_positions_.clear();
+      return &this->layout_positions_;
+    }
+
+    // Finish saving a layout.
+    void
+    finish_layout(off_t first_input_offset, off_t data_size)
+    {
+      this->layout_first_input_offset_ = first_input_offset;
+      this->layout_data_size_ = data_size;
+      this->has_layout_ = true;
+    }
+
    private:
     // The section alignment.
     uint64_t addralign_;
@@ -4367,6 +4667,15 @@ class Output_section : public Output_data
     // True if the input sections attached to this output section have
     // already been sorted.
     bool attached_input_sections_are_sorted_;
+    // True if the input section list matches input_sections_copy_.
+    bool input_sections_restored_;
+    // True if layout_positions_ holds a usable layout.
+    bool has_layout_;
+    // The first input offset and data size of the saved layout.
+    off_t layout_first_input_offset_;
+    off_t layout_data_size_;
+    // The positions of the input sections in the saved layout.
+    Input_positions layout_positions_;
   };
 
   // This class is used to sort the input sections.
@@ -4455,6 +4764,21 @@ class Output_section : public Output_data
   void
   add_output_section_data(Input_section*);
 
+  // Record that input_sections_ has changed, so that the layout saved
+  // by the last relaxation pass can not be reused.
+  void
+  input_sections_changed()
+  {
+    if (this->checkpoint_ != NULL)
+      this->checkpoint_->input_sections_changed();
+  }
+
+  // Set the addresses of the input sections at ADDRESS and file offset
+  // STARTOFF from the layout saved by the last relaxation pass.  Return
+  // the data size, or -1 if the saved layout is out of date.
+  off_t
+  set_input_section_addresses_from_layout(uint64_t address, off_t startoff);
+
   // Add an SHF_MERGE input section.  Returns true if the section was
   // handled.  If KEEPS_INPUT_SECTIONS is true, the output merge section
   // stores information about the merged input sections.
@@ -4633,6 +4957,9 @@ class Output_section : public Output_data
   Output_fill* free_space_fill_;
   // Amount added as patch space for incremental linking.
   off_t patch_space_;
+  // If not zero, the size of the section is padded to a multiple of
+  // this.
+  uint64_t end_alignment_;
   // Associated relocation section, when emitting relocations.
   Output_section* reloc_section_;
 };
@@ -131,6 +131,11 @@ set_extra_library_path(const char *path);
 static enum ld_plugin_status
 message(int level, const char *format, ...);
 
+static int
+get_api_version(const char *plugin_identifier, const char *plugin_version,
+		int minimal_api_supported, int maximal_api_supported,
+		const char **linker_identifier, const char **linker_version);
+
 static enum ld_plugin_status
 get_input_section_count(const void* handle, unsigned int* count);
 
@@ -223,7 +228,7 @@ Plugin::load()
   sscanf(ver, "%d.%d", &major, &minor);
 
   // Allocate and populate a transfer vector.
-  const int tv_fixed_size = 31;
+  const int tv_fixed_size = 33;
 
   int tv_size = this->args_.size() + tv_fixed_size;
   ld_plugin_tv* tv = new ld_plugin_tv[tv_size];
@@ -365,6 +370,16 @@ Plugin::load()
   tv[i].tv_tag = LDPT_GET_WRAP_SYMBOLS;
   tv[i].tv_u.tv_get_wrap_symbols = get_wrap_symbols;
 
+  // gold has no use for the symbol type and section kind which
+  // add_symbols_v2 adds, so both versions are the same function.
+  ++i;
+  tv[i].tv_tag = LDPT_ADD_SYMBOLS_V2;
+  tv[i].tv_u.tv_add_symbols = add_symbols;
+
+  ++i;
+  tv[i].tv_tag = LDPT_GET_API_VERSION;
+  tv[i].tv_u.tv_get_api_version = get_api_version;
+
   ++i;
   tv[i].tv_tag = LDPT_NULL;
   tv[i].tv_u.tv_val = 0;
@@ -697,6 +712,7 @@ Plugin_manager::~Plugin_manager()
     delete *obj;
   this->objects_.clear();
   delete this->lock_;
+  delete this->claim_lock_;
   delete this->recorder_;
 }
 
@@ -720,72 +736,107 @@ Plugin_manager::load_plugins(Layout* layout)
 }
 
 // Call the plugin claim-file handlers in turn to see if any claim the file.
+// This is called by the Read_symbols tasks, so it may be running in
+// several threads at once.  Thread-safe claim-file handlers are called
+// without a lock; the others are called one at a time.
 
 Pluginobj*
 Plugin_manager::claim_file(Input_file* input_file, off_t offset,
                            off_t filesize, Object* elf_object)
 {
   bool lock_initialized = this->initialize_lock_.initialize();
-
   gold_assert(lock_initialized);
-  Hold_lock hl(*this->lock_);
+  lock_initialized = this->initialize_claim_lock_.initialize();
+  gold_assert(lock_initialized);
 
-  unsigned int handle = this->objects_.size();
-  this->input_file_ = input_file;
-  this->plugin_input_file_.name = input_file->filename().c_str();
-  this->plugin_input_file_.fd = input_file->file().descriptor();
-  this->plugin_input_file_.offset = offset;
-  this->plugin_input_file_.filesize = filesize;
-  this->plugin_input_file_.handle = reinterpret_cast<void*>(handle);
-  if (elf_object != NULL)
+  // Reserve a handle for the file.  If there is no ELF object, the
+  // entry stays NULL until the plugin calls add_symbols.
+  Claim claim;
+  unsigned int handle;
+  {
+    Hold_lock hl(*this->lock_);
+    handle = this->objects_.size();
     this->objects_.push_back(elf_object);
-  this->in_claim_file_handler_ = true;
+    this->claims_[handle] = &claim;
+  }
 
-  for (this->current_ = this->plugins_.begin();
-       this->current_ != this->plugins_.end();
-       ++this->current_)
+  claim.input_file = input_file;
+  struct ld_plugin_input_file* plugin_input_file = &claim.plugin_input_file;
+  plugin_input_file->name = input_file->filename().c_str();
+  plugin_input_file->fd = input_file->file().descriptor();
+  plugin_input_file->offset = offset;
+  plugin_input_file->filesize = filesize;
+  plugin_input_file->handle = reinterpret_cast<void*>(handle);
+
+  Plugin_list::iterator p;
+  for (p = this->plugins_.begin(); p != this->plugins_.end(); ++p)
     {
       // If we aren't yet in replacement phase, allow plugins to claim input
       // files, otherwise notify the plugin of the new input file, if needed.
       if (!this->in_replacement_phase_)
         {
-          if ((*this->current_)->claim_file(&this->plugin_input_file_))
-            {
-              this->any_claimed_ = true;
-              this->in_claim_file_handler_ = false;
-
-	      if (this->recorder_ != NULL)
-		{
-		  const std::string& objname = (elf_object == NULL
-						? input_file->filename()
-						: elf_object->name());
-		  this->recorder_->claimed_file(objname,
-						offset, filesize,
-						(*this->current_)->filename());
-		}
-
-              if (this->objects_.size() > handle
-                  && this->objects_[handle]->pluginobj() != NULL)
-                return this->objects_[handle]->pluginobj();
-
-              // If the plugin claimed the file but did not call the
-              // add_symbols callback, we need to create the Pluginobj now.
-              Pluginobj* obj = this->make_plugin_object(handle);
-              return obj;
-            }
+	  bool claimed;
+	  if ((*p)->claim_file_thread_safe())
+	    claimed = (*p)->claim_file(plugin_input_file);
+	  else
+	    {
+	      Hold_lock hl(*this->claim_lock_);
+	      claimed = (*p)->claim_file(plugin_input_file);
+	    }
+	  if (claimed)
+	    break;
         }
       else
         {
-          (*this->current_)->new_input(&this->plugin_input_file_);
+	  Hold_lock hl(*this->claim_lock_);
+          (*p)->new_input(plugin_input_file);
         }
     }
 
-  this->in_claim_file_handler_ = false;
+  Hold_lock hl(*this->lock_);
+
+  if (p == this->plugins_.end())
+    {
+      this->claims_.erase(handle);
+      if (this->recorder_ != NULL)
+	this->recorder_->unclaimed_file(input_file->filename(), offset,
+					filesize);
+      return NULL;
+    }
+
+  this->any_claimed_ = true;
 
   if (this->recorder_ != NULL)
-    this->recorder_->unclaimed_file(input_file->filename(), offset, filesize);
+    {
+      const std::string& objname = (elf_object == NULL
+				    ? input_file->filename()
+				    : elf_object->name());
+      this->recorder_->claimed_file(objname, offset, filesize,
+				    (*p)->filename());
+    }
 
-  return NULL;
+  // If the plugin claimed the file but did not call the add_symbols
+  // callback, we need to create the Pluginobj now.
+  Pluginobj* obj;
+  if (this->objects_[handle] != NULL
+      && this->objects_[handle]->pluginobj() != NULL)
+    obj = this->objects_[handle]->pluginobj();
+  else
+    obj = this->do_make_plugin_object(handle);
+  this->claims_.erase(handle);
+  return obj;
+}
+
+// Return true if the claim-file handlers are being called for the
+// file with HANDLE.
+
+bool
+Plugin_manager::in_claim_file_handler(const void* handle)
+{
+  unsigned int h
+    = static_cast<unsigned int>(reinterpret_cast<intptr_t>(handle));
+  Hold_optional_lock hl(this->lock_);
+  return this->claims_.find(h) != this->claims_.end();
 }
 
 // Save an archive.  This is used so that a plugin can add a file
@@ -1026,30 +1077,39 @@ Plugin_manager::cleanup()
 Pluginobj*
 Plugin_manager::make_plugin_object(unsigned int handle)
 {
-  // Make sure we aren't asked to make an object for the same handle twice.
-  if (this->objects_.size() != handle
-      && this->objects_[handle]->pluginobj() != NULL)
-    return NULL;
+  Hold_optional_lock hl(this->lock_);
+  return this->do_make_plugin_object(handle);
+}
 
-  const std::string* filename = &this->input_file_->filename();
+// Make a new Pluginobj object for the file being claimed with HANDLE,
+// replacing the ELF object, if any.  Return NULL if the file is not
+// being claimed, or if we already made a Pluginobj for it.
 
-  // If the elf object for this file was pushed into the objects_ vector,
-  // use its filename, then delete it to make room for the Pluginobj as
-  // this file is claimed.
-  if (this->objects_.size() != handle)
-    {
-      filename = &this->objects_.back()->name();
-      this->objects_.pop_back();
-    }
+Pluginobj*
+Plugin_manager::do_make_plugin_object(unsigned int handle)
+{
+  Claim_map::const_iterator p = this->claims_.find(handle);
+  if (p == this->claims_.end())
+    return NULL;
+  const Claim* claim = p->second;
 
-  Pluginobj* obj = make_sized_plugin_object(*filename,
-					    this->input_file_,
-                                            this->plugin_input_file_.offset,
-                                            this->plugin_input_file_.filesize);
+  // Make sure we aren't asked to make an object for the same handle twice.
+  Object* elf_object = this->objects_[handle];
+  if (elf_object != NULL && elf_object->pluginobj() != NULL)
+    return NULL;
 
+  // If there is an elf object for this file, use its filename.  The
+  // Pluginobj takes its place, as this file is claimed.
+  const std::string* filename = (elf_object != NULL
+				 ? &elf_object->name()
+				 : &claim->input_file->filename());
 
+  Pluginobj* obj =
+    make_sized_plugin_object(*filename, claim->input_file,
+			     claim->plugin_input_file.offset,
+			     claim->plugin_input_file.filesize);
 
-  this->objects_.push_back(obj);
+  this->objects_[handle] = obj;
   return obj;
 }
 
@@ -1113,13 +1173,20 @@ Plugin_manager::get_view(unsigned int handle, const void **viewp)
   off_t offset;
   size_t filesize;
   Input_file *input_file;
-  if (this->in_claim_file_handler_)
+  const Claim* claim = NULL;
+  {
+    Hold_optional_lock hl(this->lock_);
+    Claim_map::const_iterator p = this->claims_.find(handle);
+    if (p != this->claims_.end())
+      claim = p->second;
+  }
+  if (claim != NULL)
     {
       // We are being called from the claim_file hook.
-      const struct ld_plugin_input_file &f = this->plugin_input_file_;
+      const struct ld_plugin_input_file &f = claim->plugin_input_file;
       offset = f.offset;
       filesize = f.filesize;
-      input_file = this->input_file_;
+      input_file = claim->input_file;
     }
   else
     {
@@ -1147,7 +1214,12 @@ Plugin_manager::set_extra_library_path(const char* path)
   return LDPS_OK;
 }
 
-// Add a new input file.
+// Add a new input file.  The Read_symbols task is queued at once and
+// does not wait for the files added before it, so while the plugin's
+// all-symbols-read handler goes on adding files, the files already
+// added are opened and their symbols read by other threads.  Only the
+// Add_symbols tasks are chained, so that sections are laid out and
+// symbols resolved in the order the plugin added the files.
 
 ld_plugin_status
 Plugin_manager::add_input_file(const char* pathname, bool is_lib)
@@ -1966,7 +2038,7 @@ get_input_section_count(const void* handle, unsigned int* count)
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(handle))
     return LDPS_ERR;
 
   Object* obj = parameters->options().plugins()->get_elf_object(handle);
@@ -1988,7 +2060,8 @@ get_input_section_type(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	  section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -2011,7 +2084,8 @@ get_input_section_name(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	  section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -2040,7 +2114,8 @@ get_input_section_contents(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	  section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -2069,7 +2144,8 @@ get_input_section_alignment(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	  section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -2092,7 +2168,8 @@ get_input_section_size(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	  section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -2124,6 +2201,28 @@ get_wrap_symbols(uint64_t *count, const char ***wrap_symbols)
   return LDPS_OK;
 }
 
+// Negotiate the API version with the plugin.  At LAPI_V1 the plugin's
+// claim-file handler is thread safe, so we may call it from several
+// Read_symbols tasks at once.
+
+static int
+get_api_version(const char*, const char*, int minimal_api_supported,
+		int maximal_api_supported, const char** linker_identifier,
+		const char** linker_version)
+{
+  gold_assert(parameters->options().has_plugins());
+
+  if (minimal_api_supported > LAPI_V1 || maximal_api_supported < LAPI_V0)
+    return -1;
+
+  *linker_identifier = "GNU gold";
+  *linker_version = get_version_string();
+
+  int version = (maximal_api_supported >= LAPI_V1 ? LAPI_V1 : LAPI_V0);
+  parameters->options().plugins()->set_api_version(version);
+  return version;
+}
+
 
 // Specify the ordering of sections in the final layout. The sections are
 // specified as (handle,shndx) pairs in the two arrays in the order in
@@ -62,6 +62,7 @@ class Plugin
       all_symbols_read_handler_(NULL),
       cleanup_handler_(NULL),
       new_input_handler_(NULL),
+      api_version_(LAPI_V0),
       cleanup_done_(false)
   { }
 
@@ -93,6 +94,17 @@ class Plugin
   set_claim_file_handler(ld_plugin_claim_file_handler handler)
   { this->claim_file_handler_ = handler; }
 
+  // Record the API version negotiated with the plugin.
+  void
+  set_api_version(int version)
+  { this->api_version_ = version; }
+
+  // Whether the claim-file handler may be called by several threads
+  // at once.  A plugin promises this by agreeing to LAPI_V1.
+  bool
+  claim_file_thread_safe() const
+  { return this->api_version_ >= LAPI_V1; }
+
   // Register an all-symbols-read handler.
   void
   set_all_symbols_read_handler(ld_plugin_all_symbols_read_handler handler)
@@ -134,6 +146,8 @@ class Plugin
   ld_plugin_all_symbols_read_handler all_symbols_read_handler_;
   ld_plugin_cleanup_handler cleanup_handler_;
   ld_plugin_new_input_handler new_input_handler_;
+  // The API version negotiated with the plugin.
+  int api_version_;
   // TRUE if the cleanup handlers have been called.
   bool cleanup_done_;
 };
@@ -144,14 +158,14 @@ class Plugin_manager
 {
  public:
   Plugin_manager(const General_options& options)
-    : plugins_(), objects_(), deferred_layout_objects_(), input_file_(NULL),
-      plugin_input_file_(), rescannable_(), undefined_symbols_(),
+    : plugins_(), objects_(), deferred_layout_objects_(), claims_(),
+      rescannable_(), undefined_symbols_(),
       any_claimed_(false), in_replacement_phase_(false), any_added_(false),
-      in_claim_file_handler_(false),
       options_(options), workqueue_(NULL), task_(NULL), input_objects_(NULL),
       symtab_(NULL), layout_(NULL), dirpath_(NULL), mapfile_(NULL),
       this_blocker_(NULL), extra_search_path_(), lock_(NULL),
-      initialize_lock_(&lock_), defsym_defines_set_(),
+      initialize_lock_(&lock_), claim_lock_(NULL),
+      initialize_claim_lock_(&claim_lock_), defsym_defines_set_(),
       recorder_(NULL)
   { this->current_ = plugins_.end(); }
 
@@ -191,10 +205,10 @@ class Plugin_manager
   Object*
   get_elf_object(const void* handle);
 
-  // True if the claim_file handler of the plugins is being called.
+  // True if the claim_file handlers of the plugins are being called
+  // for the file with the given HANDLE.
   bool
-  in_claim_file_handler()
-  { return in_claim_file_handler_; }
+  in_claim_file_handler(const void* handle);
 
   // Let the plugin manager save an archive for later rescanning.
   // This takes ownership of the Archive pointer.
@@ -234,6 +248,14 @@ class Plugin_manager
     (*this->current_)->set_claim_file_handler(handler);
   }
 
+  // Record the API version negotiated with the current plugin.
+  void
+  set_api_version(int version)
+  {
+    gold_assert(this->current_ != plugins_.end());
+    (*this->current_)->set_api_version(version);
+  }
+
   // Register an all-symbols-read handler.
   void
   set_all_symbols_read_handler(ld_plugin_all_symbols_read_handler handler)
@@ -267,6 +289,7 @@ class Plugin_manager
   Object*
   object(unsigned int handle) const
   {
+    Hold_optional_lock hl(this->lock_);
     if (handle >= this->objects_.size())
       return NULL;
     return this->objects_[handle];
@@ -353,12 +376,25 @@ class Plugin_manager
     { this->u.input_group = input_group; }
   };
 
+  // A file which is being offered to the plugins by claim_file.
+  struct Claim
+  {
+    Input_file* input_file;
+    struct ld_plugin_input_file plugin_input_file;
+  };
+
   typedef std::list<Plugin*> Plugin_list;
   typedef std::vector<Object*> Object_list;
+  typedef Unordered_map<unsigned int, Claim*> Claim_map;
   typedef std::vector<Relobj*> Deferred_layout_list;
   typedef std::vector<Rescannable> Rescannable_list;
   typedef std::vector<Symbol*> Undefined_symbol_list;
 
+  // Make a new Pluginobj object for the file being claimed with
+  // HANDLE.  The caller must hold lock_.
+  Pluginobj*
+  do_make_plugin_object(unsigned int handle);
+
   // Rescan archives for undefined symbols.
   void
   rescan(Task*);
@@ -379,9 +415,10 @@ class Plugin_manager
   // The list of regular objects whose layout has been deferred.
   Deferred_layout_list deferred_layout_objects_;
 
-  // The file currently up for claim by the plugins.
-  Input_file* input_file_;
-  struct ld_plugin_input_file plugin_input_file_;
+  // The files currently up for claim by the plugins, indexed by
+  // handle.  Several files may be offered at once by different
+  // threads.
+  Claim_map claims_;
 
   // A list of archives and input groups being saved for possible
   // later rescanning.
@@ -401,9 +438,6 @@ class Plugin_manager
   // Whether any input files or libraries were added by a plugin.
   bool any_added_;
 
-  // Set to true when the claim_file handler of a plugin is called.
-  bool in_claim_file_handler_;
-
   const General_options& options_;
   Workqueue* workqueue_;
   Task* task_;
@@ -417,8 +451,14 @@ class Plugin_manager
   // An extra directory to search for the libraries passed by
   // add_input_library.
   std::string extra_search_path_;
+  // The lock for objects_, claims_ and the recorder, which may be
+  // used by several threads at once while files are being claimed.
   Lock* lock_;
   Initialize_lock initialize_lock_;
+  // The lock held while calling a claim-file handler which is not
+  // thread safe.
+  Lock* claim_lock_;
+  Initialize_lock initialize_claim_lock_;
 
   // Keep track of all symbols defined by defsym.
   typedef Unordered_set<std::string> Defsym_defines_set;
@@ -103,6 +103,9 @@ public:
       access_from_map_(), has14_(), stub_table_index_(), st_other_()
   {
     this->set_abiversion(0);
+    // The stub tables and .opd refer to our local symbols when they
+    // are written.
+    this->set_has_late_references();
   }
 
   ~Powerpc_relobj()
@@ -0,0 +1,764 @@
+// raisin64.cc -- raisin64 target support for gold.
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include "elfcpp.h"
+#include "parameters.h"
+#include "reloc.h"
+#include "raisin64.h"
+#include "object.h"
+#include "symtab.h"
+#include "layout.h"
+#include "output.h"
+#include "target.h"
+#include "target-reloc.h"
+#include "target-select.h"
+#include "gc.h"
+#include "icf.h"
+
+// Raisin64 is a 64-bit big endian processor with 16, 32 and 64 bit
+// instructions, used for bare metal firmware.  There is no dynamic
+// linker, so there is no GOT, PLT or dynamic relocation support here:
+// we only do static links and relocatable links.
+
+namespace
+{
+
+using namespace gold;
+
+class Target_raisin64 : public Sized_target<64, true>
+{
+ public:
+  typedef elfcpp::Elf_types<64>::Elf_Addr Address;
+
+  Target_raisin64()
+    : Sized_target<64, true>(&raisin64_info)
+  { }
+
+  // Process the relocations to determine unreferenced sections for
+  // garbage collection.
+  void
+  gc_process_relocs(Symbol_table* symtab,
+		    Layout* layout,
+		    Sized_relobj_file<64, true>* object,
+		    unsigned int data_shndx,
+		    unsigned int sh_type,
+		    const unsigned char* prelocs,
+		    size_t reloc_count,
+		    Output_section* output_section,
+		    bool needs_special_offset_handling,
+		    size_t local_symbol_count,
+		    const unsigned char* plocal_symbols);
+
+  // Scan the relocations to look for symbol adjustments.
+  void
+  scan_relocs(Symbol_table* symtab,
+	      Layout* layout,
+	      Sized_relobj_file<64, true>* object,
+	      unsigned int data_shndx,
+	      unsigned int sh_type,
+	      const unsigned char* prelocs,
+	      size_t reloc_count,
+	      Output_section* output_section,
+	      bool needs_special_offset_handling,
+	      size_t local_symbol_count,
+	      const unsigned char* plocal_symbols);
+
+  // Finalize the sections.
+  void
+  do_finalize_sections(Layout*, const Input_objects*, Symbol_table*);
+
+  // Relocate a section.
+  void
+  relocate_section(const Relocate_info<64, true>*,
+		   unsigned int sh_type,
+		   const unsigned char* prelocs,
+		   size_t reloc_count,
+		   Output_section* output_section,
+		   bool needs_special_offset_handling,
+		   unsigned char* view,
+		   Address view_address,
+		   section_size_type view_size,
+		   const Reloc_symbol_changes*);
+
+  // Scan the relocs during a relocatable link.
+  void
+  scan_relocatable_relocs(Symbol_table* symtab,
+			  Layout* layout,
+			  Sized_relobj_file<64, true>* object,
+			  unsigned int data_shndx,
+			  unsigned int sh_type,
+			  const unsigned char* prelocs,
+			  size_t reloc_count,
+			  Output_section* output_section,
+			  bool needs_special_offset_handling,
+			  size_t local_symbol_count,
+			  const unsigned char* plocal_symbols,
+			  Relocatable_relocs*);
+
+  // Scan the relocs for --emit-relocs.
+  void
+  emit_relocs_scan(Symbol_table* symtab,
+		   Layout* layout,
+		   Sized_relobj_file<64, true>* object,
+		   unsigned int data_shndx,
+		   unsigned int sh_type,
+		   const unsigned char* prelocs,
+		   size_t reloc_count,
+		   Output_section* output_section,
+		   bool needs_special_offset_handling,
+		   size_t local_symbol_count,
+		   const unsigned char* plocal_syms,
+		   Relocatable_relocs* rr);
+
+  // Emit relocations for a section.
+  void
+  relocate_relocs(
+      const Relocate_info<64, true>*,
+      unsigned int sh_type,
+      const unsigned char* prelocs,
+      size_t reloc_count,
+      Output_section* output_section,
+      elfcpp::Elf_types<64>::Elf_Off offset_in_output_section,
+      unsigned char* view,
+      Address view_address,
+      section_size_type view_size,
+      unsigned char* reloc_view,
+      section_size_type reloc_view_size);
+
+  // Raisin64 can tell from the relocation type whether the address
+  // of a function is taken, so --icf=safe can fold functions which
+  // are only called.
+  bool
+  do_can_check_for_function_pointers() const
+  { return true; }
+
+ private:
+  // The class which scans relocations.
+  class Scan
+  {
+  public:
+    Scan()
+    { }
+
+    static inline int
+    get_reference_flags(unsigned int r_type);
+
+    inline void
+    local(Symbol_table* symtab, Layout* layout, Target_raisin64* target,
+	  Sized_relobj_file<64, true>* object,
+	  unsigned int data_shndx,
+	  Output_section* output_section,
+	  const elfcpp::Rela<64, true>& reloc, unsigned int r_type,
+	  const elfcpp::Sym<64, true>& lsym,
+	  bool is_discarded);
+
+    inline void
+    global(Symbol_table* symtab, Layout* layout, Target_raisin64* target,
+	   Sized_relobj_file<64, true>* object,
+	   unsigned int data_shndx,
+	   Output_section* output_section,
+	   const elfcpp::Rela<64, true>& reloc, unsigned int r_type,
+	   Symbol* gsym);
+
+    inline bool
+    local_reloc_may_be_function_pointer(Symbol_table*, Layout*,
+					Target_raisin64*,
+					Sized_relobj_file<64, true>*,
+					unsigned int, Output_section*,
+					const elfcpp::Rela<64, true>&,
+					unsigned int r_type,
+					const elfcpp::Sym<64, true>&)
+    { return possible_function_pointer_reloc(r_type); }
+
+    inline bool
+    global_reloc_may_be_function_pointer(Symbol_table*, Layout*,
+					 Target_raisin64*,
+					 Sized_relobj_file<64, true>*,
+					 unsigned int, Output_section*,
+					 const elfcpp::Rela<64, true>&,
+					 unsigned int r_type, Symbol*)
+    { return possible_function_pointer_reloc(r_type); }
+
+  private:
+    static void
+    unsupported_reloc_local(Sized_relobj_file<64, true>*,
+			    unsigned int r_type);
+
+    static void
+    unsupported_reloc_global(Sized_relobj_file<64, true>*,
+			     unsigned int r_type, Symbol*);
+
+    static inline bool
+    possible_function_pointer_reloc(unsigned int r_type);
+  };
+
+  // The class which implements relocation.
+  class Relocate
+  {
+   public:
+    // Do a relocation.  Return false if the caller should not issue
+    // any warnings about this relocation.
+    inline bool
+    relocate(const Relocate_info<64, true>*, unsigned int,
+	     Target_raisin64*, Output_section*, size_t, const unsigned char*,
+	     const Sized_symbol<64>*, const Symbol_value<64>*,
+	     unsigned char*, Address, section_size_type);
+  };
+
+  // Information about this specific target which we pass to the
+  // general Target structure.
+  static Target::Target_info raisin64_info;
+};
+
+Target::Target_info Target_raisin64::raisin64_info =
+{
+  64,			// size
+  true,			// is_big_endian
+  elfcpp::EM_RAISIN64,	// machine_code
+  false,		// has_make_symbol
+  false,		// has_resolve
+  false,		// has_code_fill
+  false,		// is_default_stack_executable
+  false,		// can_icf_inline_merge_sections
+  '\0',			// wrap_char
+  NULL,			// dynamic_linker
+  0x0,			// default_text_segment_address
+  1,			// abi_pagesize (overridable by -z max-page-size)
+  1,			// common_pagesize (overridable by -z common-page-size)
+  false,                // isolate_execinstr
+  0,                    // rosegment_gap
+  elfcpp::SHN_UNDEF,	// small_common_shndx
+  elfcpp::SHN_UNDEF,	// large_common_shndx
+  0,			// small_common_section_flags
+  0,			// large_common_section_flags
+  NULL,			// attributes_section
+  NULL,			// attributes_vendor
+  "_start",		// entry_symbol_name
+  32,			// hash_entry_size
+  elfcpp::SHT_PROGBITS,	// unwind_section_type
+};
+
+// The Raisin64 relocations.  Instructions are always at even
+// addresses, so jump and branch targets are stored shifted right by
+// one bit.  The encodings are those the assembler uses when it
+// resolves a fixup itself.
+
+class Raisin64_relocate_functions
+{
+ public:
+  typedef elfcpp::Elf_types<64>::Elf_Addr Address;
+
+  enum Status
+  {
+    STATUS_OK,
+    STATUS_OVERFLOW
+  };
+
+  // R_RAISIN64_56: the last seven bytes of a 64-bit ji or jali
+  // instruction hold the absolute target address.
+  static inline Status
+  abs56(unsigned char* view, Address value)
+  {
+    int64_t field = static_cast<int64_t>(value) >> 1;
+    bool overflow = Bits<56>::has_signed_unsigned_overflow64(field);
+    for (int i = 6; i >= 0; --i)
+      {
+	view[i] = field & 0xff;
+	field >>= 8;
+      }
+    return overflow ? STATUS_OVERFLOW : STATUS_OK;
+  }
+
+  // R_RAISIN64_PCREL32: the last four bytes of a 64-bit branch
+  // instruction hold the offset of the target from the end of the
+  // instruction, which is also the end of the field at ADDRESS.
+  static inline Status
+  pcrel32(unsigned char* view, Address value, Address address)
+  {
+    int64_t field = static_cast<int64_t>(value - (address + 4)) >> 1;
+    elfcpp::Swap_unaligned<32, true>::writeval(view, field);
+    return (Bits<32>::has_overflow(field) ? STATUS_OVERFLOW : STATUS_OK);
+  }
+
+  // R_RAISIN64_PCREL12: the low twelve bits of the halfword at VIEW
+  // hold the offset of the target from ADDRESS.
+  static inline Status
+  pcrel12(unsigned char* view, Address value, Address address)
+  {
+    int64_t field = static_cast<int64_t>(value - address) >> 1;
+    uint16_t val = elfcpp::Swap_unaligned<16, true>::readval(view);
+    val = (val & 0xf000) | (field & 0x0fff);
+    elfcpp::Swap_unaligned<16, true>::writeval(view, val);
+    return (Bits<12>::has_overflow(field) ? STATUS_OVERFLOW : STATUS_OK);
+  }
+
+  // R_RAISIN64_DATA32: a 32-bit immediate, which may be signed or
+  // unsigned depending on the instruction.
+  static inline Status
+  data32(unsigned char* view, Address value)
+  {
+    elfcpp::Swap_unaligned<32, true>::writeval(view, value);
+    return (Bits<32>::has_signed_unsigned_overflow64(value)
+	    ? STATUS_OVERFLOW
+	    : STATUS_OK);
+  }
+};
+
+// Get the Reference_flags for a particular relocation.
+
+int
+Target_raisin64::Scan::get_reference_flags(unsigned int r_type)
+{
+  switch (r_type)
+    {
+    case elfcpp::R_RAISIN64_NONE:
+      // No symbol reference.
+      return 0;
+
+    case elfcpp::R_RAISIN64_56:
+      return Symbol::ABSOLUTE_REF | Symbol::FUNCTION_CALL;
+
+    case elfcpp::R_RAISIN64_DATA32:
+      return Symbol::ABSOLUTE_REF;
+
+    case elfcpp::R_RAISIN64_PCREL32:
+    case elfcpp::R_RAISIN64_PCREL12:
+      return Symbol::RELATIVE_REF | Symbol::FUNCTION_CALL;
+
+    default:
+      // Not expected.  We will give an error later.
+      return 0;
+    }
+}
+
+// Report an unsupported relocation against a local symbol.
+
+void
+Target_raisin64::Scan::unsupported_reloc_local(
+    Sized_relobj_file<64, true>* object,
+    unsigned int r_type)
+{
+  gold_error(_("%s: unsupported reloc %u against local symbol"),
+	     object->name().c_str(), r_type);
+}
+
+// Report an unsupported relocation against a global symbol.
+
+void
+Target_raisin64::Scan::unsupported_reloc_global(
+    Sized_relobj_file<64, true>* object,
+    unsigned int r_type,
+    Symbol* gsym)
+{
+  gold_error(_("%s: unsupported reloc %u against global symbol %s"),
+	     object->name().c_str(), r_type, gsym->demangled_name().c_str());
+}
+
+// Whether a relocation of type R_TYPE may take the address of a
+// function.  The branches only call; a jump target or an immediate
+// may be a function pointer.
+
+inline bool
+Target_raisin64::Scan::possible_function_pointer_reloc(unsigned int r_type)
+{
+  switch (r_type)
+    {
+    case elfcpp::R_RAISIN64_56:
+    case elfcpp::R_RAISIN64_DATA32:
+      return true;
+    default:
+      return false;
+    }
+}
+
+// Scan a relocation for a local symbol.  Without a GOT or PLT there
+// is nothing to set up; we just check the type.
+
+inline void
+Target_raisin64::Scan::local(Symbol_table*,
+			     Layout*,
+			     Target_raisin64*,
+			     Sized_relobj_file<64, true>* object,
+			     unsigned int,
+			     Output_section*,
+			     const elfcpp::Rela<64, true>&,
+			     unsigned int r_type,
+			     const elfcpp::Sym<64, true>&,
+			     bool is_discarded)
+{
+  if (is_discarded)
+    return;
+
+  switch (r_type)
+    {
+    case elfcpp::R_RAISIN64_NONE:
+    case elfcpp::R_RAISIN64_56:
+    case elfcpp::R_RAISIN64_PCREL32:
+    case elfcpp::R_RAISIN64_PCREL12:
+    case elfcpp::R_RAISIN64_DATA32:
+      break;
+
+    default:
+      unsupported_reloc_local(object, r_type);
+      break;
+    }
+}
+
+// Scan a relocation for a global symbol.
+
+inline void
+Target_raisin64::Scan::global(Symbol_table*,
+			      Layout*,
+			      Target_raisin64*,
+			      Sized_relobj_file<64, true>* object,
+			      unsigned int,
+			      Output_section*,
+			      const elfcpp::Rela<64, true>&,
+			      unsigned int r_type,
+			      Symbol* gsym)
+{
+  switch (r_type)
+    {
+    case elfcpp::R_RAISIN64_NONE:
+    case elfcpp::R_RAISIN64_56:
+    case elfcpp::R_RAISIN64_PCREL32:
+    case elfcpp::R_RAISIN64_PCREL12:
+    case elfcpp::R_RAISIN64_DATA32:
+      break;
+
+    default:
+      unsupported_reloc_global(object, r_type, gsym);
+      break;
+    }
+}
+
+// Process relocations for gc.
+
+void
+Target_raisin64::gc_process_relocs(Symbol_table* symtab,
+				   Layout* layout,
+				   Sized_relobj_file<64, true>* object,
+				   unsigned int data_shndx,
+				   unsigned int sh_type,
+				   const unsigned char* prelocs,
+				   size_t reloc_count,
+				   Output_section* output_section,
+				   bool needs_special_offset_handling,
+				   size_t local_symbol_count,
+				   const unsigned char* plocal_symbols)
+{
+  typedef gold::Default_classify_reloc<elfcpp::SHT_RELA, 64, true>
+      Classify_reloc;
+
+  if (sh_type == elfcpp::SHT_REL)
+    return;
+
+  gold::gc_process_relocs<64, true, Target_raisin64, Scan, Classify_reloc>(
+    symtab,
+    layout,
+    this,
+    object,
+    data_shndx,
+    prelocs,
+    reloc_count,
+    output_section,
+    needs_special_offset_handling,
+    local_symbol_count,
+    plocal_symbols);
+}
+
+// Scan relocations for a section.
+
+void
+Target_raisin64::scan_relocs(Symbol_table* symtab,
+			     Layout* layout,
+			     Sized_relobj_file<64, true>* object,
+			     unsigned int data_shndx,
+			     unsigned int sh_type,
+			     const unsigned char* prelocs,
+			     size_t reloc_count,
+			     Output_section* output_section,
+			     bool needs_special_offset_handling,
+			     size_t local_symbol_count,
+			     const unsigned char* plocal_symbols)
+{
+  typedef gold::Default_classify_reloc<elfcpp::SHT_RELA, 64, true>
+      Classify_reloc;
+
+  if (sh_type == elfcpp::SHT_REL)
+    {
+      gold_error(_("%s: unsupported REL reloc section"),
+		 object->name().c_str());
+      return;
+    }
+
+  gold::scan_relocs<64, true, Target_raisin64, Scan, Classify_reloc>(
+    symtab,
+    layout,
+    this,
+    object,
+    data_shndx,
+    prelocs,
+    reloc_count,
+    output_section,
+    needs_special_offset_handling,
+    local_symbol_count,
+    plocal_symbols);
+}
+
+// Finalize the sections.  This is where we find out whether the link
+// needs dynamic sections, which Raisin64 does not have.
+
+void
+Target_raisin64::do_finalize_sections(Layout*, const Input_objects*,
+				      Symbol_table*)
+{
+  if (!parameters->options().relocatable()
+      && !parameters->doing_static_link())
+    gold_fatal(_("dynamic linking is not supported for Raisin64"));
+}
+
+// Perform a relocation.
+
+inline bool
+Target_raisin64::Relocate::relocate(
+    const Relocate_info<64, true>* relinfo,
+    unsigned int,
+    Target_raisin64*,
+    Output_section*,
+    size_t relnum,
+    const unsigned char* preloc,
+    const Sized_symbol<64>*,
+    const Symbol_value<64>* psymval,
+    unsigned char* view,
+    Address address,
+    section_size_type)
+{
+  if (view == NULL)
+    return true;
+
+  typedef Raisin64_relocate_functions Reloc;
+
+  const elfcpp::Rela<64, true> rela(preloc);
+  unsigned int r_type = elfcpp::elf_r_type<64>(rela.get_r_info());
+  const Sized_relobj_file<64, true>* object = relinfo->object;
+  Address value = psymval->value(object, rela.get_r_addend());
+
+  Reloc::Status status = Reloc::STATUS_OK;
+  switch (r_type)
+    {
+    case elfcpp::R_RAISIN64_NONE:
+      break;
+
+    case elfcpp::R_RAISIN64_56:
+      status = Reloc::abs56(view, value);
+      break;
+
+    case elfcpp::R_RAISIN64_PCREL32:
+      status = Reloc::pcrel32(view, value, address);
+      break;
+
+    case elfcpp::R_RAISIN64_PCREL12:
+      status = Reloc::pcrel12(view, value, address);
+      break;
+
+    case elfcpp::R_RAISIN64_DATA32:
+      status = Reloc::data32(view, value);
+      break;
+
+    default:
+      gold_error_at_location(relinfo, relnum, rela.get_r_offset(),
+			     _("unexpected reloc %u in object file"),
+			     r_type);
+      break;
+    }
+
+  if (status == Reloc::STATUS_OVERFLOW)
+    gold_error_at_location(relinfo, relnum, rela.get_r_offset(),
+			   _("relocation overflow"));
+
+  return true;
+}
+
+// Relocate section data.
+
+void
+Target_raisin64::relocate_section(
+    const Relocate_info<64, true>* relinfo,
+    unsigned int sh_type,
+    const unsigned char* prelocs,
+    size_t reloc_count,
+    Output_section* output_section,
+    bool needs_special_offset_handling,
+    unsigned char* view,
+    Address address,
+    section_size_type view_size,
+    const Reloc_symbol_changes* reloc_symbol_changes)
+{
+  typedef gold::Default_classify_reloc<elfcpp::SHT_RELA, 64, true>
+      Classify_reloc;
+
+  gold_assert(sh_type == elfcpp::SHT_RELA);
+
+  gold::relocate_section<64, true, Target_raisin64, Relocate,
+			 gold::Default_comdat_behavior, Classify_reloc>(
+    relinfo,
+    this,
+    prelocs,
+    reloc_count,
+    output_section,
+    needs_special_offset_handling,
+    view,
+    address,
+    view_size,
+    reloc_symbol_changes);
+}
+
+// Scan the relocs during a relocatable link.
+
+void
+Target_raisin64::scan_relocatable_relocs(
+    Symbol_table* symtab,
+    Layout* layout,
+    Sized_relobj_file<64, true>* object,
+    unsigned int data_shndx,
+    unsigned int sh_type,
+    const unsigned char* prelocs,
+    size_t reloc_count,
+    Output_section* output_section,
+    bool needs_special_offset_handling,
+    size_t local_symbol_count,
+    const unsigned char* plocal_symbols,
+    Relocatable_relocs* rr)
+{
+  typedef gold::Default_classify_reloc<elfcpp::SHT_RELA, 64, true>
+      Classify_reloc;
+  typedef gold::Default_scan_relocatable_relocs<Classify_reloc>
+      Scan_relocatable_relocs;
+
+  gold_assert(sh_type == elfcpp::SHT_RELA);
+
+  gold::scan_relocatable_relocs<64, true, Scan_relocatable_relocs>(
+    symtab,
+    layout,
+    object,
+    data_shndx,
+    prelocs,
+    reloc_count,
+    output_section,
+    needs_special_offset_handling,
+    local_symbol_count,
+    plocal_symbols,
+    rr);
+}
+
+// Scan the relocs for --emit-relocs.
+
+void
+Target_raisin64::emit_relocs_scan(
+    Symbol_table* symtab,
+    Layout* layout,
+    Sized_relobj_file<64, true>* object,
+    unsigned int data_shndx,
+    unsigned int sh_type,
+    const unsigned char* prelocs,
+    size_t reloc_count,
+    Output_section* output_section,
+    bool needs_special_offset_handling,
+    size_t local_symbol_count,
+    const unsigned char* plocal_syms,
+    Relocatable_relocs* rr)
+{
+  typedef gold::Default_classify_reloc<elfcpp::SHT_RELA, 64, true>
+      Classify_reloc;
+  typedef gold::Default_emit_relocs_strategy<Classify_reloc>
+      Emit_relocs_strategy;
+
+  gold_assert(sh_type == elfcpp::SHT_RELA);
+
+  gold::scan_relocatable_relocs<64, true, Emit_relocs_strategy>(
+    symtab,
+    layout,
+    object,
+    data_shndx,
+    prelocs,
+    reloc_count,
+    output_section,
+    needs_special_offset_handling,
+    local_symbol_count,
+    plocal_syms,
+    rr);
+}
+
+// Relocate a section during a relocatable link.
+
+void
+Target_raisin64::relocate_relocs(
+    const Relocate_info<64, true>* relinfo,
+    unsigned int sh_type,
+    const unsigned char* prelocs,
+    size_t reloc_count,
+    Output_section* output_section,
+    elfcpp::Elf_types<64>::Elf_Off offset_in_output_section,
+    unsigned char* view,
+    Address view_address,
+    section_size_type view_size,
+    unsigned char* reloc_view,
+    section_size_type reloc_view_size)
+{
+  typedef gold::Default_classify_reloc<elfcpp::SHT_RELA, 64, true>
+      Classify_reloc;
+
+  gold_assert(sh_type == elfcpp::SHT_RELA);
+
+  gold::relocate_relocs<64, true, Classify_reloc>(
+    relinfo,
+    prelocs,
+    reloc_count,
+    output_section,
+    offset_in_output_section,
+    view,
+    view_address,
+    view_size,
+    reloc_view,
+    reloc_view_size);
+}
+
+// The selector for raisin64 object files.
+
+class Target_selector_raisin64 : public Target_selector
+{
+public:
+  Target_selector_raisin64()
+    : Target_selector(elfcpp::EM_RAISIN64, 64, true, "elf64-raisin64",
+		      "elf64raisin64")
+  { }
+
+  virtual Target*
+  do_instantiate_target()
+  { return new Target_raisin64(); }
+};
+
+Target_selector_raisin64 target_selector_raisin64;
+
+} // End anonymous namespace.
@@ -23,6 +23,7 @@
 #include "gold.h"
 
 #include <algorithm>
+#include <functional>
 
 #include "workqueue.h"
 #include "layout.h"
@@ -35,6 +36,7 @@
 #include "icf.h"
 #include "compressed_output.h"
 #include "incremental.h"
+#include "call-graph.h"
 
 namespace gold
 {
@@ -68,6 +70,10 @@ Read_relocs::run(Workqueue* workqueue)
 {
   Read_relocs_data* rd = new Read_relocs_data;
   this->object_->read_relocs(rd);
+  // Find the calls for --call-graph-ordering while we have the relocs,
+  // rather than reading them all again later.
+  if (Call_graph::wants_static_calls())
+    this->object_->find_call_graph_edges(rd);
   this->object_->set_relocs_data(rd);
   this->object_->release();
 
@@ -154,9 +160,10 @@ Scan_relocs::~Scan_relocs()
 }
 
 // These tasks scan the relocations read by Read_relocs and mark up
-// the symbol table to indicate which relocations are required.  We
-// use a lock on the symbol table to keep them from interfering with
-// each other.
+// the symbol table to indicate which relocations are required.  They
+// are chained by THIS_BLOCKER_ and NEXT_BLOCKER_, so that only one
+// runs at a time, in the order of the input objects; this keeps them
+// from interfering with each other when they add GOT and PLT entries.
 
 Task_token*
 Scan_relocs::is_runnable()
@@ -168,8 +175,8 @@ Scan_relocs::is_runnable()
   return NULL;
 }
 
-// Return the locks we hold: one on the file, one on the symbol table
-// and one blocker.
+// Return the locks we hold: one on the file and one blocker.  There is
+// no lock on the symbol table; the blocker chain serializes the scans.
 
 void
 Scan_relocs::locks(Task_locker* tl)
@@ -239,9 +246,17 @@ Relocate_task::run(Workqueue*)
   this->object_->relocate(this->symtab_, this->layout_, this->of_);
 
   // This is normally the last thing we will do with an object, so
-  // uncache all views.
+  // free what was only needed for relocation, drop the decompressed
+  // sections and uncache all views.
+  this->object_->release_relocation_data();
+  this->object_->discard_decompressed_sections();
   this->object_->clear_view_cache_marks();
 
+  // With --no-keep-memory, also free the views of an archive member
+  // now, rather than keeping them for the next member.
+  if (parameters->options().no_keep_memory())
+    this->object_->clear_uncached_views();
+
   this->object_->release();
 }
 
@@ -418,6 +433,102 @@ Sized_relobj_file<size, big_endian>::do_gc_process_relocs(Symbol_table* symtab,
 }
 
 
+// Sort the calls from a section by callee, so that duplicate calls
+// are adjacent.
+
+struct Call_graph_call_compare
+{
+  bool
+  operator()(const Call_graph_call& c1, const Call_graph_call& c2) const
+  {
+    if (c1.callee_symbol != c2.callee_symbol)
+      return std::less<Symbol*>()(c1.callee_symbol, c2.callee_symbol);
+    return c1.callee_shndx < c2.callee_shndx;
+  }
+};
+
+// Find the calls between input sections for --call-graph-ordering.
+// Every reloc in an executable section which refers to a symbol
+// defined in another section counts as one call; Call_graph ignores
+// the ones that do not refer to code.  This runs in the Read_relocs
+// task, when other tasks may be changing the symbol table, so for a
+// global symbol we only record the Symbol, and leave it to Call_graph
+// to find its section.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::do_find_call_graph_edges(
+    Read_relocs_data* rd)
+{
+  const unsigned char* local_symbols;
+  if (rd->local_symbols == NULL)
+    local_symbols = NULL;
+  else
+    local_symbols = rd->local_symbols->data();
+  const unsigned int local_count = this->local_symbol_count_;
+  Call_graph_calls* calls = this->call_graph_calls();
+
+  for (Read_relocs_data::Relocs_list::iterator p = rd->relocs.begin();
+       p != rd->relocs.end();
+       ++p)
+    {
+      // With --gc-sections the output sections are not known yet, so
+      // look at the input section.
+      if (!p->is_data_section_allocated
+	  || (this->section_flags(p->data_shndx) & elfcpp::SHF_EXECINSTR) == 0)
+	continue;
+
+      const unsigned int caller = p->data_shndx;
+      const size_t first = calls->size();
+      const int reloc_size = (p->sh_type == elfcpp::SHT_REL
+			      ? elfcpp::Elf_sizes<size>::rel_size
+			      : elfcpp::Elf_sizes<size>::rela_size);
+      const unsigned char* prelocs = p->contents->data();
+      for (size_t i = 0; i < p->reloc_count; ++i, prelocs += reloc_size)
+	{
+	  // The r_info field is at the same offset in REL and RELA
+	  // relocs.
+	  elfcpp::Rel<size, big_endian> reloc(prelocs);
+	  unsigned int r_sym = elfcpp::elf_r_sym<size>(reloc.get_r_info());
+
+	  if (r_sym < local_count)
+	    {
+	      if (local_symbols == NULL)
+		continue;
+	      elfcpp::Sym<size, big_endian> lsym(local_symbols
+						 + r_sym * This::sym_size);
+	      bool is_ordinary;
+	      unsigned int shndx = this->adjust_sym_shndx(r_sym,
+							  lsym.get_st_shndx(),
+							  &is_ordinary);
+	      if (is_ordinary && shndx != caller)
+		calls->push_back(Call_graph_call(caller, shndx, NULL));
+	    }
+	  else
+	    {
+	      Symbol* gsym = this->global_symbol(r_sym);
+	      if (gsym != NULL)
+		calls->push_back(Call_graph_call(caller, -1U, gsym));
+	    }
+	}
+
+      // Combine the duplicate calls from this section.
+      std::sort(calls->begin() + first, calls->end(),
+		Call_graph_call_compare());
+      size_t out = first;
+      for (size_t in = first; in < calls->size(); ++in)
+	{
+	  if (out > first
+	      && (*calls)[out - 1].callee_symbol == (*calls)[in].callee_symbol
+	      && (*calls)[out - 1].callee_shndx == (*calls)[in].callee_shndx)
+	    (*calls)[out - 1].count += (*calls)[in].count;
+	  else
+	    (*calls)[out++] = (*calls)[in];
+	}
+      calls->erase(calls->begin() + out, calls->end());
+    }
+}
+
 // Scan the relocs and adjust the symbol table.  This looks for
 // relocations which require GOT/PLT/COPY relocations.
 
@@ -824,14 +935,22 @@ Sized_relobj_file<size, big_endian>::write_sections(const Layout* layout,
 
       if (must_decompress)
         {
-	  // Read and decompress the section.
-          section_size_type len;
-	  const unsigned char* p = this->section_contents(i, &len, false);
-	  if (!decompress_input_section(p, len, view, view_size,
-					size, big_endian,
-					shdr.get_sh_flags()))
-	    this->error(_("could not decompress section %s"),
-			this->section_name(i).c_str());
+	  // Read and decompress the section, unless an earlier reader
+	  // kept its decompressed contents.
+	  const unsigned char* cached =
+	    this->cached_decompressed_section_contents(i);
+	  if (cached != NULL)
+	    memcpy(view, cached, view_size);
+	  else
+	    {
+	      section_size_type len;
+	      const unsigned char* p = this->section_contents(i, &len, false);
+	      if (!decompress_input_section(p, len, view, view_size,
+					    size, big_endian,
+					    shdr.get_sh_flags()))
+		this->error(_("could not decompress section %s"),
+			    this->section_name(i).c_str());
+	    }
         }
 
       pvs->view = view;
@@ -1666,6 +1785,30 @@ Sized_relobj_file<64, true>::do_gc_process_relocs(Symbol_table* symtab,
 						  Read_relocs_data* rd);
 #endif
 
+#ifdef HAVE_TARGET_32_LITTLE
+template
+void
+Sized_relobj_file<32, false>::do_find_call_graph_edges(Read_relocs_data* rd);
+#endif
+
+#ifdef HAVE_TARGET_32_BIG
+template
+void
+Sized_relobj_file<32, true>::do_find_call_graph_edges(Read_relocs_data* rd);
+#endif
+
+#ifdef HAVE_TARGET_64_LITTLE
+template
+void
+Sized_relobj_file<64, false>::do_find_call_graph_edges(Read_relocs_data* rd);
+#endif
+
+#ifdef HAVE_TARGET_64_BIG
+template
+void
+Sized_relobj_file<64, true>::do_find_call_graph_edges(Read_relocs_data* rd);
+#endif
+
 #ifdef HAVE_TARGET_32_LITTLE
 template
 void
@@ -30,6 +30,7 @@
 
 #include "elfcpp.h"
 #include "workqueue.h"
+#include "memstats.h"
 
 namespace gold
 {
@@ -264,7 +265,22 @@ class Relocatable_relocs
   // Record the number of relocs.
   void
   set_reloc_count(size_t reloc_count)
-  { this->reloc_strategies_.reserve(reloc_count); }
+  {
+    size_t old_capacity = this->reloc_strategies_.capacity();
+    this->reloc_strategies_.reserve(reloc_count);
+    Memory_stats::resize(Memory_stats::RELOCS, old_capacity,
+			 this->reloc_strategies_.capacity());
+  }
+
+  // Free the reloc strategies, once the relocs have been written.
+  // The output reloc count is kept.
+  void
+  release_reloc_strategies()
+  {
+    Memory_stats::add(Memory_stats::RELOCS,
+		      -static_cast<int64_t>(this->reloc_strategies_.capacity()));
+    std::vector<unsigned char>().swap(this->reloc_strategies_);
+  }
 
   // Record what to do for the next reloc.
   void
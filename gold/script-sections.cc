@@ -635,6 +635,12 @@ class Sections_element
 		      Script_sections::Section_type*, bool*, bool)
   { return NULL; }
 
+  // Add the input section specifications to MATCHER.  The only real
+  // implementation is in Output_section_definition.
+  virtual void
+  add_to_matcher(Input_section_matcher*)
+  { }
+
   // Initialize OSP with an output section.
   virtual void
   orphan_section_init(Orphan_section_placement*,
@@ -853,6 +859,13 @@ class Output_section_element
   match_name(const char*, const char*, bool *) const
   { return false; }
 
+  // Add this element, which is part of the output section POSD, to
+  // MATCHER.  The only real implementation is in
+  // Output_section_element_input.
+  virtual void
+  add_to_matcher(Input_section_matcher*, Output_section_definition*) const
+  { }
+
   // Set section addresses.  This includes applying assignments if the
   // expression is an absolute value.
   virtual void
@@ -1293,6 +1306,15 @@ class Output_section_element_input : public Output_section_element
   bool
   match_name(const char* file_name, const char* section_name, bool* keep) const;
 
+  // See if we match a file name.
+  bool
+  match_file_name(const char* file_name) const;
+
+  // Add our section name patterns to MATCHER.
+  void
+  add_to_matcher(Input_section_matcher* matcher,
+		 Output_section_definition* posd) const;
+
   // Set the section address.
   void
   set_section_addresses(Symbol_table* symtab, Layout* layout, Output_section*,
@@ -1336,10 +1358,6 @@ class Output_section_element_input : public Output_section_element
 	    : strcmp(string, pattern) == 0);
   }
 
-  // See if we match a file name.
-  bool
-  match_file_name(const char* file_name) const;
-
   // The file name pattern.  If this is the empty string, we match all
   // files.
   std::string filename_pattern_;
@@ -1474,6 +1492,198 @@ Output_section_element_input::match_name(const char* file_name,
   return false;
 }
 
+// A compiled form of all the input section specifications in the
+// SECTIONS clause.  This is used to find the first specification
+// which matches an input section without trying every pattern in
+// turn.  Each section name pattern gets an entry, numbered in script
+// order.  Patterns without wildcards are found in a hash table.
+// Patterns whose only wildcard is a trailing '*' are found by looking
+// up the prefixes of the section name in another hash table.  Other
+// patterns are matched with fnmatch.  The matching entry with the
+// smallest number is the one the script would have picked.
+
+class Input_section_matcher
+{
+ public:
+  Input_section_matcher()
+    : entries_(), exact_(), prefixes_(), prefix_lengths_(), globs_(),
+      any_()
+  { }
+
+  // Add an input section specification INPUT in the output section
+  // POSD which matches all section names.
+  void
+  add_any(Output_section_definition* posd,
+	  const Output_section_element_input* input)
+  {
+    this->any_.push_back(this->entries_.size());
+    this->entries_.push_back(Entry(posd, input, NULL));
+  }
+
+  // Add the section name pattern PATTERN of the input section
+  // specification INPUT in the output section POSD.
+  void
+  add_pattern(Output_section_definition* posd,
+	      const Output_section_element_input* input,
+	      const std::string& pattern, bool is_wildcard);
+
+  // Return the output section definition of the first input section
+  // specification which matches FILE_NAME and SECTION_NAME, or NULL.
+  Output_section_definition*
+  find(const char* file_name, const char* section_name) const;
+
+ private:
+  // An input section specification and one of its section name
+  // patterns.
+  struct Entry
+  {
+    Entry(Output_section_definition* posda,
+	  const Output_section_element_input* inputa, const char* globa)
+      : posd(posda), input(inputa), glob(globa)
+    { }
+
+    // The output section definition.
+    Output_section_definition* posd;
+    // The input section specification.
+    const Output_section_element_input* input;
+    // The pattern to pass to fnmatch, or NULL if the section name has
+    // already been matched by the time we look at this entry.
+    const char* glob;
+  };
+
+  // A list of entry numbers, in increasing order.
+  typedef std::vector<unsigned int> Entry_list;
+  typedef Unordered_map<std::string, Entry_list> Entry_table;
+
+  // Look through LIST for an entry before *PBEST which matches
+  // FILE_NAME and SECTION_NAME, and set *PBEST if we find one.
+  void
+  first_match(const Entry_list& list, const char* file_name,
+	      const char* section_name, unsigned int* pbest) const;
+
+  // All the entries.
+  std::vector<Entry> entries_;
+  // Entries for patterns without wildcards, keyed by the pattern.
+  Entry_table exact_;
+  // Entries for patterns ending in '*', keyed by the prefix.
+  Entry_table prefixes_;
+  // The distinct lengths of the keys in prefixes_, in increasing
+  // order.
+  std::vector<size_t> prefix_lengths_;
+  // Entries for other wildcard patterns.
+  Entry_list globs_;
+  // Entries for specifications without section name patterns.
+  Entry_list any_;
+};
+
+// Add a section name pattern.
+
+void
+Input_section_matcher::add_pattern(Output_section_definition* posd,
+				   const Output_section_element_input* input,
+				   const std::string& pattern,
+				   bool is_wildcard)
+{
+  unsigned int index = this->entries_.size();
+  if (!is_wildcard)
+    {
+      this->entries_.push_back(Entry(posd, input, NULL));
+      this->exact_[pattern].push_back(index);
+      return;
+    }
+
+  size_t len = pattern.length();
+  if (len > 0
+      && pattern[len - 1] == '*'
+      && pattern.find_first_of("?*[\\") == len - 1)
+    {
+      this->entries_.push_back(Entry(posd, input, NULL));
+      this->prefixes_[pattern.substr(0, len - 1)].push_back(index);
+      std::vector<size_t>::iterator p =
+	std::lower_bound(this->prefix_lengths_.begin(),
+			 this->prefix_lengths_.end(), len - 1);
+      if (p == this->prefix_lengths_.end() || *p != len - 1)
+	this->prefix_lengths_.insert(p, len - 1);
+      return;
+    }
+
+  this->entries_.push_back(Entry(posd, input, pattern.c_str()));
+  this->globs_.push_back(index);
+}
+
+// Find the first matching input section specification.
+
+Output_section_definition*
+Input_section_matcher::find(const char* file_name,
+			    const char* section_name) const
+{
+  unsigned int best = -1U;
+
+  std::string name(section_name);
+  Entry_table::const_iterator p = this->exact_.find(name);
+  if (p != this->exact_.end())
+    this->first_match(p->second, file_name, section_name, &best);
+
+  for (std::vector<size_t>::const_iterator pl = this->prefix_lengths_.begin();
+       pl != this->prefix_lengths_.end() && *pl <= name.length();
+       ++pl)
+    {
+      p = this->prefixes_.find(name.substr(0, *pl));
+      if (p != this->prefixes_.end())
+	this->first_match(p->second, file_name, section_name, &best);
+    }
+
+  this->first_match(this->globs_, file_name, section_name, &best);
+  this->first_match(this->any_, file_name, section_name, &best);
+
+  if (best == -1U)
+    return NULL;
+  return this->entries_[best].posd;
+}
+
+// Look through LIST for the first entry which matches.  The entries
+// in LIST are in increasing order, so we can stop at *PBEST.
+
+void
+Input_section_matcher::first_match(const Entry_list& list,
+				   const char* file_name,
+				   const char* section_name,
+				   unsigned int* pbest) const
+{
+  for (Entry_list::const_iterator p = list.begin();
+       p != list.end() && *p < *pbest;
+       ++p)
+    {
+      const Entry& entry(this->entries_[*p]);
+      if (entry.glob != NULL && fnmatch(entry.glob, section_name, 0) != 0)
+	continue;
+      if (!entry.input->match_file_name(file_name))
+	continue;
+      *pbest = *p;
+      return;
+    }
+}
+
+// Add our section name patterns to MATCHER.
+
+void
+Output_section_element_input::add_to_matcher(
+    Input_section_matcher* matcher,
+    Output_section_definition* posd) const
+{
+  if (this->input_section_patterns_.empty())
+    {
+      matcher->add_any(posd, this);
+      return;
+    }
+
+  for (Input_section_patterns::const_iterator p =
+	 this->input_section_patterns_.begin();
+       p != this->input_section_patterns_.end();
+       ++p)
+    matcher->add_pattern(posd, this, p->pattern, p->pattern_is_wildcard);
+}
+
 // Information we use to sort the input sections.
 
 class Input_section_info
@@ -2005,6 +2215,10 @@ class Output_section_definition : public Sections_element
 		      Output_section***, Script_sections::Section_type*,
 		      bool*, bool);
 
+  // Add our input section specifications to MATCHER.
+  void
+  add_to_matcher(Input_section_matcher* matcher);
+
   // Initialize OSP with an output section.
   void
   orphan_section_init(Orphan_section_placement* osp,
@@ -2322,6 +2536,17 @@ Output_section_definition::output_section_name(
   return NULL;
 }
 
+// Add the input section specifications to MATCHER.
+
+void
+Output_section_definition::add_to_matcher(Input_section_matcher* matcher)
+{
+  for (Output_section_elements::const_iterator p = this->elements_.begin();
+       p != this->elements_.end();
+       ++p)
+    (*p)->add_to_matcher(matcher, this);
+}
+
 // Return true if memory from START to START + LENGTH is contained
 // within a memory region.
 
@@ -3343,6 +3568,7 @@ Script_sections::Script_sections()
     memory_regions_(NULL),
     phdrs_elements_(NULL),
     orphan_section_placement_(NULL),
+    input_section_matcher_(NULL),
     data_segment_align_start_(),
     saw_data_segment_align_(false),
     saw_relro_end_(false),
@@ -3361,6 +3587,13 @@ Script_sections::start_sections()
   this->in_sections_clause_ = true;
   if (this->sections_elements_ == NULL)
     this->sections_elements_ = new Sections_elements;
+
+  // Any compiled input section specifications are now out of date.
+  if (this->input_section_matcher_ != NULL)
+    {
+      delete this->input_section_matcher_;
+      this->input_section_matcher_ = NULL;
+    }
 }
 
 // Finish a SECTIONS clause.
@@ -3572,27 +3805,59 @@ Script_sections::output_section_name(
     bool* keep,
     bool is_input_section)
 {
-  for (Sections_elements::const_iterator p = this->sections_elements_->begin();
-       p != this->sections_elements_->end();
-       ++p)
+  const char* ret = NULL;
+  if (is_input_section)
     {
-      const char* ret = (*p)->output_section_name(file_name, section_name,
-						  output_section_slot,
-						  psection_type, keep,
-						  is_input_section);
+      // Use the compiled input section specifications to find the
+      // first output section which matches.  This is called from
+      // the layout code, which runs in one thread at a time.
+      if (this->input_section_matcher_ == NULL)
+	{
+	  this->input_section_matcher_ = new Input_section_matcher();
+	  for (Sections_elements::const_iterator p =
+		 this->sections_elements_->begin();
+	       p != this->sections_elements_->end();
+	       ++p)
+	    (*p)->add_to_matcher(this->input_section_matcher_);
+	}
 
-      if (ret != NULL)
+      Output_section_definition* posd =
+	this->input_section_matcher_->find(file_name, section_name);
+      if (posd != NULL)
 	{
-	  // The special name /DISCARD/ means that the input section
-	  // should be discarded.
-	  if (strcmp(ret, "/DISCARD/") == 0)
-	    {
-	      *output_section_slot = NULL;
-	      *psection_type = Script_sections::ST_NONE;
-	      return NULL;
-	    }
-	  return ret;
+	  ret = posd->output_section_name(file_name, section_name,
+					  output_section_slot,
+					  psection_type, keep, true);
+	  gold_assert(ret != NULL);
+	}
+    }
+  else
+    {
+      for (Sections_elements::const_iterator p =
+	     this->sections_elements_->begin();
+	   p != this->sections_elements_->end();
+	   ++p)
+	{
+	  ret = (*p)->output_section_name(file_name, section_name,
+					  output_section_slot,
+					  psection_type, keep,
+					  is_input_section);
+	  if (ret != NULL)
+	    break;
+	}
+    }
+
+  if (ret != NULL)
+    {
+      // The special name /DISCARD/ means that the input section
+      // should be discarded.
+      if (strcmp(ret, "/DISCARD/") == 0)
+	{
+	  *output_section_slot = NULL;
+	  *psection_type = Script_sections::ST_NONE;
+	  return NULL;
 	}
+      return ret;
     }
 
   // We have an orphan section.
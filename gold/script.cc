@@ -25,6 +25,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
 #include <fnmatch.h>
 #include <string>
 #include <vector>
@@ -2022,7 +2023,10 @@ Version_script_info::Version_script_info()
     default_version_(NULL), default_is_global_(false), is_finalized_(false)
 {
   for (int i = 0; i < LANGUAGE_COUNT; ++i)
-    this->exact_[i] = NULL;
+    {
+      this->exact_[i] = NULL;
+      this->glob_sets_[i] = NULL;
+    }
 }
 
 Version_script_info::~Version_script_info()
@@ -2043,6 +2047,11 @@ Version_script_info::clear()
   for (size_t k = 0; k < this->expression_lists_.size(); ++k)
     delete this->expression_lists_[k];
   this->expression_lists_.clear();
+  for (int i = 0; i < LANGUAGE_COUNT; ++i)
+    {
+      delete this->glob_sets_[i];
+      this->glob_sets_[i] = NULL;
+    }
 }
 
 // Finalize the version script information.
@@ -2178,6 +2187,40 @@ Version_script_info::build_lookup_tables()
       this->build_expression_list_lookup(v->local, v, false);
       this->build_expression_list_lookup(v->global, v, true);
     }
+  this->build_glob_sets();
+}
+
+// Sort the glob patterns in globs_ into a Glob_set for each language.
+
+void
+Version_script_info::build_glob_sets()
+{
+  int count = static_cast<int>(this->globs_.size());
+  for (int i = 0; i < count; ++i)
+    {
+      const Version_expression* exp = this->globs_[i].expression;
+      Glob_set*& gs(this->glob_sets_[exp->language]);
+      if (gs == NULL)
+	gs = new Glob_set();
+      gs->max_index = i;
+
+      // We match globs with FNM_NOESCAPE, so a backslash is an
+      // ordinary character here.
+      size_t len = exp->pattern.find_first_of("?*[");
+      gold_assert(len != std::string::npos);
+      if (len == 0)
+	{
+	  gs->others.push_back(i);
+	  continue;
+	}
+
+      gs->prefixes[exp->pattern.substr(0, len)].push_back(i);
+      std::vector<size_t>::iterator p =
+	std::lower_bound(gs->prefix_lengths.begin(),
+			 gs->prefix_lengths.end(), len);
+      if (p == gs->prefix_lengths.end() || *p != len)
+	gs->prefix_lengths.insert(p, len);
+    }
 }
 
 // If a pattern has backlashes but no unquoted wildcard characters,
@@ -2389,29 +2432,47 @@ Version_script_info::get_symbol_version(const char* symbol_name,
 	}
     }
 
-  // Look through the glob patterns in reverse order.
+  // Look through the glob patterns for the last one which matches.
+  // We do the languages in order, starting with C, and skip a
+  // language if none of its patterns come after the best match we
+  // have so far.  That way we only demangle the name if a C++ or
+  // Java pattern could be the one we use.
 
-  for (Globs::const_reverse_iterator p = this->globs_.rbegin();
-       p != this->globs_.rend();
-       ++p)
+  int best = -1;
+  for (int i = 0; i < LANGUAGE_COUNT; ++i)
     {
-      int language = p->expression->language;
-      const char* name_to_match = this->get_name_to_match(symbol_name,
-							  language,
+      const Glob_set* gs = this->glob_sets_[i];
+      if (gs == NULL || gs->max_index <= best)
+	continue;
+
+      const char* name_to_match = this->get_name_to_match(symbol_name, i,
 							  &cpp_demangled_name,
 							  &java_demangled_name);
       if (name_to_match == NULL)
 	continue;
 
-      if (fnmatch(p->expression->pattern.c_str(), name_to_match,
-		  FNM_NOESCAPE) == 0)
+      size_t len = strlen(name_to_match);
+      for (std::vector<size_t>::const_iterator pl =
+	     gs->prefix_lengths.begin();
+	   pl != gs->prefix_lengths.end() && *pl <= len;
+	   ++pl)
 	{
-	  if (pversion != NULL)
-	    *pversion = p->version->tag;
-	  if (p_is_global != NULL)
-	    *p_is_global = p->is_global;
-	  return true;
+	  Unordered_map<std::string, Glob_indexes>::const_iterator pp =
+	    gs->prefixes.find(std::string(name_to_match, *pl));
+	  if (pp != gs->prefixes.end())
+	    this->match_globs(pp->second, name_to_match, &best);
 	}
+      this->match_globs(gs->others, name_to_match, &best);
+    }
+
+  if (best >= 0)
+    {
+      const Glob& g(this->globs_[best]);
+      if (pversion != NULL)
+	*pversion = g.version->tag;
+      if (p_is_global != NULL)
+	*p_is_global = g.is_global;
+      return true;
     }
 
   // Finally, there may be a wildcard.
@@ -2427,6 +2488,26 @@ Version_script_info::get_symbol_version(const char* symbol_name,
   return false;
 }
 
+// Set *PBEST to the largest index in INDEXES which is larger than
+// *PBEST and whose pattern matches NAME.
+
+void
+Version_script_info::match_globs(const Glob_indexes& indexes,
+				 const char* name, int* pbest) const
+{
+  for (Glob_indexes::const_reverse_iterator p = indexes.rbegin();
+       p != indexes.rend() && *p > *pbest;
+       ++p)
+    {
+      if (fnmatch(this->globs_[*p].expression->pattern.c_str(), name,
+		  FNM_NOESCAPE) == 0)
+	{
+	  *pbest = *p;
+	  return;
+	}
+    }
+}
+
 // Give an error if any exact symbol names (not wildcards) appear in a
 // version script, but there is no such symbol.
 
@@ -291,6 +291,30 @@ class Version_script_info
 
   typedef std::vector<Glob> Globs;
 
+  // A list of indexes into globs_, in increasing order.
+  typedef std::vector<int> Glob_indexes;
+
+  // The glob patterns for a single language, arranged so that we
+  // only try the patterns which can match a given name.  A pattern
+  // which starts with literal characters is found by looking up that
+  // prefix of the name.  The other patterns are always tried.
+  struct Glob_set
+  {
+    Glob_set()
+      : prefixes(), prefix_lengths(), others(), max_index(-1)
+    { }
+
+    // Map from a literal prefix to the patterns which start with it.
+    Unordered_map<std::string, Glob_indexes> prefixes;
+    // The distinct lengths of the keys in PREFIXES, in increasing
+    // order.
+    std::vector<size_t> prefix_lengths;
+    // Patterns which start with a wildcard.
+    Glob_indexes others;
+    // The largest index of any pattern in this set.
+    int max_index;
+  };
+
   bool
   unquote(std::string*) const;
 
@@ -306,6 +330,12 @@ class Version_script_info
   get_name_to_match(const char*, int,
 		    Lazy_demangler*, Lazy_demangler*) const;
 
+  void
+  build_glob_sets();
+
+  void
+  match_globs(const Glob_indexes&, const char*, int*) const;
+
   // All the version dependencies we allocate.
   std::vector<Version_dependency_list*> dependency_lists_;
   // All the version expressions we allocate.
@@ -316,6 +346,8 @@ class Version_script_info
   Exact* exact_[LANGUAGE_COUNT];
   // A vector of glob patterns mapping to Version_trees.
   Globs globs_;
+  // The glob patterns by language, or NULL if there are none.
+  Glob_set* glob_sets_[LANGUAGE_COUNT];
   // The default version to use, if there is one.  This is from a
   // pattern of "*".
   const Version_tree* default_version_;
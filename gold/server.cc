@@ -0,0 +1,1170 @@
+// server.cc -- resident link server for gold
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <vector>
+
+#ifndef __MINGW32__
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#endif
+
+#include "server.h"
+
+extern char** environ;
+
+namespace gold
+{
+
+// The link server which started this link process, if any.
+
+const Link_server* link_server;
+
+// The default maximum size of the input file cache, in megabytes.
+
+static const uint64_t default_cache_size = 1024;
+
+// The most bytes of input files which the server reads into the cache
+// between two polls, so that a large file does not hold up new links.
+
+static const size_t cache_slice = 1024 * 1024;
+
+// The arguments which start a link server, set the size of its cache
+// and set the number of links it runs at the same time.
+
+static const char link_server_option[] = "--link-server=";
+static const char cache_size_option[] = "--link-server-cache-size=";
+static const char jobs_option[] = "--link-server-jobs=";
+
+// The environment variable which names the link server to use.
+
+static const char link_server_variable[] = "GOLD_LINK_SERVER";
+
+// Report a fatal error in the link server or client.  We can not use
+// gold_fatal here, as there are no parameters yet.
+
+static void
+server_fatal(const char* format, ...) ATTRIBUTE_NORETURN ATTRIBUTE_PRINTF_1;
+
+static void
+server_fatal(const char* format, ...)
+{
+  fprintf(stderr, "%s: ", program_name);
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+  fputc('\n', stderr);
+  exit(EXIT_FAILURE);
+}
+
+#ifndef __MINGW32__
+
+// The link request sent by the client is a sequence of strings, each
+// preceded by its length as a 32-bit number in host order: the working
+// directory, the umask in octal, the number of arguments as a string,
+// the arguments, the number of environment strings as a string, and
+// the environment.  The client's standard input, output and error are
+// passed along with the first byte.  The client keeps the connection
+// open while the link runs, and sends a byte holding the number of any
+// SIGINT, SIGTERM or SIGHUP that it receives; the server sends that
+// signal to the link, and kills the link if the client goes away.  The
+// reply is the exit status of the link as a 32-bit number.
+
+// Write SIZE bytes at P to FD.  Return false on error.
+
+static bool
+write_all(int fd, const void* p, size_t size)
+{
+  const char* c = static_cast<const char*>(p);
+  while (size > 0)
+    {
+      ssize_t bytes = ::write(fd, c, size);
+      if (bytes < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  return false;
+	}
+      c += bytes;
+      size -= bytes;
+    }
+  return true;
+}
+
+// Read SIZE bytes from FD to P.  Return false on error or end of file.
+
+static bool
+read_all(int fd, void* p, size_t size)
+{
+  char* c = static_cast<char*>(p);
+  while (size > 0)
+    {
+      ssize_t bytes = ::read(fd, c, size);
+      if (bytes < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  return false;
+	}
+      if (bytes == 0)
+	return false;
+      c += bytes;
+      size -= bytes;
+    }
+  return true;
+}
+
+// Append the string S to the request *REQUEST.
+
+static void
+add_string(std::string* request, const char* s)
+{
+  uint32_t len = strlen(s);
+  request->append(reinterpret_cast<const char*>(&len), sizeof len);
+  request->append(s, len);
+}
+
+// Read a string of the request from FD into *S.
+
+static bool
+read_string(int fd, std::string* s)
+{
+  uint32_t len;
+  if (!read_all(fd, &len, sizeof len))
+    return false;
+  // Anything this long is not a sensible request.
+  if (len > 16 * 1024 * 1024)
+    return false;
+  s->resize(len);
+  return len == 0 || read_all(fd, &(*s)[0], len);
+}
+
+// Read a string of the request from FD which holds a number in BASE
+// into *VALUE.
+
+static bool
+read_number(int fd, int base, unsigned long* value)
+{
+  std::string s;
+  if (!read_string(fd, &s) || s.empty())
+    return false;
+  char* end;
+  *value = strtoul(s.c_str(), &end, base);
+  return *end == '\0';
+}
+
+// Make a copy of the strings in V, as a NULL terminated vector.
+
+static char**
+string_vector(const std::vector<std::string>& v)
+{
+  char** ret = new char*[v.size() + 1];
+  for (size_t i = 0; i < v.size(); ++i)
+    ret[i] = strdup(v[i].c_str());
+  ret[v.size()] = NULL;
+  return ret;
+}
+
+// Return the modification and change times of ST.
+
+static Timespec
+stat_mtime(const struct stat& st)
+{
+#ifdef HAVE_STAT_ST_MTIM
+  return Timespec(st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+#else
+  return Timespec(st.st_mtime, 0);
+#endif
+}
+
+static Timespec
+stat_ctime(const struct stat& st)
+{
+#ifdef HAVE_STAT_ST_MTIM
+  return Timespec(st.st_ctim.tv_sec, st.st_ctim.tv_nsec);
+#else
+  return Timespec(st.st_ctime, 0);
+#endif
+}
+
+static bool
+same_time(const Timespec& t1, const Timespec& t2)
+{
+  return t1.seconds == t2.seconds && t1.nanoseconds == t2.nanoseconds;
+}
+
+// Set *UID to the user running the process at the other end of the
+// connection FD.  Return false if we can not tell.
+
+static bool
+peer_uid(int fd, uid_t* uid)
+{
+#if defined(HAVE_GETPEEREID)
+  gid_t gid;
+  return ::getpeereid(fd, uid, &gid) == 0;
+#elif defined(SO_PEERCRED) && defined(__linux__)
+  struct ucred cred;
+  socklen_t len = sizeof cred;
+  if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) < 0)
+    return false;
+  *uid = cred.uid;
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Turn the wait status WSTATUS into an exit status for the client.
+
+static int32_t
+exit_status(int wstatus)
+{
+  if (WIFEXITED(wstatus))
+    return WEXITSTATUS(wstatus);
+  else if (WIFSIGNALED(wstatus))
+    return 128 + WTERMSIG(wstatus);
+  else
+    return EXIT_FAILURE;
+}
+
+// The signals which the client passes on to the link.
+
+static const int forwarded_signals[] = { SIGINT, SIGTERM, SIGHUP };
+
+static const size_t forwarded_signal_count =
+  sizeof forwarded_signals / sizeof forwarded_signals[0];
+
+// Whether the client passes the signal SIG on to the link.
+
+static bool
+is_forwarded_signal(int sig)
+{
+  for (size_t i = 0; i < forwarded_signal_count; ++i)
+    if (forwarded_signals[i] == sig)
+      return true;
+  return false;
+}
+
+// The server learns that a link process has exited from a byte written
+// to this pipe by the SIGCHLD handler, so that it can wait for that
+// and for new connections in the same poll.
+
+static int sigchld_pipe[2] = { -1, -1 };
+
+extern "C" void
+link_server_sigchld(int)
+{
+  int saved_errno = errno;
+  char c = 0;
+  if (::write(sigchld_pipe[1], &c, 1) < 0)
+    {
+      // The pipe is full, so the server will look for exited links
+      // anyhow.
+    }
+  errno = saved_errno;
+}
+
+// Class Link_server.
+
+Link_server::Link_server(const char* socket_name, uint64_t cache_limit,
+			 unsigned int max_links)
+  : socket_name_(socket_name), cache_limit_(cache_limit),
+    max_links_(max_links), links_(), cache_size_(0), cache_(),
+    link_count_(0), pending_inputs_(), pending_pos_(0), fill_fd_(-1),
+    fill_(), fill_done_(0), cwd_(), inputs_fd_(-1)
+{
+}
+
+Link_server::~Link_server()
+{
+  for (Cache::iterator p = this->cache_.begin(); p != this->cache_.end(); ++p)
+    delete[] p->second.contents;
+  if (this->fill_fd_ >= 0)
+    {
+      ::close(this->fill_fd_);
+      delete[] this->fill_.contents;
+    }
+}
+
+// Whether the cache entry C describes the file ST.  A file rewritten
+// in place keeps its device and inode, so it is the times which tell
+// us that it changed; compare them to the nanosecond where we can.
+
+bool
+Link_server::is_current(const Cached_file& c, const struct stat& st)
+{
+  return (c.dev == st.st_dev
+	  && c.ino == st.st_ino
+	  && c.size == st.st_size
+	  && same_time(c.mtime, stat_mtime(st))
+	  && same_time(c.ctime, stat_ctime(st)));
+}
+
+// Create the socket and listen on it.  Anybody who can connect to the
+// socket can run links as the user running the server, so the socket
+// lives in a directory which only that user can get at, and start_link
+// checks who is connecting as well.
+
+int
+Link_server::listen()
+{
+  const char* name = this->socket_name_.c_str();
+  struct sockaddr_un addr;
+  if (this->socket_name_.length() >= sizeof addr.sun_path)
+    server_fatal(_("link server socket name too long: %s"), name);
+
+  std::string dir;
+  size_t slash = this->socket_name_.rfind('/');
+  if (slash == std::string::npos)
+    dir = ".";
+  else if (slash == 0)
+    dir = "/";
+  else
+    dir = this->socket_name_.substr(0, slash);
+
+  struct stat st;
+  if (::lstat(dir.c_str(), &st) < 0)
+    {
+      if (errno != ENOENT || ::mkdir(dir.c_str(), 0700) < 0
+	  || ::lstat(dir.c_str(), &st) < 0)
+	server_fatal(_("cannot create link server directory %s: %s"),
+		     dir.c_str(), strerror(errno));
+    }
+  if (!S_ISDIR(st.st_mode)
+      || st.st_uid != ::geteuid()
+      || (st.st_mode & (S_IRWXG | S_IRWXO)) != 0)
+    server_fatal(_("link server directory %s must be owned by you and "
+		   "not accessible to anybody else"),
+		 dir.c_str());
+
+  // Only remove an old socket, never whatever else the user named.
+  if (::lstat(name, &st) == 0)
+    {
+      if (!S_ISSOCK(st.st_mode))
+	server_fatal(_("%s exists and is not a socket"), name);
+      if (::unlink(name) < 0)
+	server_fatal(_("cannot remove %s: %s"), name, strerror(errno));
+    }
+
+  int sock = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sock < 0)
+    server_fatal(_("cannot create link server socket: %s"), strerror(errno));
+  fcntl(sock, F_SETFD, FD_CLOEXEC);
+
+  memset(&addr, 0, sizeof addr);
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, name);
+  mode_t old_umask = ::umask(077);
+  bool ok = ::bind(sock, reinterpret_cast<struct sockaddr*>(&addr),
+		   sizeof addr) == 0;
+  ::umask(old_umask);
+  if (!ok
+      || ::chmod(name, 0600) < 0
+      || ::listen(sock, SOMAXCONN) < 0)
+    server_fatal(_("cannot listen on %s: %s"), name, strerror(errno));
+  return sock;
+}
+
+// Listen for links, and run up to max_links_ of them at the same time.
+
+void
+Link_server::run(int* pargc, char*** pargv)
+{
+  int sock = this->listen();
+
+  // A client which goes away must not kill the server.
+  signal(SIGPIPE, SIG_IGN);
+
+  if (::pipe(sigchld_pipe) < 0)
+    server_fatal(_("cannot create pipe: %s"), strerror(errno));
+  for (int i = 0; i < 2; ++i)
+    {
+      fcntl(sigchld_pipe[i], F_SETFD, FD_CLOEXEC);
+      fcntl(sigchld_pipe[i], F_SETFL, O_NONBLOCK);
+    }
+  struct sigaction sa;
+  memset(&sa, 0, sizeof sa);
+  sa.sa_handler = link_server_sigchld;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+  sigaction(SIGCHLD, &sa, NULL);
+
+  // Make sure that descriptors 0 to 2 are in use, so that the
+  // descriptors we receive or create are never among them.
+  int fd;
+  while ((fd = ::open("/dev/null", O_RDWR)) >= 0 && fd <= 2)
+    ;
+  if (fd > 2)
+    ::close(fd);
+
+  std::vector<struct pollfd> pfds;
+  while (true)
+    {
+      // Stop accepting connections while we are running as many links
+      // as we may; the clients wait in the listen queue.
+      pfds.clear();
+      struct pollfd pfd;
+      pfd.fd = sigchld_pipe[0];
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      pfds.push_back(pfd);
+      bool accepting = this->links_.size() < this->max_links_;
+      pfd.fd = accepting ? sock : -1;
+      pfds.push_back(pfd);
+      for (Links::const_iterator p = this->links_.begin();
+	   p != this->links_.end();
+	   ++p)
+	{
+	  pfd.fd = p->inputs_fd;
+	  pfds.push_back(pfd);
+	  pfd.fd = p->conn;
+	  pfds.push_back(pfd);
+	}
+
+      // While there are input files to cache, only look for work
+      // between slices of them.
+      int timeout = this->filling_cache() ? 0 : -1;
+      if (::poll(&pfds[0], pfds.size(), timeout) < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  server_fatal(_("poll failed: %s"), strerror(errno));
+	}
+
+      size_t i = 2;
+      for (Links::iterator p = this->links_.begin();
+	   p != this->links_.end();
+	   ++p, i += 2)
+	{
+	  if (pfds[i].revents != 0)
+	    this->read_inputs(&*p);
+	  if (pfds[i + 1].revents != 0)
+	    this->read_signals(&*p);
+	}
+
+      if (pfds[0].revents != 0)
+	{
+	  char buf[64];
+	  while (::read(sigchld_pipe[0], buf, sizeof buf) > 0)
+	    ;
+	  this->reap_links();
+	}
+
+      this->finish_links();
+
+      if (this->filling_cache())
+	this->fill_cache();
+
+      if (accepting && pfds[1].revents != 0)
+	{
+	  int conn = ::accept(sock, NULL, NULL);
+	  if (conn < 0)
+	    {
+	      if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN)
+		continue;
+	      server_fatal(_("cannot accept link request: %s"),
+			   strerror(errno));
+	    }
+	  if (this->start_link(sock, conn, pargc, pargv))
+	    return;
+	}
+    }
+}
+
+// Start the link requested on CONN.  Return true in the link process.
+// In the server, CONN belongs to the new entry in links_, or is closed
+// if the link could not be started.
+
+bool
+Link_server::start_link(int sock, int conn, int* pargc, char*** pargv)
+{
+  fcntl(conn, F_SETFD, FD_CLOEXEC);
+
+  uid_t uid;
+  if (!peer_uid(conn, &uid) || uid != ::geteuid())
+    {
+      fprintf(stderr, _("%s: refusing link request from another user\n"),
+	      program_name);
+      ::close(conn);
+      return false;
+    }
+
+  // Receive the descriptors with the first byte.
+  char c;
+  struct iovec iov;
+  iov.iov_base = &c;
+  iov.iov_len = 1;
+  union
+  {
+    struct cmsghdr align;
+    char buf[CMSG_SPACE(3 * sizeof(int))];
+  } control;
+  struct msghdr msg;
+  memset(&msg, 0, sizeof msg);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof control.buf;
+  struct cmsghdr* cmsg = NULL;
+  if (::recvmsg(conn, &msg, 0) == 1)
+    cmsg = CMSG_FIRSTHDR(&msg);
+  if (cmsg == NULL
+      || cmsg->cmsg_level != SOL_SOCKET
+      || cmsg->cmsg_type != SCM_RIGHTS
+      || cmsg->cmsg_len != CMSG_LEN(3 * sizeof(int)))
+    {
+      ::close(conn);
+      return false;
+    }
+  int fds[3];
+  memcpy(fds, CMSG_DATA(cmsg), sizeof fds);
+
+  std::string cwd;
+  unsigned long mask;
+  unsigned long nargs;
+  unsigned long nenv;
+  std::vector<std::string> args;
+  std::vector<std::string> env;
+  bool ok = (read_string(conn, &cwd)
+	     && read_number(conn, 8, &mask)
+	     && mask <= 0777
+	     && read_number(conn, 10, &nargs)
+	     && nargs > 0);
+  for (unsigned long i = 0; ok && i < nargs; ++i)
+    {
+      args.push_back(std::string());
+      ok = read_string(conn, &args.back());
+    }
+  ok = ok && read_number(conn, 10, &nenv);
+  for (unsigned long i = 0; ok && i < nenv; ++i)
+    {
+      env.push_back(std::string());
+      ok = read_string(conn, &env.back());
+    }
+
+  int pipefd[2];
+  pid_t pid = -1;
+  if (ok && ::pipe(pipefd) == 0)
+    {
+      fcntl(pipefd[0], F_SETFD, FD_CLOEXEC);
+      fcntl(pipefd[1], F_SETFD, FD_CLOEXEC);
+      pid = ::fork();
+      if (pid == 0)
+	{
+	  // This is the link process.  It does not need anything which
+	  // belongs to the server or to the other links.
+	  ::close(sock);
+	  ::close(conn);
+	  ::close(pipefd[0]);
+	  for (Links::const_iterator p = this->links_.begin();
+	       p != this->links_.end();
+	       ++p)
+	    {
+	      if (p->conn >= 0)
+		::close(p->conn);
+	      if (p->inputs_fd >= 0)
+		::close(p->inputs_fd);
+	    }
+	  this->links_.clear();
+	  if (this->fill_fd_ >= 0)
+	    {
+	      ::close(this->fill_fd_);
+	      this->fill_fd_ = -1;
+	      delete[] this->fill_.contents;
+	    }
+	  signal(SIGCHLD, SIG_DFL);
+	  ::close(sigchld_pipe[0]);
+	  ::close(sigchld_pipe[1]);
+	  signal(SIGPIPE, SIG_DFL);
+	  // The server may have been started with these ignored, but
+	  // the client only passes them on if it does not ignore them.
+	  for (size_t i = 0; i < forwarded_signal_count; ++i)
+	    signal(forwarded_signals[i], SIG_DFL);
+	  for (int i = 0; i < 3; ++i)
+	    {
+	      if (fds[i] != i)
+		{
+		  ::dup2(fds[i], i);
+		  ::close(fds[i]);
+		}
+	    }
+	  if (::chdir(cwd.c_str()) < 0)
+	    server_fatal(_("cannot change directory to %s: %s"), cwd.c_str(),
+			 strerror(errno));
+	  ::umask(mask);
+	  environ = string_vector(env);
+	  this->cwd_ = cwd;
+	  this->inputs_fd_ = pipefd[1];
+	  link_server = this;
+	  *pargc = args.size();
+	  *pargv = string_vector(args);
+	  program_name = (*pargv)[0];
+	  return true;
+	}
+      ::close(pipefd[1]);
+      if (pid < 0)
+	::close(pipefd[0]);
+    }
+  for (int i = 0; i < 3; ++i)
+    ::close(fds[i]);
+  if (pid < 0)
+    {
+      if (ok)
+	fprintf(stderr, _("%s: cannot start link: %s\n"), program_name,
+		strerror(errno));
+      ::close(conn);
+      return false;
+    }
+
+  fcntl(pipefd[0], F_SETFL, O_NONBLOCK);
+  fcntl(conn, F_SETFL, O_NONBLOCK);
+  Link link;
+  link.pid = pid;
+  link.conn = conn;
+  link.inputs_fd = pipefd[0];
+  link.exited = false;
+  link.wstatus = 0;
+  this->links_.push_back(link);
+  return false;
+}
+
+// Read what LINK has reported of its input files.  The link process
+// closes the pipe when it exits.
+
+void
+Link_server::read_inputs(Link* link)
+{
+  char buf[4096];
+  while (link->inputs_fd >= 0)
+    {
+      ssize_t bytes = ::read(link->inputs_fd, buf, sizeof buf);
+      if (bytes > 0)
+	link->names.append(buf, bytes);
+      else if (bytes < 0 && errno == EINTR)
+	continue;
+      else if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+	break;
+      else
+	{
+	  ::close(link->inputs_fd);
+	  link->inputs_fd = -1;
+	}
+    }
+}
+
+// Read the signals which the client of LINK has passed on, and send
+// them to the link process.  If the client has gone away, nobody wants
+// the link any more, so kill it.
+
+void
+Link_server::read_signals(Link* link)
+{
+  unsigned char buf[16];
+  ssize_t bytes = ::read(link->conn, buf, sizeof buf);
+  if (bytes < 0
+      && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+    return;
+  if (bytes > 0)
+    {
+      for (ssize_t i = 0; i < bytes; ++i)
+	if (!link->exited && is_forwarded_signal(buf[i]))
+	  ::kill(link->pid, buf[i]);
+      return;
+    }
+  if (!link->exited)
+    ::kill(link->pid, SIGTERM);
+  ::close(link->conn);
+  link->conn = -1;
+}
+
+// Record the exit status of the link processes which have exited.
+
+void
+Link_server::reap_links()
+{
+  int wstatus;
+  pid_t pid;
+  while ((pid = ::waitpid(-1, &wstatus, WNOHANG)) > 0)
+    {
+      for (Links::iterator p = this->links_.begin();
+	   p != this->links_.end();
+	   ++p)
+	{
+	  if (p->pid == pid)
+	    {
+	      p->exited = true;
+	      p->wstatus = wstatus;
+	      break;
+	    }
+	}
+    }
+}
+
+// Send the exit status of each link which is done to its client, and
+// queue the input files it used for the cache.
+
+void
+Link_server::finish_links()
+{
+  Links::iterator p = this->links_.begin();
+  while (p != this->links_.end())
+    {
+      if (!p->exited || p->inputs_fd >= 0)
+	{
+	  ++p;
+	  continue;
+	}
+      if (p->conn >= 0)
+	{
+	  int32_t status = exit_status(p->wstatus);
+	  write_all(p->conn, &status, sizeof status);
+	  ::close(p->conn);
+	}
+      std::string names;
+      names.swap(p->names);
+      p = this->links_.erase(p);
+      this->queue_inputs(names);
+    }
+}
+
+// Record that the link process opened the input file NAME.  Writes of
+// less than PIPE_BUF bytes to a pipe are atomic, so this needs no lock;
+// a longer name just means that the file is not cached.
+
+void
+Link_server::note_input(const char* name) const
+{
+  std::string line;
+  if (name[0] != '/')
+    line = this->cwd_ + '/';
+  line += name;
+  line += '\n';
+  if (line.length() <= PIPE_BUF)
+    write_all(this->inputs_fd_, line.data(), line.length());
+}
+
+// Return the cached contents of the file ST, if they are current.
+
+const unsigned char*
+Link_server::find_input(const struct stat& st) const
+{
+  Cache::const_iterator p =
+    this->cache_.find(std::make_pair(st.st_dev, st.st_ino));
+  if (p == this->cache_.end() || !Link_server::is_current(p->second, st))
+    return NULL;
+  return p->second.contents;
+}
+
+// Queue the input files used by the last link for the cache.  They
+// are read by fill_cache, a slice at a time.
+
+void
+Link_server::queue_inputs(const std::string& names)
+{
+  ++this->link_count_;
+
+  if (this->pending_pos_ == this->pending_inputs_.length())
+    {
+      this->pending_inputs_.clear();
+      this->pending_pos_ = 0;
+    }
+  // Ignore a partial name at the end.
+  size_t end = names.rfind('\n');
+  if (end != std::string::npos)
+    this->pending_inputs_.append(names, 0, end + 1);
+}
+
+// Start reading the next queued input file which is not already in
+// the cache.  Return false if there is none.
+
+bool
+Link_server::start_fill()
+{
+  while (this->pending_pos_ < this->pending_inputs_.length())
+    {
+      size_t end = this->pending_inputs_.find('\n', this->pending_pos_);
+      std::string name(this->pending_inputs_, this->pending_pos_,
+                       end - this->pending_pos_);
+      this->pending_pos_ = end + 1;
+
+      struct stat st;
+      if (::stat(name.c_str(), &st) < 0 || !S_ISREG(st.st_mode))
+        continue;
+      std::pair<dev_t, ino_t> key(st.st_dev, st.st_ino);
+      Cache::iterator p = this->cache_.find(key);
+      if (p != this->cache_.end())
+        {
+          if (Link_server::is_current(p->second, st))
+            {
+              p->second.last_used = this->link_count_;
+              continue;
+            }
+          this->cache_size_ -= p->second.size;
+          delete[] p->second.contents;
+          this->cache_.erase(p);
+        }
+
+      if (static_cast<uint64_t>(st.st_size) > this->cache_limit_)
+        continue;
+      int fd = ::open(name.c_str(), O_RDONLY);
+      if (fd < 0)
+        continue;
+      fcntl(fd, F_SETFD, FD_CLOEXEC);
+      this->fill_.dev = st.st_dev;
+      this->fill_.ino = st.st_ino;
+      this->fill_.size = st.st_size;
+      this->fill_.mtime = stat_mtime(st);
+      this->fill_.ctime = stat_ctime(st);
+      this->fill_.contents = new unsigned char[st.st_size > 0
+                                               ? st.st_size
+                                               : 1];
+      this->fill_.last_used = this->link_count_;
+      this->fill_fd_ = fd;
+      this->fill_done_ = 0;
+      return true;
+    }
+
+  this->pending_inputs_.clear();
+  this->pending_pos_ = 0;
+  return false;
+}
+
+// Read up to cache_slice bytes of the queued input files into the
+// cache.
+
+void
+Link_server::fill_cache()
+{
+  size_t left = cache_slice;
+  while (left > 0)
+    {
+      if (this->fill_fd_ < 0 && !this->start_fill())
+        return;
+
+      size_t bytes = left;
+      if (static_cast<uint64_t>(this->fill_.size - this->fill_done_) < bytes)
+        bytes = this->fill_.size - this->fill_done_;
+      bool ok = read_all(this->fill_fd_,
+                         this->fill_.contents + this->fill_done_, bytes);
+      left -= bytes;
+      this->fill_done_ += bytes;
+      if (ok && this->fill_done_ < this->fill_.size)
+        continue;
+
+      // The file may have changed while we read it.
+      struct stat st;
+      if (ok
+          && (::fstat(this->fill_fd_, &st) < 0
+              || !Link_server::is_current(this->fill_, st)))
+        ok = false;
+      ::close(this->fill_fd_);
+      this->fill_fd_ = -1;
+      if (!ok)
+        {
+          delete[] this->fill_.contents;
+          continue;
+        }
+      this->cache_[std::make_pair(this->fill_.dev, this->fill_.ino)] =
+        this->fill_;
+      this->cache_size_ += this->fill_.size;
+      this->trim_cache();
+    }
+}
+
+// Drop the least recently used files until the cache fits.
+
+void
+Link_server::trim_cache()
+{
+  while (this->cache_size_ > this->cache_limit_)
+    {
+      Cache::iterator oldest = this->cache_.begin();
+      for (Cache::iterator p = this->cache_.begin();
+	   p != this->cache_.end();
+	   ++p)
+	if (p->second.last_used < oldest->second.last_used)
+	  oldest = p;
+      this->cache_size_ -= oldest->second.size;
+      delete[] oldest->second.contents;
+      this->cache_.erase(oldest);
+    }
+}
+
+// In the client, the connection to the link server, and the last
+// signal which we passed on to the link.
+
+static int client_conn = -1;
+static volatile sig_atomic_t client_signal;
+
+extern "C" void
+link_server_client_signal(int sig)
+{
+  int saved_errno = errno;
+  client_signal = sig;
+  unsigned char c = sig;
+  if (::write(client_conn, &c, 1) < 0)
+    {
+      // The server has gone away, and we will find out when we read
+      // the status.
+    }
+  errno = saved_errno;
+}
+
+// Run a link server if asked to.
+
+void
+maybe_run_link_server(int* pargc, char*** pargv)
+{
+  char** argv = *pargv;
+  size_t len = sizeof link_server_option - 1;
+  if (*pargc < 2 || strncmp(argv[1], link_server_option, len) != 0)
+    return;
+
+  const char* socket_name = argv[1] + len;
+  if (*socket_name == '\0')
+    server_fatal(_("%s requires a socket name"), link_server_option);
+
+  uint64_t cache_size = default_cache_size;
+  unsigned long jobs = 0;
+  for (int i = 2; i < *pargc; ++i)
+    {
+      size_t clen = sizeof cache_size_option - 1;
+      size_t jlen = sizeof jobs_option - 1;
+      char* end;
+      if (strncmp(argv[i], cache_size_option, clen) == 0)
+	{
+	  cache_size = strtoull(argv[i] + clen, &end, 10);
+	  if (end != argv[i] + clen && *end == '\0')
+	    continue;
+	}
+      else if (strncmp(argv[i], jobs_option, jlen) == 0)
+	{
+	  jobs = strtoul(argv[i] + jlen, &end, 10);
+	  if (end != argv[i] + jlen && *end == '\0' && jobs > 0)
+	    continue;
+	}
+      server_fatal(_("invalid link server argument: %s"), argv[i]);
+    }
+
+  // By default run one link per processor.
+  if (jobs == 0)
+    {
+#ifdef HAVE_SYSCONF
+      long procs = sysconf(_SC_NPROCESSORS_ONLN);
+      jobs = procs > 0 ? procs : 1;
+#else
+      jobs = 1;
+#endif
+    }
+
+  // The server lives until it is killed, and serves every link in a
+  // fresh process, so it is never destroyed.
+  Link_server* server = new Link_server(socket_name, cache_size << 20, jobs);
+  server->run(pargc, pargv);
+}
+
+// Send the link to a link server if there is one.
+
+void
+maybe_use_link_server(int argc, char** argv)
+{
+  // A link process must not pass the link back to the server.
+  if (link_server != NULL)
+    return;
+
+  const char* socket_name = getenv(link_server_variable);
+  if (socket_name == NULL || *socket_name == '\0')
+    return;
+
+  struct sockaddr_un addr;
+  if (strlen(socket_name) >= sizeof addr.sun_path)
+    return;
+  memset(&addr, 0, sizeof addr);
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, socket_name);
+
+  int conn = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (conn < 0)
+    return;
+  // Only hand our descriptors and environment to a server run by the
+  // same user.
+  uid_t uid;
+  if (::connect(conn, reinterpret_cast<struct sockaddr*>(&addr),
+		sizeof addr) < 0
+      || !peer_uid(conn, &uid)
+      || uid != ::geteuid())
+    {
+      ::close(conn);
+      return;
+    }
+
+  // The server reads the whole request before it starts the link, so
+  // if we fail to send it we can still do the link ourselves.
+  signal(SIGPIPE, SIG_IGN);
+
+  char c = 'L';
+  struct iovec iov;
+  iov.iov_base = &c;
+  iov.iov_len = 1;
+  union
+  {
+    struct cmsghdr align;
+    char buf[CMSG_SPACE(3 * sizeof(int))];
+  } control;
+  memset(&control, 0, sizeof control);
+  struct msghdr msg;
+  memset(&msg, 0, sizeof msg);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof control.buf;
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(3 * sizeof(int));
+  int fds[3] = { 0, 1, 2 };
+  memcpy(CMSG_DATA(cmsg), fds, sizeof fds);
+
+  std::string request;
+  char* cwd = getcwd(NULL, 0);
+  mode_t mask = ::umask(0);
+  ::umask(mask);
+  char number[32];
+  bool ok = cwd != NULL;
+  if (ok)
+    {
+      add_string(&request, cwd);
+      free(cwd);
+      snprintf(number, sizeof number, "%o", static_cast<unsigned int>(mask));
+      add_string(&request, number);
+      snprintf(number, sizeof number, "%d", argc);
+      add_string(&request, number);
+      for (int i = 0; i < argc; ++i)
+	add_string(&request, argv[i]);
+      size_t nenv = 0;
+      while (environ[nenv] != NULL)
+	++nenv;
+      snprintf(number, sizeof number, "%lu",
+	       static_cast<unsigned long>(nenv));
+      add_string(&request, number);
+      for (size_t i = 0; i < nenv; ++i)
+	add_string(&request, environ[i]);
+    }
+
+  if (!ok
+      || ::sendmsg(conn, &msg, 0) != 1
+      || !write_all(conn, request.data(), request.length()))
+    {
+      ::close(conn);
+      signal(SIGPIPE, SIG_DFL);
+      return;
+    }
+
+  // The link now runs in the server, so a signal which would stop us
+  // has to stop the link instead.  Leave alone the signals which we
+  // were told to ignore, as a link run here would.
+  client_conn = conn;
+  for (size_t i = 0; i < forwarded_signal_count; ++i)
+    {
+      struct sigaction sa;
+      if (sigaction(forwarded_signals[i], NULL, &sa) < 0
+	  || sa.sa_handler == SIG_IGN)
+	continue;
+      memset(&sa, 0, sizeof sa);
+      sa.sa_handler = link_server_client_signal;
+      sigemptyset(&sa.sa_mask);
+      sa.sa_flags = SA_RESTART;
+      sigaction(forwarded_signals[i], &sa, NULL);
+    }
+
+  int32_t status;
+  if (!read_all(conn, &status, sizeof status))
+    server_fatal(_("lost connection to link server %s"), socket_name);
+
+  // If the link was killed by a signal we passed on, die of it too, so
+  // that whoever ran us sees why.
+  int sig = client_signal;
+  if (sig != 0 && status == 128 + sig)
+    {
+      signal(sig, SIG_DFL);
+      raise(sig);
+    }
+  exit(status);
+}
+
+#else // defined(__MINGW32__)
+
+// There are no Unix domain sockets here.
+
+Link_server::Link_server(const char* socket_name, uint64_t cache_limit,
+			 unsigned int max_links)
+  : socket_name_(socket_name), cache_limit_(cache_limit),
+    max_links_(max_links), links_(), cache_size_(0), cache_(),
+    link_count_(0), pending_inputs_(), pending_pos_(0), fill_fd_(-1),
+    fill_(), fill_done_(0), cwd_(), inputs_fd_(-1)
+{
+}
+
+Link_server::~Link_server()
+{
+}
+
+void
+Link_server::note_input(const char*) const
+{
+}
+
+const unsigned char*
+Link_server::find_input(const struct stat&) const
+{
+  return NULL;
+}
+
+void
+maybe_run_link_server(int* pargc, char*** pargv)
+{
+  if (*pargc >= 2
+      && strncmp((*pargv)[1], link_server_option,
+		 sizeof link_server_option - 1) == 0)
+    server_fatal(_("link server not supported on this host"));
+}
+
+void
+maybe_use_link_server(int, char**)
+{
+}
+
+#endif // defined(__MINGW32__)
+
+} // End namespace gold.
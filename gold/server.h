@@ -0,0 +1,234 @@
+// server.h -- resident link server for gold  -*- C++ -*-
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#ifndef GOLD_SERVER_H
+#define GOLD_SERVER_H
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "fileread.h"
+
+namespace gold
+{
+
+// gold can run as a resident link server which listens on a Unix
+// domain socket:
+//
+//   ld.gold --link-server=SOCKET [--link-server-cache-size=MB]
+//           [--link-server-jobs=N]
+//
+// The directory containing SOCKET must belong to the user running the
+// server and must not be accessible to anybody else; it is created if
+// it does not exist.  The server only serves clients running as the
+// same user.
+// When gold is run with the environment variable GOLD_LINK_SERVER set
+// to SOCKET, it acts as a thin client: it sends its arguments, working
+// directory, umask, environment and standard descriptors to the
+// server, passes on SIGINT, SIGTERM and SIGHUP to the link, and exits
+// with the status of the link.  If the client goes away, the server
+// kills the link.  If the server can not be reached, the client does
+// the link itself.
+//
+// The server forks a new process for each link, so no state from one
+// link can leak into the next.  Up to N links run at the same time (by
+// default, one per processor), so that a parallel build does not wait
+// for its links one by one.  What the server does keep is the contents
+// of the input files used by earlier links, keyed by device and inode
+// and checked against the size and the modification and change times.
+// A link process inherits those from the server, and does not read
+// unchanged input files again.  The server reads the input files of a
+// finished link into the cache a slice at a time between polls, so
+// that it can go on starting and finishing links meanwhile.
+
+class Link_server
+{
+ public:
+  Link_server(const char* socket_name, uint64_t cache_limit,
+	      unsigned int max_links);
+
+  ~Link_server();
+
+  // Listen for links.  This only returns in a link process, with
+  // *PARGC and *PARGV set to the arguments of the link.
+  void
+  run(int* pargc, char*** pargv);
+
+  // In a link process, record that the input file NAME was opened, so
+  // that the server caches it after the link.
+  void
+  note_input(const char* name) const;
+
+  // In a link process, return the contents of the input file
+  // described by ST, or NULL if they are not cached or the file has
+  // changed.
+  const unsigned char*
+  find_input(const struct stat& st) const;
+
+ private:
+  Link_server(const Link_server&);
+  Link_server& operator=(const Link_server&);
+
+  // A cached input file.
+  struct Cached_file
+  {
+    // The identity, size and times of the file when we read it.
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    Timespec mtime;
+    Timespec ctime;
+    // The contents of the file.
+    unsigned char* contents;
+    // The number of the last link which used it.
+    uint64_t last_used;
+  };
+
+  // The cached files, keyed by device and inode.
+  typedef std::map<std::pair<dev_t, ino_t>, Cached_file> Cache;
+
+  // A link in progress.
+  struct Link
+  {
+    // The link process.
+    pid_t pid;
+    // The connection to the client, or -1 if the client has gone away.
+    int conn;
+    // The pipe on which the link process reports its input files, or
+    // -1 once the link process has closed it.
+    int inputs_fd;
+    // The input files reported so far, one per line.
+    std::string names;
+    // Whether the link process has exited, and its wait status.
+    bool exited;
+    int wstatus;
+  };
+
+  typedef std::list<Link> Links;
+
+  // Whether the cache entry C describes the file ST.
+  static bool
+  is_current(const Cached_file& c, const struct stat& st);
+
+  // Create the socket and start listening on it.  Return the socket.
+  int
+  listen();
+
+  // Start the link requested on the connection CONN.  This returns
+  // true in the link process.
+  bool
+  start_link(int sock, int conn, int* pargc, char*** pargv);
+
+  // Read the input file names reported by LINK.
+  void
+  read_inputs(Link* link);
+
+  // Pass on to LINK the signals sent by its client.
+  void
+  read_signals(Link* link);
+
+  // Record the exit of any link processes which have finished.
+  void
+  reap_links();
+
+  // Reply to the clients of the links which are done, and cache the
+  // files they used.
+  void
+  finish_links();
+
+  // Queue the input files named in NAMES, one per line, for caching.
+  void
+  queue_inputs(const std::string& names);
+
+  // Whether there are queued input files left to cache.
+  bool
+  filling_cache() const
+  {
+    return (this->fill_fd_ >= 0
+	    || this->pending_pos_ < this->pending_inputs_.length());
+  }
+
+  // Start reading the next queued input file into fill_.  Return false
+  // if there are none left.
+  bool
+  start_fill();
+
+  // Read the next slice of the queued input files into the cache.
+  void
+  fill_cache();
+
+  // Drop least recently used files until the cache fits the limit.
+  void
+  trim_cache();
+
+  // The name of the socket.
+  std::string socket_name_;
+  // The maximum number of bytes to cache.
+  uint64_t cache_limit_;
+  // The maximum number of links to run at the same time.
+  unsigned int max_links_;
+  // The links in progress.
+  Links links_;
+  // The number of bytes currently cached.
+  uint64_t cache_size_;
+  // The cached input files.
+  Cache cache_;
+  // The number of links served.
+  uint64_t link_count_;
+  // The input files waiting to be cached, one per line, and the
+  // position of the next one.
+  std::string pending_inputs_;
+  size_t pending_pos_;
+  // The input file being read into the cache, or -1.
+  int fill_fd_;
+  // The cache entry for that file, and how much of it we have read.
+  Cached_file fill_;
+  off_t fill_done_;
+  // In a link process, the working directory of the client, used to
+  // turn relative input file names into absolute ones.
+  std::string cwd_;
+  // In a link process, the pipe on which to report input files.
+  int inputs_fd_;
+};
+
+// In a link process started by a link server, the server.  Otherwise
+// NULL.
+extern const Link_server* link_server;
+
+// If the arguments ask for a link server, run one.  This only returns
+// if they do not, or in a link process, with *PARGC and *PARGV set to
+// the arguments of the link.
+extern void
+maybe_run_link_server(int* pargc, char*** pargv);
+
+// If the environment variable GOLD_LINK_SERVER names a link server,
+// send the link described by ARGC and ARGV to it, and exit with the
+// status of the link.  This only returns if there is no server.
+extern void
+maybe_use_link_server(int argc, char** argv);
+
+} // End namespace gold.
+
+#endif // !defined(GOLD_SERVER_H)
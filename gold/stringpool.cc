@@ -27,6 +27,7 @@
 #include <vector>
 
 #include "output.h"
+#include "memstats.h"
 #include "parameters.h"
 #include "stringpool.h"
 
@@ -52,7 +53,11 @@ Stringpool_template<Stringpool_char>::clear()
   for (typename std::list<Stringdata*>::iterator p = this->strings_.begin();
        p != this->strings_.end();
        ++p)
-    delete[] reinterpret_cast<char*>(*p);
+    {
+      Memory_stats::add(Memory_stats::STRINGPOOLS,
+			-static_cast<int64_t>(sizeof(Stringdata) + (*p)->alc));
+      delete[] reinterpret_cast<char*>(*p);
+    }
   this->strings_.clear();
   this->key_to_offset_.clear();
   this->string_set_.clear();
@@ -192,6 +197,7 @@ Stringpool_template<Stringpool_char>::add_string(const Stringpool_char* s,
     }
 
   Stringdata* psd = reinterpret_cast<Stringdata*>(new char[alc]);
+  Memory_stats::add(Memory_stats::STRINGPOOLS, alc);
   psd->alc = alc - sizeof(Stringdata);
   memcpy(psd->data, s, len - sizeof(Stringpool_char));
   memset(psd->data + len - sizeof(Stringpool_char), 0,
@@ -41,6 +41,7 @@
 #include "script.h"
 #include "plugin.h"
 #include "incremental.h"
+#include "memstats.h"
 
 namespace gold
 {
@@ -565,7 +566,7 @@ Symbol::set_undefined()
 
 Symbol_table::Symbol_table(unsigned int count,
                            const Version_script_info& version_script)
-  : saw_undefined_(0), offset_(0), table_(count), namepool_(),
+  : saw_undefined_(0), offset_(0), write_order_(), table_(count), namepool_(),
     forwarders_(), commons_(), tls_commons_(), small_commons_(),
     large_commons_(), forced_locals_(), warnings_(),
     version_script_(version_script), gc_(NULL), icf_(NULL),
@@ -1114,6 +1115,7 @@ Symbol_table::add_from_object(Object* object,
 		}
 	    }
 
+	  Memory_stats::add(Memory_stats::SYMBOLS, sizeof(Sized_symbol<size>));
 	  ret->init_object(name, version, object, sym, st_shndx, is_ordinary);
 
 	  ins.first->second = ret;
@@ -1930,6 +1932,7 @@ Symbol_table::define_special_symbol(const char** pname, const char** pversion,
       if (sym == NULL)
         return NULL;
     }
+  Memory_stats::add(Memory_stats::SYMBOLS, sizeof(Sized_symbol<size>));
 
   if (add_to_table)
     add_loc->second = sym;
@@ -2631,6 +2634,8 @@ Symbol_table::set_dynsym_indexes(unsigned int index,
 	}
     }
 
+  versions->add_relr_version(dynpool);
+
   // Finish up the versions.  In some cases this may add new dynamic
   // symbols.
   index = versions->finalize(this, index, syms);
@@ -2746,6 +2751,15 @@ Symbol_table::sized_finalize(off_t off, Stringpool* pool,
 	}
     }
 
+  // If we are using threads and there are enough symbols, remember
+  // the order in which we see them, so that write_globals can write
+  // them out in chunks.
+  this->write_order_.clear();
+  bool record_order = (parameters->options().threads()
+		       && this->table_.size() > write_globals_chunk_size);
+  if (record_order)
+    this->write_order_.reserve(this->table_.size());
+
   // Now do all the remaining symbols.
   for (Symbol_table_type::iterator p = this->table_.begin();
        p != this->table_.end();
@@ -2754,6 +2768,8 @@ Symbol_table::sized_finalize(off_t off, Stringpool* pool,
       Symbol* sym = p->second;
       if (this->sized_finalize_symbol<size>(sym))
 	this->add_to_final_symtab<size>(sym, pool, &index, &off);
+      if (record_order)
+	this->write_order_.push_back(sym);
     }
 
   // Now do target-specific symbols.
@@ -2990,39 +3006,40 @@ Symbol_table::sized_finalize_symbol(Symbol* unsized_sym)
   return true;
 }
 
-// Write out the global symbols.
+// Write out the global symbols in chunk CHUNK.
 
 void
 Symbol_table::write_globals(const Stringpool* sympool,
 			    const Stringpool* dynpool,
 			    Output_symtab_xindex* symtab_xindex,
 			    Output_symtab_xindex* dynsym_xindex,
-			    Output_file* of) const
+			    Output_file* of,
+			    unsigned int chunk) const
 {
   switch (parameters->size_and_endianness())
     {
 #ifdef HAVE_TARGET_32_LITTLE
     case Parameters::TARGET_32_LITTLE:
       this->sized_write_globals<32, false>(sympool, dynpool, symtab_xindex,
-					   dynsym_xindex, of);
+					   dynsym_xindex, of, chunk);
       break;
 #endif
 #ifdef HAVE_TARGET_32_BIG
     case Parameters::TARGET_32_BIG:
       this->sized_write_globals<32, true>(sympool, dynpool, symtab_xindex,
-					  dynsym_xindex, of);
+					  dynsym_xindex, of, chunk);
       break;
 #endif
 #ifdef HAVE_TARGET_64_LITTLE
     case Parameters::TARGET_64_LITTLE:
       this->sized_write_globals<64, false>(sympool, dynpool, symtab_xindex,
-					   dynsym_xindex, of);
+					   dynsym_xindex, of, chunk);
       break;
 #endif
 #ifdef HAVE_TARGET_64_BIG
     case Parameters::TARGET_64_BIG:
       this->sized_write_globals<64, true>(sympool, dynpool, symtab_xindex,
-					  dynsym_xindex, of);
+					  dynsym_xindex, of, chunk);
       break;
 #endif
     default:
@@ -3038,10 +3055,9 @@ Symbol_table::sized_write_globals(const Stringpool* sympool,
 				  const Stringpool* dynpool,
 				  Output_symtab_xindex* symtab_xindex,
 				  Output_symtab_xindex* dynsym_xindex,
-				  Output_file* of) const
+				  Output_file* of,
+				  unsigned int chunk) const
 {
-  const Target& target = parameters->target();
-
   const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
 
   const unsigned int output_count = this->output_count_;
@@ -3063,238 +3079,285 @@ Symbol_table::sized_write_globals(const Stringpool* sympool,
   else
     dynamic_view = of->get_output_view(this->dynamic_offset_, dynamic_size);
 
-  for (Symbol_table_type::const_iterator p = this->table_.begin();
-       p != this->table_.end();
-       ++p)
+  if (this->write_order_.empty())
+    {
+      gold_assert(chunk == 0);
+      for (Symbol_table_type::const_iterator p = this->table_.begin();
+	   p != this->table_.end();
+	   ++p)
+	this->sized_write_global<size, big_endian>(
+	    static_cast<Sized_symbol<size>*>(p->second), sympool, dynpool,
+	    symtab_xindex, dynsym_xindex, psyms, dynamic_view);
+    }
+  else
+    {
+      // Write out the symbols in our chunk of write_order_.  The
+      // chunks write to disjoint parts of the views.
+      size_t begin = chunk * write_globals_chunk_size;
+      size_t end = begin + write_globals_chunk_size;
+      if (end > this->write_order_.size())
+	end = this->write_order_.size();
+      gold_assert(begin < end);
+      for (size_t i = begin; i < end; ++i)
+	this->sized_write_global<size, big_endian>(
+	    static_cast<Sized_symbol<size>*>(this->write_order_[i]),
+	    sympool, dynpool, symtab_xindex, dynsym_xindex, psyms,
+	    dynamic_view);
+    }
+
+  // The target-specific symbols are written out with the first chunk.
+  if (chunk == 0)
     {
-      Sized_symbol<size>* sym = static_cast<Sized_symbol<size>*>(p->second);
+      for (std::vector<Symbol*>::const_iterator p =
+	     this->target_symbols_.begin();
+	   p != this->target_symbols_.end();
+	   ++p)
+	{
+	  Sized_symbol<size>* sym = static_cast<Sized_symbol<size>*>(*p);
 
-      // Possibly warn about unresolved symbols in shared libraries.
-      this->warn_about_undefined_dynobj_symbol(sym);
+	  unsigned int sym_index = sym->symtab_index();
+	  unsigned int dynsym_index;
+	  if (dynamic_view == NULL)
+	    dynsym_index = -1U;
+	  else
+	    dynsym_index = sym->dynsym_index();
 
-      unsigned int sym_index = sym->symtab_index();
-      unsigned int dynsym_index;
-      if (dynamic_view == NULL)
-	dynsym_index = -1U;
-      else
-	dynsym_index = sym->dynsym_index();
+	  unsigned int shndx;
+	  switch (sym->source())
+	    {
+	    case Symbol::IS_CONSTANT:
+	      shndx = elfcpp::SHN_ABS;
+	      break;
+	    case Symbol::IS_UNDEFINED:
+	      shndx = elfcpp::SHN_UNDEF;
+	      break;
+	    default:
+	      gold_unreachable();
+	    }
 
-      if (sym_index == -1U && dynsym_index == -1U)
-	{
-	  // This symbol is not included in the output file.
-	  continue;
+	  if (sym_index != -1U)
+	    {
+	      sym_index -= first_global_index;
+	      gold_assert(sym_index < output_count);
+	      unsigned char* ps = psyms + (sym_index * sym_size);
+	      this->sized_write_symbol<size, big_endian>(sym, sym->value(),
+							 shndx, sym->binding(),
+							 sympool, ps);
+	    }
+
+	  if (dynsym_index != -1U)
+	    {
+	      dynsym_index -= first_dynamic_global_index;
+	      gold_assert(dynsym_index < dynamic_count);
+	      unsigned char* pd = dynamic_view + (dynsym_index * sym_size);
+	      this->sized_write_symbol<size, big_endian>(sym, sym->value(),
+							 shndx, sym->binding(),
+							 dynpool, pd);
+	    }
 	}
+    }
 
-      unsigned int shndx;
-      typename elfcpp::Elf_types<size>::Elf_Addr sym_value = sym->value();
-      typename elfcpp::Elf_types<size>::Elf_Addr dynsym_value = sym_value;
-      elfcpp::STB binding = sym->binding();
+  of->write_output_view(this->offset_, oview_size, psyms);
+  if (dynamic_view != NULL)
+    of->write_output_view(this->dynamic_offset_, dynamic_size, dynamic_view);
+}
 
-      // If --weak-unresolved-symbols is set, change binding of unresolved
-      // global symbols to STB_WEAK.
-      if (parameters->options().weak_unresolved_symbols()
-	  && binding == elfcpp::STB_GLOBAL
-	  && sym->is_undefined())
-	binding = elfcpp::STB_WEAK;
+// Write out the global symbol SYM.  PSYMS and DYNAMIC_VIEW are the
+// views of the global symbols in the symbol table and the dynamic
+// symbol table, or NULL.
 
-      // If --no-gnu-unique is set, change STB_GNU_UNIQUE to STB_GLOBAL.
-      if (binding == elfcpp::STB_GNU_UNIQUE
-	  && !parameters->options().gnu_unique())
-	binding = elfcpp::STB_GLOBAL;
+template<int size, bool big_endian>
+void
+Symbol_table::sized_write_global(Sized_symbol<size>* sym,
+				 const Stringpool* sympool,
+				 const Stringpool* dynpool,
+				 Output_symtab_xindex* symtab_xindex,
+				 Output_symtab_xindex* dynsym_xindex,
+				 unsigned char* psyms,
+				 unsigned char* dynamic_view) const
+{
+  const Target& target = parameters->target();
 
-      switch (sym->source())
-	{
-	case Symbol::FROM_OBJECT:
-	  {
-	    bool is_ordinary;
-	    unsigned int in_shndx = sym->shndx(&is_ordinary);
+  const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
+  const unsigned int output_count = this->output_count_;
+  const unsigned int first_global_index = this->first_global_index_;
+  const unsigned int dynamic_count = this->dynamic_count_;
+  const unsigned int first_dynamic_global_index =
+    this->first_dynamic_global_index_;
 
-	    if (!is_ordinary
-		&& in_shndx != elfcpp::SHN_ABS
-		&& !Symbol::is_common_shndx(in_shndx))
+  // Possibly warn about unresolved symbols in shared libraries.
+  this->warn_about_undefined_dynobj_symbol(sym);
+
+  unsigned int sym_index = sym->symtab_index();
+  unsigned int dynsym_index;
+  if (dynamic_view == NULL)
+    dynsym_index = -1U;
+  else
+    dynsym_index = sym->dynsym_index();
+
+  if (sym_index == -1U && dynsym_index == -1U)
+    {
+      // This symbol is not included in the output file.
+      return;
+    }
+
+  unsigned int shndx;
+  typename elfcpp::Elf_types<size>::Elf_Addr sym_value = sym->value();
+  typename elfcpp::Elf_types<size>::Elf_Addr dynsym_value = sym_value;
+  elfcpp::STB binding = sym->binding();
+
+  // If --weak-unresolved-symbols is set, change binding of unresolved
+  // global symbols to STB_WEAK.
+  if (parameters->options().weak_unresolved_symbols()
+      && binding == elfcpp::STB_GLOBAL
+      && sym->is_undefined())
+    binding = elfcpp::STB_WEAK;
+
+  // If --no-gnu-unique is set, change STB_GNU_UNIQUE to STB_GLOBAL.
+  if (binding == elfcpp::STB_GNU_UNIQUE
+      && !parameters->options().gnu_unique())
+    binding = elfcpp::STB_GLOBAL;
+
+  switch (sym->source())
+    {
+    case Symbol::FROM_OBJECT:
+      {
+	bool is_ordinary;
+	unsigned int in_shndx = sym->shndx(&is_ordinary);
+
+	if (!is_ordinary
+	    && in_shndx != elfcpp::SHN_ABS
+	    && !Symbol::is_common_shndx(in_shndx))
+	  {
+	    gold_error(_("%s: unsupported symbol section 0x%x"),
+		       sym->demangled_name().c_str(), in_shndx);
+	    shndx = in_shndx;
+	  }
+	else
+	  {
+	    Object* symobj = sym->object();
+	    if (symobj->is_dynamic())
 	      {
-		gold_error(_("%s: unsupported symbol section 0x%x"),
-			   sym->demangled_name().c_str(), in_shndx);
-		shndx = in_shndx;
+		if (sym->needs_dynsym_value())
+		  dynsym_value = target.dynsym_value(sym);
+		shndx = elfcpp::SHN_UNDEF;
+		if (sym->is_undef_binding_weak())
+		  binding = elfcpp::STB_WEAK;
+		else
+		  binding = elfcpp::STB_GLOBAL;
 	      }
+	    else if (symobj->pluginobj() != NULL)
+	      shndx = elfcpp::SHN_UNDEF;
+	    else if (in_shndx == elfcpp::SHN_UNDEF
+		     || (!is_ordinary
+			 && (in_shndx == elfcpp::SHN_ABS
+			     || Symbol::is_common_shndx(in_shndx))))
+	      shndx = in_shndx;
 	    else
 	      {
-		Object* symobj = sym->object();
-		if (symobj->is_dynamic())
+		Relobj* relobj = static_cast<Relobj*>(symobj);
+		Output_section* os = relobj->output_section(in_shndx);
+		if (this->is_section_folded(relobj, in_shndx))
 		  {
-		    if (sym->needs_dynsym_value())
-		      dynsym_value = target.dynsym_value(sym);
-		    shndx = elfcpp::SHN_UNDEF;
-		    if (sym->is_undef_binding_weak())
-		      binding = elfcpp::STB_WEAK;
-		    else
-		      binding = elfcpp::STB_GLOBAL;
+		    // This global symbol must be written out even though
+		    // it is folded.
+		    // Get the os of the section it is folded onto.
+		    Section_id folded =
+			 this->icf_->get_folded_section(relobj, in_shndx);
+		    gold_assert(folded.first !=NULL);
+		    Relobj* folded_obj = 
+		      reinterpret_cast<Relobj*>(folded.first);
+		    os = folded_obj->output_section(folded.second);  
+		    gold_assert(os != NULL);
 		  }
-		else if (symobj->pluginobj() != NULL)
-		  shndx = elfcpp::SHN_UNDEF;
-		else if (in_shndx == elfcpp::SHN_UNDEF
-			 || (!is_ordinary
-			     && (in_shndx == elfcpp::SHN_ABS
-				 || Symbol::is_common_shndx(in_shndx))))
-		  shndx = in_shndx;
-		else
+		gold_assert(os != NULL);
+		shndx = os->out_shndx();
+
+		if (shndx >= elfcpp::SHN_LORESERVE)
 		  {
-		    Relobj* relobj = static_cast<Relobj*>(symobj);
-		    Output_section* os = relobj->output_section(in_shndx);
-                    if (this->is_section_folded(relobj, in_shndx))
-                      {
-                        // This global symbol must be written out even though
-                        // it is folded.
-                        // Get the os of the section it is folded onto.
-                        Section_id folded =
-                             this->icf_->get_folded_section(relobj, in_shndx);
-                        gold_assert(folded.first !=NULL);
-                        Relobj* folded_obj = 
-                          reinterpret_cast<Relobj*>(folded.first);
-                        os = folded_obj->output_section(folded.second);  
-                        gold_assert(os != NULL);
-                      }
-		    gold_assert(os != NULL);
-		    shndx = os->out_shndx();
-
-		    if (shndx >= elfcpp::SHN_LORESERVE)
-		      {
-			if (sym_index != -1U)
-			  symtab_xindex->add(sym_index, shndx);
-			if (dynsym_index != -1U)
-			  dynsym_xindex->add(dynsym_index, shndx);
-			shndx = elfcpp::SHN_XINDEX;
-		      }
-
-		    // In object files symbol values are section
-		    // relative.
-		    if (parameters->options().relocatable())
-		      sym_value -= os->address();
+		    if (sym_index != -1U)
+		      symtab_xindex->add(sym_index, shndx);
+		    if (dynsym_index != -1U)
+		      dynsym_xindex->add(dynsym_index, shndx);
+		    shndx = elfcpp::SHN_XINDEX;
 		  }
+
+		// In object files symbol values are section
+		// relative.
+		if (parameters->options().relocatable())
+		  sym_value -= os->address();
 	      }
 	  }
-	  break;
-
-	case Symbol::IN_OUTPUT_DATA:
-	  {
-	    Output_data* od = sym->output_data();
+      }
+      break;
 
-	    shndx = od->out_shndx();
-	    if (shndx >= elfcpp::SHN_LORESERVE)
-	      {
-		if (sym_index != -1U)
-		  symtab_xindex->add(sym_index, shndx);
-		if (dynsym_index != -1U)
-		  dynsym_xindex->add(dynsym_index, shndx);
-		shndx = elfcpp::SHN_XINDEX;
-	      }
+    case Symbol::IN_OUTPUT_DATA:
+      {
+	Output_data* od = sym->output_data();
 
-	    // In object files symbol values are section
-	    // relative.
-	    if (parameters->options().relocatable())
-	      {
-		Output_section* os = od->output_section();
-		gold_assert(os != NULL);
-		sym_value -= os->address();
-	      }
+	shndx = od->out_shndx();
+	if (shndx >= elfcpp::SHN_LORESERVE)
+	  {
+	    if (sym_index != -1U)
+	      symtab_xindex->add(sym_index, shndx);
+	    if (dynsym_index != -1U)
+	      dynsym_xindex->add(dynsym_index, shndx);
+	    shndx = elfcpp::SHN_XINDEX;
 	  }
-	  break;
 
-	case Symbol::IN_OUTPUT_SEGMENT:
+	// In object files symbol values are section
+	// relative.
+	if (parameters->options().relocatable())
 	  {
-	    Output_segment* oseg = sym->output_segment();
-	    Output_section* osect = oseg->first_section();
-	    if (osect == NULL)
-	      shndx = elfcpp::SHN_ABS;
-	    else
-	      shndx = osect->out_shndx();
+	    Output_section* os = od->output_section();
+	    gold_assert(os != NULL);
+	    sym_value -= os->address();
 	  }
-	  break;
+      }
+      break;
 
-	case Symbol::IS_CONSTANT:
+    case Symbol::IN_OUTPUT_SEGMENT:
+      {
+	Output_segment* oseg = sym->output_segment();
+	Output_section* osect = oseg->first_section();
+	if (osect == NULL)
 	  shndx = elfcpp::SHN_ABS;
-	  break;
-
-	case Symbol::IS_UNDEFINED:
-	  shndx = elfcpp::SHN_UNDEF;
-	  break;
+	else
+	  shndx = osect->out_shndx();
+      }
+      break;
 
-	default:
-	  gold_unreachable();
-	}
+    case Symbol::IS_CONSTANT:
+      shndx = elfcpp::SHN_ABS;
+      break;
 
-      if (sym_index != -1U)
-	{
-	  sym_index -= first_global_index;
-	  gold_assert(sym_index < output_count);
-	  unsigned char* ps = psyms + (sym_index * sym_size);
-	  this->sized_write_symbol<size, big_endian>(sym, sym_value, shndx,
-						     binding, sympool, ps);
-	}
+    case Symbol::IS_UNDEFINED:
+      shndx = elfcpp::SHN_UNDEF;
+      break;
 
-      if (dynsym_index != -1U)
-	{
-	  dynsym_index -= first_dynamic_global_index;
-	  gold_assert(dynsym_index < dynamic_count);
-	  unsigned char* pd = dynamic_view + (dynsym_index * sym_size);
-	  this->sized_write_symbol<size, big_endian>(sym, dynsym_value, shndx,
-						     binding, dynpool, pd);
-          // Allow a target to adjust dynamic symbol value.
-          parameters->target().adjust_dyn_symbol(sym, pd);
-	}
+    default:
+      gold_unreachable();
     }
 
-  // Write the target-specific symbols.
-  for (std::vector<Symbol*>::const_iterator p = this->target_symbols_.begin();
-       p != this->target_symbols_.end();
-       ++p)
+  if (sym_index != -1U)
     {
-      Sized_symbol<size>* sym = static_cast<Sized_symbol<size>*>(*p);
-
-      unsigned int sym_index = sym->symtab_index();
-      unsigned int dynsym_index;
-      if (dynamic_view == NULL)
-	dynsym_index = -1U;
-      else
-	dynsym_index = sym->dynsym_index();
-
-      unsigned int shndx;
-      switch (sym->source())
-	{
-	case Symbol::IS_CONSTANT:
-	  shndx = elfcpp::SHN_ABS;
-	  break;
-	case Symbol::IS_UNDEFINED:
-	  shndx = elfcpp::SHN_UNDEF;
-	  break;
-	default:
-	  gold_unreachable();
-	}
-
-      if (sym_index != -1U)
-	{
-	  sym_index -= first_global_index;
-	  gold_assert(sym_index < output_count);
-	  unsigned char* ps = psyms + (sym_index * sym_size);
-	  this->sized_write_symbol<size, big_endian>(sym, sym->value(), shndx,
-						     sym->binding(), sympool,
-						     ps);
-	}
-
-      if (dynsym_index != -1U)
-	{
-	  dynsym_index -= first_dynamic_global_index;
-	  gold_assert(dynsym_index < dynamic_count);
-	  unsigned char* pd = dynamic_view + (dynsym_index * sym_size);
-	  this->sized_write_symbol<size, big_endian>(sym, sym->value(), shndx,
-						     sym->binding(), dynpool,
-						     pd);
-	}
+      sym_index -= first_global_index;
+      gold_assert(sym_index < output_count);
+      unsigned char* ps = psyms + (sym_index * sym_size);
+      this->sized_write_symbol<size, big_endian>(sym, sym_value, shndx,
+						 binding, sympool, ps);
     }
 
-  of->write_output_view(this->offset_, oview_size, psyms);
-  if (dynamic_view != NULL)
-    of->write_output_view(this->dynamic_offset_, dynamic_size, dynamic_view);
+  if (dynsym_index != -1U)
+    {
+      dynsym_index -= first_dynamic_global_index;
+      gold_assert(dynsym_index < dynamic_count);
+      unsigned char* pd = dynamic_view + (dynsym_index * sym_size);
+      this->sized_write_symbol<size, big_endian>(sym, dynsym_value, shndx,
+						 binding, dynpool, pd);
+      // Allow a target to adjust dynamic symbol value.
+      parameters->target().adjust_dyn_symbol(sym, pd);
+    }
 }
 
 // Write out the symbol SYM, in section SHNDX, to P.  POOL is the
@@ -3515,6 +3578,133 @@ Symbol_table::linenos_from_loc(const Task* task,
   return result;
 }
 
+// Group the candidate ODR violation locations by object, and create
+// an entry in odr_lines_ for each of them.  The entries are created
+// here, before any Read_odr_lines_task runs, so that the tasks only
+// modify the values and never the map itself.
+
+void
+Symbol_table::group_odr_locations()
+{
+  gold_assert(this->odr_locations_by_object_.empty());
+  Unordered_map<Object*, unsigned int> object_index;
+  for (Odr_map::const_iterator it = this->candidate_odr_violations_.begin();
+       it != this->candidate_odr_violations_.end();
+       ++it)
+    {
+      // There is nothing to compare for a symbol defined only once.
+      if (it->second.size() < 2)
+	continue;
+      for (Unordered_set<Symbol_location, Symbol_location_hash>::const_iterator
+	     locs = it->second.begin();
+	   locs != it->second.end();
+	   ++locs)
+	{
+	  // Leave objects claimed by a plugin to linenos_from_loc.
+	  if (locs->object->pluginobj() != NULL)
+	    continue;
+	  if (!this->odr_lines_.insert(std::make_pair(*locs,
+						std::vector<std::string>())).second)
+	    continue;
+	  std::pair<Unordered_map<Object*, unsigned int>::iterator, bool> ins =
+	    object_index.insert(std::make_pair(locs->object,
+					      this->odr_locations_by_object_.size()));
+	  if (ins.second)
+	    this->odr_locations_by_object_.push_back(
+		std::vector<Symbol_location>());
+	  this->odr_locations_by_object_[ins.first->second].push_back(*locs);
+	}
+    }
+}
+
+// Return the object whose locations are handled by
+// Read_odr_lines_task number I.
+
+Object*
+Symbol_table::odr_object(unsigned int i) const
+{
+  gold_assert(i < this->odr_locations_by_object_.size()
+	      && !this->odr_locations_by_object_[i].empty());
+  return this->odr_locations_by_object_[i].front().object;
+}
+
+// Look up the lines of all the candidate ODR violation locations in
+// object number I.  Unlike linenos_from_loc, this reads the line
+// table for all sections at once, rather than once per section.  The
+// caller must have locked the object.
+
+void
+Symbol_table::read_odr_lines(unsigned int i)
+{
+  const std::vector<Symbol_location>& locs(this->odr_locations_by_object_[i]);
+  Dwarf_line_info* lineinfo =
+    Dwarf_line_info::create(locs.front().object, -1U);
+  for (std::vector<Symbol_location>::const_iterator p = locs.begin();
+       p != locs.end();
+       ++p)
+    {
+      Symbol_location code_loc = *p;
+      parameters->target().function_location(&code_loc);
+      gold_assert(code_loc.object == p->object);
+
+      std::vector<std::string> result;
+      std::string canonical_result =
+	lineinfo->addr2line(code_loc.shndx, code_loc.offset, &result);
+      if (!canonical_result.empty())
+	result.push_back(canonical_result);
+
+      Odr_lines::iterator q = this->odr_lines_.find(*p);
+      gold_assert(q != this->odr_lines_.end());
+      q->second.swap(result);
+    }
+  delete lineinfo;
+}
+
+// Return the lines attached to LOC, using those found by
+// read_odr_lines if there are any.
+
+std::vector<std::string>
+Symbol_table::odr_lines(const Task* task, const Symbol_location& loc) const
+{
+  Odr_lines::const_iterator p = this->odr_lines_.find(loc);
+  if (p != this->odr_lines_.end())
+    return p->second;
+  return Symbol_table::linenos_from_loc(task, loc);
+}
+
+// Class Read_odr_lines_task.
+
+// Return whether the task can run.  We need the object lock to read
+// the debugging sections.
+
+Task_token*
+Read_odr_lines_task::is_runnable()
+{
+  if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
+    return this->this_blocker_;
+  if (this->object_->is_locked())
+    return this->object_->token();
+  return NULL;
+}
+
+// Lock the object and release the blocker when done.
+
+void
+Read_odr_lines_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->next_blocker_);
+  tl->add(this, this->object_->token());
+}
+
+// Read the lines.
+
+void
+Read_odr_lines_task::run(Workqueue*)
+{
+  this->symtab_->read_odr_lines(this->i_);
+  this->object_->release();
+}
+
 // OutputIterator that records if it was ever assigned to.  This
 // allows it to be used with std::set_intersection() to check for
 // intersection rather than computing the intersection.
@@ -3574,7 +3764,7 @@ Symbol_table::detect_odr_violations(const Task* task,
           // false negatives that appear or disappear depending on the
           // link order, but it won't cause false positives.
           first_object_name = locs->object->name();
-          first_object_linenos = this->linenos_from_loc(task, *locs);
+          first_object_linenos = this->odr_lines(task, *locs);
         }
       if (first_object_linenos.empty())
 	continue;
@@ -3586,8 +3776,7 @@ Symbol_table::detect_odr_violations(const Task* task,
 
       for (; locs != locs_end; ++locs)
         {
-          std::vector<std::string> linenos =
-              this->linenos_from_loc(task, *locs);
+          std::vector<std::string> linenos = this->odr_lines(task, *locs);
           // linenos will be empty if we couldn't parse the debug info.
           if (linenos.empty())
             continue;
@@ -34,6 +34,7 @@
 #include "parameters.h"
 #include "stringpool.h"
 #include "object.h"
+#include "workqueue.h"
 
 namespace gold
 {
@@ -1604,6 +1605,27 @@ class Symbol_table
 		size_t relnum, off_t reloffset) const
   { this->warnings_.issue_warning(sym, relinfo, relnum, reloffset); }
 
+  // Group the locations in candidate_odr_violations_ by object, so
+  // that the line information for each object can be read by a
+  // separate Read_odr_lines_task.  This may only be called once.
+  void
+  group_odr_locations();
+
+  // Return the number of objects found by group_odr_locations.
+  unsigned int
+  odr_object_count() const
+  { return this->odr_locations_by_object_.size(); }
+
+  // Return object number I, as counted by odr_object_count.
+  Object*
+  odr_object(unsigned int i) const;
+
+  // Look up the source lines of the candidate ODR violation locations
+  // in object number I, decoding the object's line table only once.
+  // Different objects may be handled in parallel.
+  void
+  read_odr_lines(unsigned int i);
+
   // Check candidate_odr_violations_ to find symbols with the same name
   // but apparently different definitions (different source-file/line-no).
   void
@@ -1677,11 +1699,24 @@ class Symbol_table
   output_count() const
   { return this->output_count_; }
 
-  // Write out the global symbols.
+  // Return the number of chunks into which the global symbols were
+  // split by finalize.  Each chunk may be written out by a separate
+  // call to write_globals, possibly in parallel.
+  unsigned int
+  write_globals_chunk_count() const
+  {
+    if (this->write_order_.empty())
+      return 1;
+    return ((this->write_order_.size() + write_globals_chunk_size - 1)
+	    / write_globals_chunk_size);
+  }
+
+  // Write out the global symbols in chunk CHUNK.  The target specific
+  // symbols are written out along with chunk 0.
   void
   write_globals(const Stringpool*, const Stringpool*,
 		Output_symtab_xindex*, Output_symtab_xindex*,
-		Output_file*) const;
+		Output_file*, unsigned int chunk) const;
 
   // Write out a section symbol.  Return the updated offset.
   void
@@ -1754,6 +1789,11 @@ class Symbol_table
                         Unordered_set<Symbol_location, Symbol_location_hash> >
   Odr_map;
 
+  // The source lines of each candidate ODR violation location.
+  typedef Unordered_map<Symbol_location, std::vector<std::string>,
+			Symbol_location_hash>
+  Odr_lines;
+
   // Make FROM a forwarder symbol to TO.
   void
   make_forwarder(Symbol* from, Symbol* to);
@@ -1910,6 +1950,11 @@ class Symbol_table
   static std::vector<std::string>
   linenos_from_loc(const Task* task, const Symbol_location& loc);
 
+  // Return the lines for LOC found by read_odr_lines, or look them up
+  // with linenos_from_loc if they were not read.
+  std::vector<std::string>
+  odr_lines(const Task* task, const Symbol_location& loc) const;
+
   // Implement detect_odr_violations.
   template<int size, bool big_endian>
   void
@@ -1936,7 +1981,16 @@ class Symbol_table
   void
   sized_write_globals(const Stringpool*, const Stringpool*,
 		      Output_symtab_xindex*, Output_symtab_xindex*,
-		      Output_file*) const;
+		      Output_file*, unsigned int chunk) const;
+
+  // Write out a single global symbol to the views PSYMS and
+  // DYNAMIC_VIEW.
+  template<int size, bool big_endian>
+  void
+  sized_write_global(Sized_symbol<size>*, const Stringpool*,
+		     const Stringpool*, Output_symtab_xindex*,
+		     Output_symtab_xindex*, unsigned char* psyms,
+		     unsigned char* dynamic_view) const;
 
   // Write out a symbol to P.
   template<int size, bool big_endian>
@@ -1981,6 +2035,12 @@ class Symbol_table
   // The number of global dynamic symbols (including forced-local symbols),
   // or 0 if none.
   unsigned int dynamic_count_;
+  // When using threads, the symbols in the hash table in the order in
+  // which finalize visited them, so that write_globals can split them
+  // into chunks.  Empty if the symbols are written by a single task.
+  std::vector<Symbol*> write_order_;
+  // The number of symbols in each chunk of write_order_.
+  static const size_t write_globals_chunk_size = 32 * 1024;
   // The symbol hash table.
   Symbol_table_type table_;
   // A pool of symbol names.  This is used for all global symbols.
@@ -2012,6 +2072,10 @@ class Symbol_table
   Warnings warnings_;
   // Manage potential One Definition Rule (ODR) violations.
   Odr_map candidate_odr_violations_;
+  // The locations in candidate_odr_violations_ grouped by object.
+  std::vector<std::vector<Symbol_location> > odr_locations_by_object_;
+  // The source lines of those locations, set by read_odr_lines.
+  Odr_lines odr_lines_;
 
   // When we emit a COPY reloc for a symbol, we define it in an
   // Output_data.  When it's time to emit version information for it,
@@ -2045,6 +2109,42 @@ Symbol_table::get_sized_symbol(const Symbol* sym) const
   return static_cast<const Sized_symbol<size>*>(sym);
 }
 
+// This task reads the source lines of the candidate ODR violation
+// locations in one object, for --detect-odr-violations.
+
+class Read_odr_lines_task : public Task
+{
+ public:
+  Read_odr_lines_task(Symbol_table* symtab, Object* object, unsigned int i,
+		      Task_token* this_blocker, Task_token* next_blocker)
+    : symtab_(symtab), object_(object), i_(i), this_blocker_(this_blocker),
+      next_blocker_(next_blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Read_odr_lines_task " + this->object_->name(); }
+
+ private:
+  Symbol_table* symtab_;
+  Object* object_;
+  // The index of the object; see Symbol_table::odr_object_count.
+  unsigned int i_;
+  Task_token* this_blocker_;
+  Task_token* next_blocker_;
+};
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_SYMTAB_H)
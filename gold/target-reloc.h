@@ -28,6 +28,7 @@
 #include "object.h"
 #include "reloc.h"
 #include "reloc-types.h"
+#include "merge.h"
 
 namespace gold
 {
@@ -717,6 +718,13 @@ scan_relocatable_relocs(
   const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
   Scan_relocatable_reloc scan;
 
+  // If the section is mapped through a merge map, as .eh_frame is,
+  // walk the map along with the relocs.
+  Merge_map_cursor merge_cursor(needs_special_offset_handling
+				? object->merge_map()
+				: NULL,
+				data_shndx);
+
   for (size_t i = 0; i < reloc_count; ++i, prelocs += reloc_size)
     {
       Reltype reloc(prelocs);
@@ -724,8 +732,10 @@ scan_relocatable_relocs(
       Relocatable_relocs::Reloc_strategy strategy;
 
       if (needs_special_offset_handling
-	  && !output_section->is_input_address_mapped(object, data_shndx,
-						      reloc.get_r_offset()))
+	  && !(merge_cursor.is_valid()
+	       ? merge_cursor.is_input_address_mapped(reloc.get_r_offset())
+	       : output_section->is_input_address_mapped(object, data_shndx,
+							 reloc.get_r_offset())))
 	strategy = Relocatable_relocs::RELOC_DISCARD;
       else
 	{
@@ -801,6 +811,14 @@ relocate_relocs(
 
   const bool relocatable = parameters->options().relocatable();
 
+  // If the section is mapped through a merge map, look up the new
+  // offsets in a single pass over the map rather than asking the
+  // output section for each reloc.
+  Merge_map_cursor merge_cursor(offset_in_output_section == invalid_address
+				? object->merge_map()
+				: NULL,
+				relinfo->data_shndx);
+
   for (size_t i = 0; i < reloc_count; ++i, prelocs += reloc_size)
     {
       Relocatable_relocs::Reloc_strategy strategy = relinfo->rr->strategy(i);
@@ -893,9 +911,17 @@ relocate_relocs(
 	{
           section_offset_type sot_offset =
               convert_types<section_offset_type, Address>(offset);
-	  section_offset_type new_sot_offset =
-              output_section->output_offset(object, relinfo->data_shndx,
-                                            sot_offset);
+	  section_offset_type new_sot_offset;
+	  if (merge_cursor.is_valid())
+	    {
+	      bool found = merge_cursor.output_offset(sot_offset,
+						      &new_sot_offset);
+	      gold_assert(found);
+	    }
+	  else
+	    new_sot_offset =
+	      output_section->output_offset(object, relinfo->data_shndx,
+					    sot_offset);
 	  gold_assert(new_sot_offset != -1);
           new_offset = new_sot_offset;
 	}
@@ -0,0 +1,60 @@
+// call_graph_ordering.cc -- a test case for gold
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// The goal of this program is to verify that --call-graph-ordering
+// places functions next to their callers, and that
+// --call-graph-profile orders them by the given call counts.
+
+int cold_1()
+{
+  return 1;
+}
+
+int leaf()
+{
+  return 2;
+}
+
+int cold_2()
+{
+  return 3;
+}
+
+int middle()
+{
+  return leaf() + 1;
+}
+
+// This is called, but it is in a .text.unlikely section, so it should
+// still come ahead of everything else.
+
+__attribute__ ((section (".text.unlikely.rare")))
+int rare()
+{
+  return 4;
+}
+
+int main(int argc, char**)
+{
+  if (argc > 100)
+    return rare();
+  return middle() == 3 ? 0 : 1;
+}
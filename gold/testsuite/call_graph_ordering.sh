@@ -0,0 +1,76 @@
+#!/bin/sh
+
+# call_graph_ordering.sh -- test --call-graph-ordering
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The goal of this program is to verify that --call-graph-ordering
+# and --call-graph-profile lay out the functions in
+# call_graph_ordering.cc as intended.
+
+set -e
+
+check()
+{
+    awk "
+BEGIN { saw1 = 0; saw2 = 0; err = 0; }
+/.*$2\$/ { saw1 = 1; }
+/.*$3\$/ {
+     saw2 = 1;
+     if (!saw1)
+       {
+	  printf \"layout of $2 and $3 is not right\\n\";
+	  err = 1;
+	  exit 1;
+       }
+    }
+END {
+      if (!saw1 && !err)
+        {
+	  printf \"did not see $2\\n\";
+	  exit 1;
+	}
+      if (!saw2 && !err)
+	{
+	  printf \"did not see $3\\n\";
+	  exit 1;
+	}
+    }" $1
+}
+
+# Without a profile, main calls middle which calls leaf, so they
+# should be placed together ahead of the functions nobody calls.
+# main also calls rare, but rare is in .text.unlikely and so comes
+# first.
+check call_graph_ordering.stdout "_Z4rarev" " main"
+check call_graph_ordering.stdout " main" "_Z6middlev"
+check call_graph_ordering.stdout "_Z6middlev" "_Z4leafv"
+check call_graph_ordering.stdout "_Z4leafv" "_Z6cold_1v"
+check call_graph_ordering.stdout "_Z4leafv" "_Z6cold_2v"
+
+# With the profile, the hottest call goes first, and cold_2 is placed
+# ahead of cold_1 because it calls it.  middle is not in the profile
+# and so keeps its input position after the profiled functions.
+# rare still comes first.
+check call_graph_profile.stdout "_Z4rarev" " main"
+check call_graph_profile.stdout " main" "_Z4leafv"
+check call_graph_profile.stdout "_Z4leafv" "_Z6cold_2v"
+check call_graph_profile.stdout "_Z6cold_2v" "_Z6cold_1v"
+check call_graph_profile.stdout "_Z6cold_1v" "_Z6middlev"
@@ -0,0 +1,38 @@
+/* dynsym_hash_test_1.c -- a shared library with many dynamic symbols.
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* Define 4096 functions, dynsym_hash_000 to dynsym_hash_fff, each of
+   which returns its own number.  That is enough for many hash chains
+   with several symbols, and for a Bloom filter of many words.  */
+
+#define F1(n) \
+  int dynsym_hash_##n (void); \
+  int dynsym_hash_##n (void) { return 0x##n; }
+#define F16(n) \
+  F1(n##0) F1(n##1) F1(n##2) F1(n##3) F1(n##4) F1(n##5) F1(n##6) F1(n##7) \
+  F1(n##8) F1(n##9) F1(n##a) F1(n##b) F1(n##c) F1(n##d) F1(n##e) F1(n##f)
+#define F256(n) \
+  F16(n##0) F16(n##1) F16(n##2) F16(n##3) F16(n##4) F16(n##5) F16(n##6) \
+  F16(n##7) F16(n##8) F16(n##9) F16(n##a) F16(n##b) F16(n##c) F16(n##d) \
+  F16(n##e) F16(n##f)
+
+F256(0) F256(1) F256(2) F256(3) F256(4) F256(5) F256(6) F256(7)
+F256(8) F256(9) F256(a) F256(b) F256(c) F256(d) F256(e) F256(f)
@@ -0,0 +1,90 @@
+/* dynsym_hash_test_main.c -- look up symbols in hash tables built by gold.
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* dynsym_hash_test_1.c is linked into shared libraries with each
+   --hash-style.  Open each library, and check that the dynamic
+   linker finds every symbol through the hash table, and does not
+   find names which are not defined.  */
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char* const libs[] =
+{
+  "./dynsym_hash_test_gnu.so",
+  "./dynsym_hash_test_sysv.so",
+  "./dynsym_hash_test_both.so"
+};
+
+typedef int (*fn_p) (void);
+
+int
+main (void)
+{
+  int failures = 0;
+  unsigned int l;
+
+  for (l = 0; l < sizeof libs / sizeof libs[0]; ++l)
+    {
+      void* h;
+      int i;
+      char name[40];
+
+      h = dlopen (libs[l], RTLD_NOW);
+      if (h == NULL)
+	{
+	  fprintf (stderr, "dlopen %s: %s\n", libs[l], dlerror ());
+	  return 1;
+	}
+
+      for (i = 0; i < 0x1000; ++i)
+	{
+	  fn_p f;
+
+	  sprintf (name, "dynsym_hash_%03x", i);
+	  f = (fn_p) dlsym (h, name);
+	  if (f == NULL)
+	    {
+	      fprintf (stderr, "%s: %s not found\n", libs[l], name);
+	      ++failures;
+	    }
+	  else if (f () != i)
+	    {
+	      fprintf (stderr, "%s: %s returned %d\n", libs[l], name, f ());
+	      ++failures;
+	    }
+
+	  sprintf (name, "dynsym_hash_%04x", i + 0x1000);
+	  if (dlsym (h, name) != NULL)
+	    {
+	      fprintf (stderr, "%s: %s unexpectedly found\n", libs[l], name);
+	      ++failures;
+	    }
+	}
+
+      dlclose (h);
+    }
+
+  if (failures != 0)
+    return 1;
+  return 0;
+}
@@ -0,0 +1,100 @@
+// hugepage_text.cc -- test --hugepage-text for gold
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// The goal of this program is to verify that --hugepage-text puts the
+// .text.hot sections in a range of whole huge pages, marked by
+// __hot_start and __hot_end, and that other text is outside it.
+
+#include <cstdio>
+#include <stdint.h>
+
+extern "C"
+{
+extern char __ehdr_start[];
+extern char __hot_start[];
+extern char __hot_end[];
+
+__attribute__((section(".text.hot.foo"), noinline))
+int
+hot_foo()
+{
+  return 1;
+}
+
+__attribute__((section(".text.unlikely.foo"), noinline))
+int
+unlikely_foo()
+{
+  return 2;
+}
+
+__attribute__((noinline))
+int
+regular_foo()
+{
+  return 3;
+}
+}
+
+static const uintptr_t hugepage_size = 0x200000;
+
+static bool
+in_hot_range(const void* p)
+{
+  const char* c = reinterpret_cast<const char*>(p);
+  return c >= __hot_start && c < __hot_end;
+}
+
+int
+main()
+{
+  int ret = 0;
+
+  // Check the offsets from the ELF header, which is at the start of
+  // the first PT_LOAD segment, so that this works for a PIE too.
+  uintptr_t start = __hot_start - __ehdr_start;
+  uintptr_t end = __hot_end - __ehdr_start;
+  if (start % hugepage_size != 0 || end % hugepage_size != 0)
+    {
+      fprintf(stderr, "hot range %#lx-%#lx not aligned to huge pages\n",
+	      static_cast<unsigned long>(start),
+	      static_cast<unsigned long>(end));
+      ret = 1;
+    }
+
+  if (!in_hot_range(reinterpret_cast<void*>(hot_foo)))
+    {
+      fprintf(stderr, "hot_foo is not in the hot range\n");
+      ret = 1;
+    }
+  if (in_hot_range(reinterpret_cast<void*>(regular_foo))
+      || in_hot_range(reinterpret_cast<void*>(unlikely_foo))
+      || in_hot_range(reinterpret_cast<void*>(main)))
+    {
+      fprintf(stderr, "cold text is in the hot range\n");
+      ret = 1;
+    }
+
+  if (hot_foo() + unlikely_foo() + regular_foo() != 6)
+    ret = 1;
+
+  return ret;
+}
@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# hugepage_text.sh -- test --hugepage-text.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# hugepage_text is linked with --hugepage-text.  Check that .text.hot
+# and the text segment are aligned to 2M huge pages, then run the
+# program, which checks the range given by __hot_start and __hot_end.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check hugepage_text.stdout " \.text\.hot .* 2097152$"
+check hugepage_text.stdout "LOAD .*R E 0x200000$"
+
+./hugepage_text || exit 1
+
+exit 0
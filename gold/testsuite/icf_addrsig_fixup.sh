@@ -0,0 +1,57 @@
+#!/bin/sh
+
+# icf_addrsig_fixup.sh -- fill in an address-significance table.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# Usage: icf_addrsig_fixup.sh READELF OBJECT SYMBOL...
+
+# The assembler can neither set the sh_link field of the .llvm_addrsig
+# section nor compute symbol indexes, so patch them into a 64-bit
+# little-endian OBJECT here.  The section must have one byte for each
+# SYMBOL, and every symbol index must be less than 128.
+
+set -e
+
+readelf=$1
+obj=$2
+shift 2
+
+# Write the byte VALUE at file offset OFFSET of OBJ.
+put_byte()
+{
+    printf "\\$(printf '%03o' $2)" \
+	| dd of=$obj bs=1 seek=$1 count=1 conv=notrunc 2>/dev/null
+}
+
+shoff=`$readelf -hW $obj | sed -n 's/.*Start of section headers: *\([0-9]*\).*/\1/p'`
+symtab=`$readelf -SW $obj | sed -n 's/^ *\[ *\([0-9]*\)\] \.symtab .*/\1/p'`
+addrsig=`$readelf -SW $obj | sed -n 's/^ *\[ *\([0-9]*\)\] \.llvm_addrsig .*/\1/p'`
+secoff=`$readelf -SW $obj | sed -n 's/^ *\[ *[0-9]*\] \.llvm_addrsig *[^ ]* *[0-9a-f]* \([0-9a-f]*\) .*/\1/p'`
+
+# sh_link is at offset 40 in an Elf64_Shdr.
+put_byte `expr $shoff + $addrsig \* 64 + 40` $symtab
+
+off=`printf '%d' 0x$secoff`
+for sym in "$@"; do
+    index=`$readelf -sW $obj | awk "\\$8 == \"$sym\" { sub(\":\", \"\", \\$1); print \\$1 }"`
+    put_byte $off $index
+    off=`expr $off + 1`
+done
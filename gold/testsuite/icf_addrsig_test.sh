@@ -0,0 +1,63 @@
+#!/bin/sh
+
+# icf_addrsig_test.sh -- test --icf=safe with address-significance tables.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# icf_addrsig_test_1.o has an address-significance table which lists
+# only keep_a, although it takes the address of every function.
+# Check that --icf=safe folds fold_a and fold_b, but not keep_a and
+# keep_b, and not mixed_a and mixed_b, since icf_addrsig_test_2.o has
+# no table and takes the address of mixed_a.  Without a valid sh_link,
+# the table must be ignored and fold_a and fold_b must be kept apart.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_not()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check icf_addrsig_test.stdout "folding section '.text.fold_[ab]'"
+check_not icf_addrsig_test.stdout "folding section '.text.keep_"
+check_not icf_addrsig_test.stdout "folding section '.text.mixed_"
+
+check_not icf_addrsig_test_nolink.stdout "folding section '.text.fold_"
+
+exit 0
@@ -0,0 +1,64 @@
+# icf_addrsig_test_1.s -- an object with an address-significance table.
+# The address of every function is taken in .data, but only keep_a
+# is listed in the table.  icf_addrsig_fixup.sh fills in the table.
+
+	.globl	fold_a
+	.globl	fold_b
+	.globl	keep_a
+	.globl	keep_b
+	.globl	mixed_a
+	.globl	mixed_b
+
+	.section	.text.fold_a,"ax",@progbits
+	.type	fold_a, @function
+fold_a:
+	movl	$1, %eax
+	ret
+	.size	fold_a, .-fold_a
+
+	.section	.text.fold_b,"ax",@progbits
+	.type	fold_b, @function
+fold_b:
+	movl	$1, %eax
+	ret
+	.size	fold_b, .-fold_b
+
+	.section	.text.keep_a,"ax",@progbits
+	.type	keep_a, @function
+keep_a:
+	movl	$2, %eax
+	ret
+	.size	keep_a, .-keep_a
+
+	.section	.text.keep_b,"ax",@progbits
+	.type	keep_b, @function
+keep_b:
+	movl	$2, %eax
+	ret
+	.size	keep_b, .-keep_b
+
+	.section	.text.mixed_a,"ax",@progbits
+	.type	mixed_a, @function
+mixed_a:
+	movl	$3, %eax
+	ret
+	.size	mixed_a, .-mixed_a
+
+	.section	.text.mixed_b,"ax",@progbits
+	.type	mixed_b, @function
+mixed_b:
+	movl	$3, %eax
+	ret
+	.size	mixed_b, .-mixed_b
+
+	.data
+	.quad	fold_a
+	.quad	fold_b
+	.quad	keep_a
+	.quad	keep_b
+	.quad	mixed_a
+	.quad	mixed_b
+
+	# SHT_LLVM_ADDRSIG, with room for one symbol index.
+	.section	.llvm_addrsig,"e",@0x6fff4c03
+	.byte	0
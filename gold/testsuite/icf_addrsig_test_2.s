@@ -0,0 +1,5 @@
+# icf_addrsig_test_2.s -- an object without an address-significance
+# table, which takes the address of mixed_a.
+
+	.data
+	.quad	mixed_a
@@ -0,0 +1,73 @@
+#!/bin/sh
+
+# incremental_gdb_index_test.sh -- test --gdb-index with an
+# incremental update.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# incremental_gdb_index_test is linked with --incremental-full and
+# then updated with one file changed.  The entries for the other
+# files are copied from the index of the first link.  The result
+# should index the same units and symbols as a full link of the
+# same files, although the units may be in a different order.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+INCR=incremental_gdb_index_test.stdout
+FULL=incremental_gdb_index_test_full.stdout
+
+check $INCR "^Version 7"
+
+# Symbols from the changed file and from unchanged files.
+check $INCR "^\[ *[0-9]*\] t1:"
+check $INCR "^\[ *[0-9]*\] t16a:"
+check $INCR "^\[ *[0-9]*\] main:"
+
+# Print the sorted names of the symbols, and the number of units and
+# address ranges, of a readelf dump.
+summary()
+{
+    sed -n -e 's/^\[ *[0-9]*\] \([^:]*\):.*/\1/p' "$1" | sort
+    sed -n -e '/^CU table:/,/^TU table:/p' "$1" | grep -c '^\['
+    sed -n -e '/^Address table:/,/^Symbol table:/p' "$1" | grep -c '^[0-9a-f]'
+}
+
+summary $INCR > incremental_gdb_index_test.incr
+summary $FULL > incremental_gdb_index_test.full
+
+if ! cmp -s incremental_gdb_index_test.incr incremental_gdb_index_test.full
+then
+    echo "Incremental and full links have different .gdb_index contents:"
+    diff incremental_gdb_index_test.incr incremental_gdb_index_test.full
+    exit 1
+fi
+
+exit 0
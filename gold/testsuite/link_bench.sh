@@ -0,0 +1,143 @@
+#!/bin/sh
+
+# link_bench.sh -- run synthetic link benchmarks for gold.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# Usage: link_bench.sh [-B DIR] [-d WORKDIR] [-o RESULTS] [-r RUNS] SCALE...
+#
+# For each SCALE, generate a synthetic program with link_bench_gen.sh
+# (once; the inputs are kept in WORKDIR/SCALE), then link it RUNS times
+# with each of the option sets below, using the linker named ld in DIR.
+# SCALE is small, medium, large, or OBJECTSxSYMBOLS.
+#
+# Each link is run with --stats, and the results are appended to
+# RESULTS as tab separated lines with the columns named in the header
+# line: the times are in seconds, the maximum resident set size is in
+# kilobytes, and the output size in bytes.  Compare two result files
+# with, for instance, "sort | join".
+#
+# The compiler is $CXX $CXXFLAGS, and the archiver $AR.
+
+set -e
+
+srcdir=`dirname "$0"`
+bdir=gcctestdir
+work=link_bench.dir
+results=link_bench.tsv
+runs=3
+
+while getopts B:d:o:r: opt; do
+  case $opt in
+    B) bdir=$OPTARG ;;
+    d) work=$OPTARG ;;
+    o) results=$OPTARG ;;
+    r) runs=$OPTARG ;;
+    *) echo "usage: $0 [-B DIR] [-d WORKDIR] [-o RESULTS] [-r RUNS] SCALE..." 1>&2
+       exit 1 ;;
+  esac
+done
+shift `expr $OPTIND - 1`
+if test $# -eq 0; then
+  set small medium
+fi
+
+CXX=${CXX:-g++}
+export CXX CXXFLAGS AR
+
+# Make the paths absolute, since the generator runs in WORKDIR.
+mkdir -p "$work"
+work=`cd "$work" && pwd`
+bdir=`cd "$bdir" && pwd`
+srcdir=`cd "$srcdir" && pwd`
+case $AR in
+  /*) ;;
+  */*) AR=`cd \`dirname "$AR"\` && pwd`/`basename "$AR"` ;;
+esac
+
+# The option sets, as NAME:OPTIONS, with the options separated by
+# commas for -Wl.  An option set with -r makes a relocatable link of
+# the objects alone, without the libraries.
+configs="default:
+threads4:--threads,--thread-count=4
+gc:--gc-sections
+icf:--icf=all
+gdb_index:--gdb-index
+all4:--threads,--thread-count=4,--gc-sections,--icf=all,--gdb-index
+relocatable:-r
+relocatable4:-r,--threads,--thread-count=4"
+
+if ! test -s "$results"; then
+  printf 'scale\tobjects\tsymbols\tconfig\trun\tuser\tsys\twall\tmaxrss_kb\toutput_bytes\n' > "$results"
+fi
+
+for scale in "$@"; do
+  case $scale in
+    small) objects=50; symbols=40 ;;
+    medium) objects=200; symbols=100 ;;
+    large) objects=1000; symbols=200 ;;
+    *x*) objects=`echo $scale | sed 's/x.*//'`
+	 symbols=`echo $scale | sed 's/.*x//'` ;;
+    *) echo "$0: unknown scale $scale" 1>&2; exit 1 ;;
+  esac
+
+  dir="$work/$scale"
+  if ! test -f "$dir/stamp"; then
+    LDFLAGS="-B$bdir/" ${SHELL-sh} "$srcdir/link_bench_gen.sh" "$dir" \
+      $objects $symbols
+    touch "$dir/stamp"
+  fi
+
+  echo "$configs" | while IFS=: read config options; do
+    wl=-Wl,--stats
+    if test -n "$options"; then
+      wl="$wl,$options"
+    fi
+    case ",$options," in
+      *,-r,*) link="-r -nostdlib $wl -o bench.o main.o `cat $dir/link_objects`" ;;
+      *) link="$wl -o bench main.o `cat $dir/link_objects` libbench_a.a
+	       libbench_so.so -Wl,-rpath,$dir" ;;
+    esac
+    run=1
+    while test $run -le $runs; do
+      (cd "$dir" && $CXX -B"$bdir/" $link > stats 2>&1) || {
+	echo "$0: link failed for $scale $config:" 1>&2
+	cat "$dir/stats" 1>&2
+	exit 1
+      }
+      awk -v scale=$scale -v objects=$objects -v symbols=$symbols \
+	  -v config=$config -v run=$run '
+	/total run time:/ {
+	  for (i = 1; i <= NF; ++i) {
+	    if ($i == "(user:") user = $(i + 1);
+	    if ($i == "sys:") sys = $(i + 1);
+	    if ($i == "wall:") { wall = $(i + 1); sub(/\)$/, "", wall); }
+	  }
+	}
+	/maximum resident set size:/ { rss = $(NF - 1) }
+	/output file size:/ { size = $(NF - 1) }
+	END {
+	  printf "%s\t%d\t%d\t%s\t%d\t%s\t%s\t%s\t%s\t%s\n", scale, objects,
+	    symbols, config, run, user, sys, wall, rss, size;
+	}' "$dir/stats" >> "$results"
+      run=`expr $run + 1`
+    done
+  done
+done
@@ -0,0 +1,131 @@
+#!/bin/sh
+
+# link_bench_gen.sh -- generate synthetic inputs for link_bench.sh.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# Usage: link_bench_gen.sh DIR OBJECTS SYMBOLS
+#
+# Generate a synthetic program of OBJECTS C++ files, each defining
+# SYMBOLS functions and SYMBOLS/4 variables, and compile it in DIR with
+# $CXX $CXXFLAGS.  The objects are compiled with -g and
+# -ffunction-sections, so the links see DWARF, .eh_frame, SHF_MERGE
+# strings and one section per function.
+#
+# The first half of the objects are linked directly, the third quarter
+# goes into the archive libbench_a.a and the last quarter into the
+# shared library libbench_so.so, which is linked with the linker found
+# by $LDFLAGS.  Function 0 of each object calls function 0 of the next
+# one, so the whole chain is live.  Odd numbered functions are never
+# called, for --gc-sections, and functions numbered 2 mod 4 have the
+# same body in every object, for --icf.  Every function uses a string
+# which is the same in all objects and can be merged.
+#
+# The result is DIR/main.o, DIR/obj*.o, DIR/libbench_a.a and
+# DIR/libbench_so.so, and DIR/link_objects, which lists the objects to
+# link directly.
+
+set -e
+
+if test $# -ne 3; then
+  echo "usage: $0 DIR OBJECTS SYMBOLS" 1>&2
+  exit 1
+fi
+
+dir=$1
+objects=$2
+symbols=$3
+CXX=${CXX:-g++}
+AR=${AR:-ar}
+JOBS=${JOBS:-4}
+
+mkdir -p "$dir"
+cd "$dir"
+rm -f *.cc *.o *.a *.so link_objects
+
+direct=`expr $objects / 2`
+archived=`expr $objects \* 3 / 4`
+
+i=0
+while test $i -lt $objects; do
+  awk -v i=$i -v n=$objects -v m=$symbols 'BEGIN {
+    printf "#include <stdexcept>\n\n";
+    if (i + 1 < n)
+      printf "int bench_%d_0(int);\n", i + 1;
+    for (j = 0; j < m / 4; ++j)
+      printf "int bench_data_%d_%d = %d;\n", i, j, j;
+    printf "\n";
+    for (j = m - 1; j >= 0; --j) {
+      printf "int\nbench_%d_%d(int x)\n{\n", i, j;
+      printf "  static const char* msg = \"bench message %d\";\n", j % 64;
+      if (j % 4 == 2)
+	printf "  return x * 3 + msg[0];\n";
+      else {
+	printf "  if (x < 0)\n    throw std::runtime_error(msg);\n";
+	printf "  return x + bench_data_%d_%d", i, (j / 4);
+	if (j == 0) {
+	  for (k = 2; k < m; k += 2)
+	    printf " + bench_%d_%d(x - 1)", i, k;
+	  if (i + 1 < n)
+	    printf " + bench_%d_0(x - 1)", i + 1;
+	}
+	printf ";\n";
+      }
+      printf "}\n\n";
+    }
+  }' > obj$i.cc
+  i=`expr $i + 1`
+done
+
+cat > main.cc <<EOF
+int bench_0_0(int);
+
+int
+main(int argc, char**)
+{
+  return bench_0_0(argc) == 0;
+}
+EOF
+
+# Compile everything, JOBS files at a time.  The objects for the
+# shared library must be position independent.
+ls obj*.cc main.cc | sed 's/\.cc$//' | xargs -n 1 -P "$JOBS" sh -c '
+  n=`echo $0 | sed "s/^obj//"`
+  pic=
+  if test "$0" != main && test "$n" -ge '$archived'; then pic=-fPIC; fi
+  '"$CXX $CXXFLAGS"' -g -O1 -ffunction-sections -fdata-sections $pic \
+    -c -o $0.o $0.cc'
+
+i=0
+a=
+so=
+while test $i -lt $objects; do
+  if test $i -lt $direct; then
+    echo obj$i.o >> link_objects
+  elif test $i -lt $archived; then
+    a="$a obj$i.o"
+  else
+    so="$so obj$i.o"
+  fi
+  i=`expr $i + 1`
+done
+
+$AR rc libbench_a.a $a
+$CXX $LDFLAGS -shared -o libbench_so.so $so
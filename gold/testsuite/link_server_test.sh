@@ -0,0 +1,48 @@
+#!/bin/sh
+
+# link_server_test.sh -- test the gold link server.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# link_server_test is linked once directly and twice through a link
+# server.  The Makefile checks that all three outputs are the same, and
+# that the links through the server used the client's umask of 077.
+# The second link through the server was run with --debug=files, and
+# must have used the input files cached by the first.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check link_server_test.stdout "Using cached contents of .*link_server_test\.o"
+
+./link_server_test_3 > link_server_test.out || exit 1
+check link_server_test.out "^linked$"
+
+exit 0
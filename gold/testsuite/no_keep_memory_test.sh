@@ -0,0 +1,32 @@
+#!/bin/sh
+
+# no_keep_memory_test.sh -- test --no-keep-memory.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+
+# no_keep_memory_test_2 is linked with --no-keep-memory, which releases
+# the input file views as soon as they are used.  The Makefile checks
+# that the output is the same as without the option; here we check
+# that the program still runs.
+
+./no_keep_memory_test_2 || exit 1
+
+exit 0
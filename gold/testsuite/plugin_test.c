@@ -27,6 +27,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef ENABLE_THREADS
+#include <pthread.h>
+#endif
 #include "plugin-api.h"
 
 struct claimed_file
@@ -52,10 +55,17 @@ struct sym_info
 static struct claimed_file* first_claimed_file = NULL;
 static struct claimed_file* last_claimed_file = NULL;
 
+#ifdef ENABLE_THREADS
+/* Once we have agreed to LAPI_V1, the linker may call claim_file_hook
+   from several threads at once.  */
+static pthread_mutex_t claimed_file_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 static ld_plugin_register_claim_file register_claim_file_hook = NULL;
 static ld_plugin_register_all_symbols_read register_all_symbols_read_hook = NULL;
 static ld_plugin_register_cleanup register_cleanup_hook = NULL;
 static ld_plugin_add_symbols add_symbols = NULL;
+static ld_plugin_add_symbols add_symbols_v2 = NULL;
 static ld_plugin_get_symbols get_symbols = NULL;
 static ld_plugin_get_symbols get_symbols_v2 = NULL;
 static ld_plugin_get_symbols get_symbols_v3 = NULL;
@@ -70,6 +80,8 @@ static ld_plugin_get_input_section_contents get_input_section_contents = NULL;
 static ld_plugin_update_section_order update_section_order = NULL;
 static ld_plugin_allow_section_ordering allow_section_ordering = NULL;
 static ld_plugin_get_wrap_symbols get_wrap_symbols = NULL;
+static ld_plugin_get_api_version get_api_version = NULL;
+static int linker_api_version = LAPI_V0;
 
 #define MAXOPTS 10
 
@@ -91,6 +103,11 @@ onload(struct ld_plugin_tv *tv)
   int api_version = 0;
   int gold_version = 0;
   int i;
+#ifdef ENABLE_THREADS
+  int thread_safe = 0;
+  const char *linker_identifier;
+  const char *linker_version;
+#endif
 
   for (entry = tv; entry->tv_tag != LDPT_NULL; ++entry)
     {
@@ -121,6 +138,9 @@ onload(struct ld_plugin_tv *tv)
         case LDPT_ADD_SYMBOLS:
           add_symbols = entry->tv_u.tv_add_symbols;
           break;
+        case LDPT_ADD_SYMBOLS_V2:
+          add_symbols_v2 = entry->tv_u.tv_add_symbols;
+          break;
         case LDPT_GET_SYMBOLS:
           get_symbols = entry->tv_u.tv_get_symbols;
           break;
@@ -163,6 +183,9 @@ onload(struct ld_plugin_tv *tv)
 	case LDPT_GET_WRAP_SYMBOLS:
 	  get_wrap_symbols = *entry->tv_u.tv_get_wrap_symbols;
 	  break;
+	case LDPT_GET_API_VERSION:
+	  get_api_version = *entry->tv_u.tv_get_api_version;
+	  break;
         default:
           break;
         }
@@ -198,6 +221,27 @@ onload(struct ld_plugin_tv *tv)
   for (i = 0; i < nopts; ++i)
     (*message)(LDPL_INFO, "option: %s", opts[i]);
 
+#ifdef ENABLE_THREADS
+  for (i = 0; i < nopts; ++i)
+    if (strcmp(opts[i], "thread_safe") == 0)
+      thread_safe = 1;
+  if (thread_safe && get_api_version != NULL)
+    {
+      linker_api_version = (*get_api_version)("plugin_test", "1",
+                                              LAPI_V0, LAPI_V1,
+                                              &linker_identifier,
+                                              &linker_version);
+      if (linker_api_version != LAPI_V0 && linker_api_version != LAPI_V1)
+        {
+          (*message)(LDPL_ERROR, "bad API version %d", linker_api_version);
+          return LDPS_ERR;
+        }
+      (*message)(LDPL_INFO, "linker: %s %s", linker_identifier,
+                 linker_version);
+      (*message)(LDPL_INFO, "linker API version: %d", linker_api_version);
+    }
+#endif
+
   if ((*register_claim_file_hook)(claim_file_hook) != LDPS_OK)
     {
       (*message)(LDPL_ERROR, "error registering claim file hook");
@@ -407,6 +451,14 @@ claim_file_hook (const struct ld_plugin_input_file* file, int* claimed)
           strncpy(syms[nsyms].version, info.ver, len + 1);
         }
       syms[nsyms].def = def;
+      if (strncmp(info.type, "FUNC", 4) == 0)
+        syms[nsyms].symbol_type = LDST_FUNCTION;
+      else if (strncmp(info.type, "OBJECT", 6) == 0)
+        syms[nsyms].symbol_type = LDST_VARIABLE;
+      else
+        syms[nsyms].symbol_type = LDST_UNKNOWN;
+      syms[nsyms].section_kind = LDSSK_DEFAULT;
+      syms[nsyms].unused = 0;
       syms[nsyms].visibility = vis;
       syms[nsyms].size = info.size;
       syms[nsyms].comdat_key = is_comdat ? syms[nsyms].name : NULL;
@@ -423,17 +475,28 @@ claim_file_hook (const struct ld_plugin_input_file* file, int* claimed)
   claimed_file->nsyms = nsyms;
   claimed_file->syms = syms;
   claimed_file->next = NULL;
+#ifdef ENABLE_THREADS
+  pthread_mutex_lock(&claimed_file_lock);
+#endif
   if (last_claimed_file == NULL)
     first_claimed_file = claimed_file;
   else
     last_claimed_file->next = claimed_file;
   last_claimed_file = claimed_file;
+#ifdef ENABLE_THREADS
+  pthread_mutex_unlock(&claimed_file_lock);
+#endif
 
   (*message)(LDPL_INFO, "%s: claiming file, adding %d symbols",
              file->name, nsyms);
 
   if (nsyms > 0)
-    (*add_symbols)(file->handle, nsyms, syms);
+    {
+      if (linker_api_version >= LAPI_V1 && add_symbols_v2 != NULL)
+        (*add_symbols_v2)(file->handle, nsyms, syms);
+      else
+        (*add_symbols)(file->handle, nsyms, syms);
+    }
 
   *claimed = 1;
   if (irfile_was_opened)
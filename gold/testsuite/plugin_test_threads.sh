@@ -0,0 +1,75 @@
+#!/bin/sh
+
+# plugin_test_threads.sh -- test the thread-safe claim-file hook.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with plugin_test.c, a simple plug-in library.  The
+# plugin negotiates API version LAPI_V1 with gold, promising that its
+# claim-file handler is thread safe, so that gold may call it from
+# several threads at once.  The files may be claimed in any order,
+# but every file must be offered to the plugin exactly once, and
+# symbol resolution must be the same as for plugin_test_1.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_count()
+{
+    if test "`grep -c "$2" "$1"`" != "$3"
+    then
+	echo "Expected $3 lines matching in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check plugin_test_threads.err "option: thread_safe"
+check plugin_test_threads.err "linker: GNU gold"
+check plugin_test_threads.err "linker API version: 1"
+check_count plugin_test_threads.err "two_file_test_main.o: claim file hook called" 1
+check_count plugin_test_threads.err "two_file_test_1.o.syms: claim file hook called" 1
+check_count plugin_test_threads.err "two_file_test_1b.o.syms: claim file hook called" 1
+check_count plugin_test_threads.err "two_file_test_2.o.syms: claim file hook called" 1
+check_count plugin_test_threads.err "empty.o.syms: claim file hook called" 1
+check plugin_test_threads.err "two_file_test_1.o.syms: _Z4f13iv: PREVAILING_DEF_IRONLY"
+check plugin_test_threads.err "two_file_test_1.o.syms: _Z2t2v: PREVAILING_DEF_REG"
+check plugin_test_threads.err "two_file_test_1.o.syms: v2: RESOLVED_IR"
+check plugin_test_threads.err "two_file_test_1.o.syms: t17data: RESOLVED_IR"
+check plugin_test_threads.err "two_file_test_2.o.syms: _Z4f13iv: PREEMPTED_IR"
+check plugin_test_threads.err "two_file_test_1.o: adding new input file"
+check plugin_test_threads.err "two_file_test_1b.o: adding new input file"
+check plugin_test_threads.err "two_file_test_2.o: adding new input file"
+check plugin_test_threads.err "cleanup hook called"
+
+exit 0
@@ -0,0 +1,8 @@
+.global abs_0x123456
+abs_0x123456=0x123456
+
+.global abs_0x2000
+abs_0x2000=0x2000
+
+.global abs_0x12345678
+abs_0x12345678=0x12345678
@@ -0,0 +1,13 @@
+	.text
+
+test_R_RAISIN64_56:
+	ji	abs_0x123456
+	jali	abs_0x123456+0x10
+
+test_R_RAISIN64_PCREL32:
+	beq	$r1, $r2, abs_0x2000
+	beqal	$r1, $r2, abs_0x2000+0x100
+
+test_R_RAISIN64_DATA32:
+	addi	$r1, $zero, abs_0x12345678
+	ori	$r2, $zero, abs_0x12345678+0x10
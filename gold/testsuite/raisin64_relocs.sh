@@ -0,0 +1,70 @@
+#!/bin/sh
+
+# raisin64_relocs.sh -- test Raisin64 relocations.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+check()
+{
+    file=$1
+    lbl=$2
+    line=$3
+    pattern=$4
+
+    found=`grep "<$lbl>:" $file`
+    if test -z "$found"; then
+        echo "Label $lbl not found."
+        exit 1
+    fi
+
+    match_pattern=`grep "<$lbl>:" -A$line $file | tail -n 1 | grep -e "$pattern"`
+    if test -z "$match_pattern"; then
+        echo "Expected pattern was not found in line $line after label $lbl:"
+        echo "    $pattern"
+        echo ""
+        echo "Extract:"
+        grep "<$lbl>:" -A$line $file
+        echo ""
+        echo "Actual output below:"
+        cat "$file"
+        exit 1
+    fi
+}
+
+# The text section starts at 0x1000, and each instruction is eight
+# bytes long.  Jump targets are printed as addresses, and branch
+# targets as decimal offsets from the end of the branch.
+
+check "raisin64_relocs.stdout" "test_R_RAISIN64_56" 1 "\<ji[[:space:]]\+0x123456\b"
+check "raisin64_relocs.stdout" "test_R_RAISIN64_56" 3 "\<R_RAISIN64_56[[:space:]]\+abs_0x123456\b"
+check "raisin64_relocs.stdout" "test_R_RAISIN64_56" 4 "\<jali[[:space:]]\+0x123466\b"
+check "raisin64_relocs.stdout" "test_R_RAISIN64_56" 6 "\<R_RAISIN64_56[[:space:]]\+abs_0x123456+0x10\b"
+
+check "raisin64_relocs.stdout" "test_R_RAISIN64_PCREL32" 1 "\<beq[[:space:]]\+\$r1, \$r2, 4072\b"
+check "raisin64_relocs.stdout" "test_R_RAISIN64_PCREL32" 3 "\<R_RAISIN64_PCREL32[[:space:]]\+abs_0x2000\b"
+check "raisin64_relocs.stdout" "test_R_RAISIN64_PCREL32" 4 "\<beqal[[:space:]]\+\$r1, \$r2, 4320\b"
+check "raisin64_relocs.stdout" "test_R_RAISIN64_PCREL32" 6 "\<R_RAISIN64_PCREL32[[:space:]]\+abs_0x2000+0x100\b"
+
+check "raisin64_relocs.stdout" "test_R_RAISIN64_DATA32" 1 "\<addi[[:space:]]\+\$r1, \$zero, 305419896\b"
+check "raisin64_relocs.stdout" "test_R_RAISIN64_DATA32" 3 "\<R_RAISIN64_DATA32[[:space:]]\+abs_0x12345678\b"
+check "raisin64_relocs.stdout" "test_R_RAISIN64_DATA32" 4 "\<ori[[:space:]]\+\$r2, \$zero, 0x12345688\b"
+check "raisin64_relocs.stdout" "test_R_RAISIN64_DATA32" 6 "\<R_RAISIN64_DATA32[[:space:]]\+abs_0x12345678+0x10\b"
+
+exit 0
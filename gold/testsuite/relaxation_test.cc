@@ -0,0 +1,66 @@
+// relaxation_test.cc -- test reuse of a saved layout in relaxation
+
+// Copyright (C) 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// This is linked with --debug=relaxation, which forces a second
+// relaxation pass.  The second pass restores the layout saved after
+// the first one, and the linker checks that every input section ends
+// up where the first pass put it.  The sections here exercise the
+// different kinds of output section: sorted .init_array entries, TLS
+// data, merged strings, and per-function and per-object sections
+// that may be sorted or garbage collected.
+
+#include <cstdio>
+
+int order[3];
+int count;
+
+__attribute__ ((constructor (101))) static void
+first()
+{ order[count++] = 1; }
+
+__attribute__ ((constructor (103))) static void
+third()
+{ order[count++] = 3; }
+
+__attribute__ ((constructor (102))) static void
+second()
+{ order[count++] = 2; }
+
+__thread int tls_value = 5;
+
+const char* strings[] = { "alpha", "beta", "gamma" };
+
+int
+unused_function()
+{ return 7; }
+
+int
+used_function(int x)
+{ return x + tls_value; }
+
+int
+main()
+{
+  if (order[0] != 1 || order[1] != 2 || order[2] != 3)
+    return 1;
+  std::printf("%s %d\n", strings[1], used_function(1));
+  return 0;
+}
@@ -0,0 +1,44 @@
+#!/bin/sh
+
+# relaxation_test.sh -- test reuse of a saved layout in relaxation.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The relaxation_test programs are linked with --debug=relaxation,
+# which makes the linker fail if a section or input section moves
+# when the saved layout is restored for the second pass.  Check that
+# each of them was linked and runs correctly.
+
+check_count()
+{
+    count=`grep -c "$2" "$1"`
+    if test "$count" != "$3"
+    then
+	echo "Expected $3 matches for $2 in $1, found $count"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_count relaxation_test.stdout "^beta 6$" 3
+
+exit 0
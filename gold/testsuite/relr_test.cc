@@ -0,0 +1,87 @@
+// relr_test.cc -- test --pack-dyn-relocs=relr for gold
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// This is linked as a PIE with --pack-dyn-relocs=relr.  The pointers
+// below need RELATIVE relocations.  The dense array is encoded with
+// bitmaps, the sparse array needs several address entries, and the
+// pointer in the packed structure is misaligned, so it must stay in
+// .rela.dyn.
+
+#include <cstdlib>
+
+int values[200];
+
+int* dense[70] =
+{
+  &values[0], &values[1], &values[2], &values[3], &values[4], &values[5],
+  &values[6], &values[7], &values[8], &values[9], &values[10], &values[11],
+  &values[12], &values[13], &values[14], &values[15], &values[16],
+  &values[17], &values[18], &values[19], &values[20], &values[21],
+  &values[22], &values[23], &values[24], &values[25], &values[26],
+  &values[27], &values[28], &values[29], &values[30], &values[31],
+  &values[32], &values[33], &values[34], &values[35], &values[36],
+  &values[37], &values[38], &values[39], &values[40], &values[41],
+  &values[42], &values[43], &values[44], &values[45], &values[46],
+  &values[47], &values[48], &values[49], &values[50], &values[51],
+  &values[52], &values[53], &values[54], &values[55], &values[56],
+  &values[57], &values[58], &values[59], &values[60], &values[61],
+  &values[62], &values[63], &values[64], &values[65], &values[66],
+  &values[67], &values[68], &values[69]
+};
+
+int* sparse[200] =
+{
+  &values[0], &values[1], 0, 0, 0, &values[5], 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  &values[62], &values[63], &values[64], 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  &values[126], &values[127], 0, 0, &values[130], 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, &values[199]
+};
+
+struct __attribute__((packed)) Packed
+{
+  char c;
+  int* p;
+};
+
+Packed packed = { 'a', &values[3] };
+
+int
+main()
+{
+  for (int i = 0; i < 70; ++i)
+    if (dense[i] != &values[i])
+      abort();
+  for (int i = 0; i < 200; ++i)
+    if (sparse[i] != 0 && sparse[i] != &values[i])
+      abort();
+  if (sparse[0] == 0 || sparse[130] == 0 || sparse[199] == 0
+      || sparse[2] != 0)
+    abort();
+  if (packed.p != &values[3])
+    abort();
+  return 0;
+}
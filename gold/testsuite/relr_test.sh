@@ -0,0 +1,91 @@
+#!/bin/sh
+
+# relr_test.sh -- test --pack-dyn-relocs=relr.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# relr_test is linked with --pack-dyn-relocs=relr.  Check that the
+# packed relocations are in a read-only section, that the dynamic
+# section points at them, that the aligned pointers no longer need
+# R_X86_64_RELATIVE relocations, and that the misaligned one still
+# does.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_not()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_count()
+{
+    count=`grep -c "$2" "$1"`
+    if test "$count" != "$3"
+    then
+	echo "Expected $3 matches for $2 in $1, found $count"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check relr_test.stdout " \.relr\.dyn .* A "
+check_not relr_test.stdout " \.relr\.dyn .* WA "
+
+# Older versions of readelf don't know the names of the tags, so look
+# for DT_RELR, DT_RELRSZ and DT_RELRENT by number.
+check relr_test.stdout "^ *0x0*24 "
+check relr_test.stdout "^ *0x0*23 "
+check relr_test.stdout "^ *0x0*25 "
+check relr_test.stdout "GLIBC_ABI_DT_RELR"
+check_count relr_test.stdout "R_X86_64_RELATIVE" 1
+
+# Run the program, unless the C library is too old to support DT_RELR.
+if ! ./relr_test 2> relr_test.err
+then
+    if ! grep -q "GLIBC_ABI_DT_RELR" relr_test.err
+    then
+	echo "relr_test failed"
+	cat relr_test.err
+	exit 1
+    fi
+fi
+
+exit 0
@@ -0,0 +1,91 @@
+#!/bin/sh
+
+# script_test_16.sh -- test matching of input section descriptions.
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# Each input section in script_test_16a.s and script_test_16b.s holds
+# a distinct byte, so the contents of an output section show which
+# input sections went into it, and in what order.
+
+file="script_test_16.stdout"
+
+check()
+{
+    section=$1
+    pattern=$2
+    found=`fgrep "Contents of section $section:" -A1 $file | tail -n 1`
+    if test -z "$found"; then
+        echo "Section \"$section\" not found in file $file"
+        echo ""
+        echo "Actual output below:"
+        cat "$file"
+        exit 1
+    fi
+    match_pattern=`echo "$found" | grep -e "$pattern"`
+    if test -z "$match_pattern"; then
+        echo "Expected pattern was not found in section \"$section\":"
+        echo "    $pattern"
+        echo ""
+        echo "Actual output below:"
+        cat "$file"
+        exit 1
+    fi
+}
+
+check_empty()
+{
+    section=$1
+    if fgrep -q "Contents of section $section:" $file; then
+        echo "Section \"$section\" should be empty in file $file"
+        echo ""
+        echo "Actual output below:"
+        cat "$file"
+        exit 1
+    fi
+}
+
+check ".out1" "\<11\b"
+check ".out2" "\<12\b"
+check_empty ".out3"
+
+check ".out4" "\<1314\b"
+check_empty ".out5"
+
+check ".out6" "\<15\b"
+check ".out7" "\<25\b"
+
+check ".out8" "\<26\b"
+check ".out9" "\<16\b"
+
+# .s.a, .s.b, .s.c.
+check ".out10" "\<271817\b"
+
+# gold sorts by increasing alignment: .t.small, then .t.big, padded
+# to its alignment, then .t2.a and .t2.b.
+check ".out11" "\<19000000 41424344 1b28\b"
+
+check ".out12" "\<1c\b"
+check_empty ".out13"
+
+check ".out14" "\<1a\b"
+check_empty ".out15"
+
+exit 0
@@ -0,0 +1,60 @@
+/* script_test_16.t -- test matching of input section descriptions.
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* Every input section goes to the first input section description
+   which matches it, in script order, whatever kind of pattern that
+   description uses.  The sections which should stay empty are checked
+   by script_test_16.sh.  */
+
+SECTIONS
+{
+    /* An exact name, then an overlapping prefix, then a longer prefix
+       which everything has already been taken from.  */
+    .out1 : { *(.foo.exact) }
+    .out2 : { *(.foo.*) }
+    .out3 : { *(.foo.bar*) }
+
+    /* A glob which is not a simple prefix comes before prefixes and
+       exact names which also match.  */
+    .out4 : { *(.g?x.*) }
+    .out5 : { *(.gax.*) *(.gbx.1) }
+
+    /* EXCLUDE_FILE leaves the section for a later description.  */
+    .out6 : { *(EXCLUDE_FILE(*script_test_16b.o) .ex) }
+    .out7 : { *(.ex) }
+
+    /* A file name pattern restricts the match in the same way.  */
+    .out8 : { *script_test_16b.o(.fs) }
+    .out9 : { *(.fs) }
+
+    /* Sorting changes the order within the output section, not which
+       sections are matched.  */
+    .out10 : { *(SORT_BY_NAME(.s.*)) }
+    .out11 : { *(SORT_BY_ALIGNMENT(.t.*)) *(SORT(.t2.*)) }
+
+    /* A leading wildcard comes before a later prefix.  */
+    .out12 : { *(*bar) }
+    .out13 : { *(.qq.*) }
+
+    /* A prefix comes before a later exact name.  */
+    .out14 : { *(.h*) }
+    .out15 : { *(.hh) }
+}
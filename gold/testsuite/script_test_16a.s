@@ -0,0 +1,35 @@
+    .section .foo.exact,"a"
+    .byte 0x11
+
+    .section .foo.bar1,"a"
+    .byte 0x12
+
+    .section .gax.1,"a"
+    .byte 0x13
+
+    .section .gbx.1,"a"
+    .byte 0x14
+
+    .section .ex,"a"
+    .byte 0x15
+
+    .section .fs,"a"
+    .byte 0x16
+
+    .section .s.c,"a"
+    .byte 0x17
+
+    .section .s.b,"a"
+    .byte 0x18
+
+    .section .t.small,"a"
+    .byte 0x19
+
+    .section .t2.a,"a"
+    .byte 0x1b
+
+    .section .qq.bar,"a"
+    .byte 0x1c
+
+    .section .hh,"a"
+    .byte 0x1a
@@ -0,0 +1,15 @@
+    .section .ex,"a"
+    .byte 0x25
+
+    .section .fs,"a"
+    .byte 0x26
+
+    .section .s.a,"a"
+    .byte 0x27
+
+    .section .t.big,"a"
+    .p2align 2
+    .byte 0x41, 0x42, 0x43, 0x44
+
+    .section .t2.b,"a"
+    .byte 0x28
@@ -0,0 +1,48 @@
+// section_ordering_glob.cc -- a test case for gold
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// The goal of this program is to verify that glob patterns in a
+// --section-ordering-file are matched in file order, whether or not
+// they start with literal characters, and that an exact section name
+// takes precedence over an earlier glob.  The functions are defined
+// in an order which differs from the expected layout.
+
+extern "C"
+{
+
+int axe() { return 1; }
+int alpha_first() { return 2; }
+int alpha_second() { return 3; }
+int alpha_third() { return 4; }
+int gamma_1() { return 5; }
+int delta_second() { return 6; }
+int beta_second() { return 7; }
+int beta_one() { return 8; }
+
+}
+
+int
+main()
+{
+  int sum = (axe() + alpha_first() + alpha_second() + alpha_third()
+	     + gamma_1() + delta_second() + beta_second() + beta_one());
+  return sum == 36 ? 0 : 1;
+}
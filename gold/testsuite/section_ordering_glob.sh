@@ -0,0 +1,77 @@
+#!/bin/sh
+
+# section_ordering_glob.sh -- test glob patterns in --section-ordering-file
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The ordering file used to link section_ordering_glob is
+#
+#   .text.beta_*
+#   *_second
+#   .text.alpha_f*
+#   .text.gamma_[0-9]
+#   .text.alpha_*
+#   .text.alpha_first
+#   .text.a*
+#
+# Each section goes with the first pattern which matches it, whether
+# that pattern starts with a wildcard or with a literal prefix, except
+# that the exact name .text.alpha_first beats the earlier glob
+# .text.alpha_f*.
+
+set -e
+
+check()
+{
+    awk "
+BEGIN { saw1 = 0; saw2 = 0; err = 0; }
+/.* $2\$/ { saw1 = 1; }
+/.* $3\$/ {
+     saw2 = 1;
+     if (!saw1)
+       {
+	  printf \"layout of $2 and $3 is not right\\n\";
+	  err = 1;
+	  exit 1;
+       }
+    }
+END {
+      if (!saw1 && !err)
+        {
+	  printf \"did not see $2\\n\";
+	  exit 1;
+	}
+      if (!saw2 && !err)
+	{
+	  printf \"did not see $3\\n\";
+	  exit 1;
+	}
+    }" $1
+}
+
+check section_ordering_glob.stdout "beta_one" "delta_second"
+check section_ordering_glob.stdout "beta_second" "delta_second"
+check section_ordering_glob.stdout "beta_one" "alpha_second"
+check section_ordering_glob.stdout "beta_second" "alpha_second"
+check section_ordering_glob.stdout "delta_second" "gamma_1"
+check section_ordering_glob.stdout "alpha_second" "gamma_1"
+check section_ordering_glob.stdout "gamma_1" "alpha_third"
+check section_ordering_glob.stdout "alpha_third" "alpha_first"
+check section_ordering_glob.stdout "alpha_first" "axe"
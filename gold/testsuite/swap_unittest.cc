@@ -0,0 +1,106 @@
+// swap_unittest.cc -- test the elfcpp::Swap_array conversions
+
+// Copyright (C) 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include "elfcpp_swap.h"
+
+#include "test.h"
+
+namespace gold_testsuite
+{
+
+using namespace gold;
+
+// The largest number of values to convert, and the largest offset
+// of the buffer from an aligned address.
+
+static const size_t max_count = 40;
+static const size_t max_offset = 3;
+
+// Check Swap_array against Swap_unaligned for COUNT values stored at
+// OFFSET bytes into a buffer, so that the vector path, the tail loop
+// and unaligned buffers are all covered.
+
+template<int size, bool big_endian>
+bool
+Sized_swap_array_test(size_t count, size_t offset)
+{
+  typedef typename elfcpp::Valtype_base<size>::Valtype Valtype;
+  typedef elfcpp::Swap_array<size, big_endian> Target_array;
+  typedef elfcpp::Swap_array<size, !big_endian> Other_array;
+  typedef elfcpp::Swap_unaligned<size, big_endian> Target_unaligned;
+  typedef elfcpp::Swap_unaligned<size, !big_endian> Other_unaligned;
+  const size_t bytes = size / 8;
+
+  Valtype vals[max_count];
+  for (size_t i = 0; i < count; ++i)
+    vals[i] = static_cast<Valtype>(0x0123456789abcdefULL * (i + 1));
+  unsigned char buf[max_count * 8 + max_offset];
+  unsigned char* p = buf + offset;
+
+  Target_array::writevals(p, vals, count);
+  for (size_t i = 0; i < count; ++i)
+    CHECK(Target_unaligned::readval(p + i * bytes) == vals[i]);
+
+  Valtype back[max_count];
+  Target_array::readvals(p, back, count);
+  for (size_t i = 0; i < count; ++i)
+    CHECK(back[i] == vals[i]);
+
+  // Converting the buffer back to host order, and then to the other
+  // byte order, must give the values in that order.
+  Target_array::convert(p, count);
+  Other_array::convert(p, count);
+  for (size_t i = 0; i < count; ++i)
+    CHECK(Other_unaligned::readval(p + i * bytes) == vals[i]);
+
+  return true;
+}
+
+template<int size>
+bool
+Sized_swap_test()
+{
+  for (size_t count = 0; count <= max_count; ++count)
+    for (size_t offset = 0; offset <= max_offset; ++offset)
+      {
+	if (!Sized_swap_array_test<size, false>(count, offset))
+	  return false;
+	if (!Sized_swap_array_test<size, true>(count, offset))
+	  return false;
+      }
+  return true;
+}
+
+bool
+Swap_test(Test_report*)
+{
+  CHECK(Sized_swap_test<8>());
+  CHECK(Sized_swap_test<16>());
+  CHECK(Sized_swap_test<32>());
+  CHECK(Sized_swap_test<64>());
+  return true;
+}
+
+Register_test swap_register("Swap", Swap_test);
+
+} // End namespace gold_testsuite.
@@ -0,0 +1,51 @@
+// ver_test_15.cc -- a test case for gold
+
+// Copyright (C) 2018 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// The versions these symbols get from ver_test_15.script are checked
+// by ver_test_15.sh.
+
+extern "C"
+{
+  int foo_a() { return 1; }
+  int foo_b() { return 2; }
+  int foobar() { return 3; }
+  int xbar() { return 4; }
+  int bar_x() { return 5; }
+  int baz1() { return 6; }
+  int other() { return 7; }
+}
+
+namespace ns
+{
+  int f() { return 8; }
+  int g() { return 9; }
+  int h() { return 10; }
+}
+
+class C
+{
+ public:
+  int m();
+  int n();
+};
+
+int C::m() { return 11; }
+int C::n() { return 12; }
@@ -0,0 +1,74 @@
+#!/bin/sh
+
+# ver_test_15.sh -- test the precedence of version script wildcards
+
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with ver_test_15.script.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected symbol in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_missing()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected symbol in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+# foo_? in V2 comes after foo* in V1.
+check ver_test_15.syms "V2  *foo_a$"
+check ver_test_15.syms "V2  *foo_b$"
+# foo* and *bar both match, in V1 only.
+check ver_test_15.syms "V1  *foobar$"
+# [x]bar in V2 comes after *bar in V1.
+check ver_test_15.syms "V2  *xbar$"
+# The local bar_* in V3 comes after the global bar* in V1.  GNU ld
+# prefers any global wildcard here; gold always uses the last version.
+check_missing ver_test_15.syms "bar_x$"
+check ver_test_15.syms "V3  *baz1$"
+# Only the local * in V1 matches.
+check_missing ver_test_15.syms "other$"
+
+# extern "C++" patterns match the demangled names.
+check ver_test_15.syms "V1  *ns::f()$"
+check ver_test_15.syms "V2  *ns::g()$"
+# *::h* in V3 comes after ns::* in V1.
+check ver_test_15.syms "V3  *ns::h()$"
+check ver_test_15.syms "V1  *C::m()$"
+check ver_test_15.syms "V1  *C::n()$"
+
+exit 0
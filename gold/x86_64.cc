@@ -944,6 +944,8 @@ class Target_x86_64 : public Sized_target<size, false>
   size_t
   add_tlsdesc_info(Sized_relobj_file<size, false>* object, unsigned int r_sym)
   {
+    // The local symbol value is used when the reloc is written.
+    object->set_has_late_references();
     this->tlsdesc_reloc_info_.push_back(Tlsdesc_info(object, r_sym));
     return this->tlsdesc_reloc_info_.size() - 1;
   }
@@ -1546,6 +1548,9 @@ Target_x86_64<size>::rela_dyn_section(Layout* layout)
       layout->add_output_section_data(".rela.dyn", elfcpp::SHT_RELA,
 				      elfcpp::SHF_ALLOC, this->rela_dyn_,
 				      ORDER_DYNAMIC_RELOCS, false);
+      if (strcmp(parameters->options().pack_dyn_relocs(), "relr") == 0)
+	this->rela_dyn_->set_relr(new Output_data_relr<size, false>(layout),
+				  elfcpp::R_X86_64_RELATIVE);
     }
   return this->rela_dyn_;
 }
@@ -4518,6 +4523,11 @@ Target_x86_64<size>::do_finalize_sections(
   if (this->copy_relocs_.any_saved_relocs())
     this->copy_relocs_.emit(this->rela_dyn_section(layout));
 
+  // All dynamic relocs are known now, so we can tell whether any
+  // were packed.
+  if (this->rela_dyn_ != NULL)
+    layout->add_relr_dynamic_tags(this->rela_dyn_->relr());
+
   // Set the size of the _GLOBAL_OFFSET_TABLE_ symbol to the size of
   // the .got.plt section.
   Symbol* sym = this->global_offset_table_;